@@ -0,0 +1,118 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include "sdk/sensor.h"
+#include "sdk/static_sensor.h"
+
+/**
+ * @brief Dynamic Sensor vs compile-time StaticSensor
+ *
+ * Feeds the same inputs through a runtime-configured Sensor (low-pass filter,
+ * linear calibration) and through the equivalent StaticSensor, checks that
+ * both store the same codes and values, and reports the cost per sample of:
+ * - Sensor::processSample (lock, runtime dispatch, commit)
+ * - StaticSensor::step (inlined pipeline, commit per sample)
+ * - StaticSensor::process (inlined pipeline, one commit per batch)
+ * - StaticSensor::convert (pipeline only, nothing stored)
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using TemperatureProbe = StaticSensor<Sensor::SensorType::TEMPERATURE,
+                                      pipeline::Chain<pipeline::LowPass<>>,
+                                      pipeline::LinearCalibration<std::ratio<1, 2>, std::ratio<101, 100>>>;
+
+constexpr size_t SAMPLE_COUNT = size_t(1) << 20;
+constexpr std::chrono::nanoseconds SAMPLE_INTERVAL{1000};  // 1 MHz input
+
+template <typename Body>
+double nanosecondsPerSample(Body body) {
+    auto start = Clock::now();
+    body();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return static_cast<double>(elapsed.count()) / static_cast<double>(SAMPLE_COUNT);
+}
+
+void report(const char* label, double ns, double baseline) {
+    std::cout << "  " << std::left << std::setw(32) << label << std::right
+              << std::fixed << std::setprecision(1) << std::setw(8) << ns << " ns/sample"
+              << std::setprecision(2) << std::setw(8) << baseline / ns << "x" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 gen(42);
+    std::normal_distribution<float> dis(22.0f, 5.0f);
+    std::vector<float> inputs(SAMPLE_COUNT);
+    for (float& value : inputs) {
+        value = dis(gen);
+    }
+    Clock::time_point start_time = Clock::now();
+
+    Sensor dynamic_sensor("bench_dynamic", Sensor::SensorType::TEMPERATURE);
+    TemperatureProbe static_sensor("bench_static");
+    if (!dynamic_sensor.initialize() || !static_sensor.initialize()) {
+        std::cerr << "Error: Failed to initialize sensors" << std::endl;
+        return 1;
+    }
+    dynamic_sensor.setFilter(Sensor::FilterType::LOW_PASS);
+    dynamic_sensor.setCalibration(0.5f, 1.01f);
+
+    double dynamic_ns = nanosecondsPerSample([&] {
+        for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+            dynamic_sensor.processSample(inputs[i], start_time + SAMPLE_INTERVAL * i);
+        }
+    });
+
+    double step_ns = nanosecondsPerSample([&] {
+        for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+            static_sensor.step(inputs[i], start_time + SAMPLE_INTERVAL * i);
+        }
+    });
+
+    // Compare the stored samples of the per-sample runs
+    std::vector<Sensor::SensorData> expected = dynamic_sensor.readBuffer();
+    std::vector<Sensor::SensorData> actual = static_sensor.sensor().readBuffer();
+    size_t code_mismatches = 0;
+    float max_error = 0.0f;
+    for (size_t i = 0; i < std::min(expected.size(), actual.size()); ++i) {
+        code_mismatches += (expected[i].adc_code != actual[i].adc_code);
+        max_error = std::max(max_error, std::fabs(expected[i].calibrated_value - actual[i].calibrated_value));
+    }
+
+    static_sensor.initialize();
+    double process_ns = nanosecondsPerSample([&] {
+        static_sensor.process(inputs.data(), SAMPLE_COUNT, start_time, SAMPLE_INTERVAL);
+    });
+
+    static_sensor.resetFilters();
+    float checksum = 0.0f;
+    double convert_ns = nanosecondsPerSample([&] {
+        for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+            checksum += static_sensor.convert(inputs[i], start_time).calibrated_value;
+        }
+    });
+
+    std::cout << "\n=== Static vs dynamic sensor pipeline (" << SAMPLE_COUNT << " samples) ===" << std::endl;
+    std::cout << "  Stored samples compared: " << std::min(expected.size(), actual.size())
+              << ", ADC code mismatches: " << code_mismatches
+              << ", max calibrated difference: " << std::scientific << std::setprecision(2) << max_error << std::endl;
+    report("Sensor::processSample", dynamic_ns, dynamic_ns);
+    report("StaticSensor::step", step_ns, dynamic_ns);
+    report("StaticSensor::process (batched)", process_ns, dynamic_ns);
+    report("StaticSensor::convert (no store)", convert_ns, dynamic_ns);
+    std::cout << "  (checksum " << std::fixed << std::setprecision(1) << checksum / SAMPLE_COUNT << ")" << std::endl;
+
+    dynamic_sensor.cleanup();
+    static_sensor.cleanup();
+
+    // One LSB at 12 bits over -40..85 is ~0.03; allow float rounding only
+    return (code_mismatches == 0 && max_error < 1e-3f) ? 0 : 1;
+}
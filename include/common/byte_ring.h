@@ -0,0 +1,247 @@
+#ifndef BYTE_RING_H
+#define BYTE_RING_H
+
+#include "common/span.h"
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @brief Lock-free single-producer/single-consumer FIFO of trivially copyable elements
+ *
+ * - Storage is a power-of-two ring; the usable capacity is exactly the
+ *   requested size (the rest of the allocation is never filled), so a FIFO
+ *   of N bytes reports full after N bytes like the hardware it models
+ * - Reads and writes move whole spans with at most two memcpy calls;
+ *   writable()/readable() expose the segments for in-place access
+ * - Positions are free-running 64-bit counters (no wrap ambiguity); each
+ *   side caches the other side's counter and only re-reads it when the
+ *   cached value says the ring is full/empty
+ * - clear() may run on another thread than the consumer's: it advances the
+ *   read position with a CAS, and a concurrent pop()/skip() that loses the
+ *   race discards its copy instead of returning flushed elements. In-place
+ *   views are not protected: once clear() frees their slots the producer
+ *   may overwrite them while the consumer is still reading, and consume()
+ *   returning false is the only sign. Consumers of readable() views must
+ *   treat their data as torn when consume() fails, or call clear() only
+ *   from the consumer thread
+ *
+ * One thread may produce and one may consume at a time. reset() and
+ * resize() reallocate and must not run concurrently with anything else.
+ * SpscByteRing is the byte instantiation used for peripheral FIFOs.
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing elements are moved with memcpy");
+
+public:
+    static constexpr size_t MAX_CAPACITY = size_t(1) << 30;
+
+private:
+    std::unique_ptr<T[]> storage;
+    size_t limit;          // Usable capacity (requested size)
+    size_t mask;           // Allocation size - 1
+
+    alignas(64) std::atomic<uint64_t> head;   // Next write position (producer)
+    uint64_t cached_tail;                     // Producer's view of tail
+    alignas(64) std::atomic<uint64_t> tail;   // Next read position (consumer)
+    uint64_t cached_head;                     // Consumer's view of head
+    uint64_t peeked_tail;                     // Read position seen by readable()
+
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    void copyIn(uint64_t position, const T* data, size_t count) {
+        size_t offset = static_cast<size_t>(position) & mask;
+        size_t first = std::min(count, mask + 1 - offset);
+        std::memcpy(storage.get() + offset, data, first * sizeof(T));
+        std::memcpy(storage.get(), data + first, (count - first) * sizeof(T));
+    }
+
+    void copyOut(uint64_t position, T* out, size_t count) const {
+        size_t offset = static_cast<size_t>(position) & mask;
+        size_t first = std::min(count, mask + 1 - offset);
+        std::memcpy(out, storage.get() + offset, first * sizeof(T));
+        std::memcpy(out + first, storage.get(), (count - first) * sizeof(T));
+    }
+
+    template <typename U>
+    RingSpan<U> segments(uint64_t position, size_t count) const {
+        size_t offset = static_cast<size_t>(position) & mask;
+        size_t first = std::min(count, mask + 1 - offset);
+        return RingSpan<U>{Span<U>(storage.get() + offset, first), Span<U>(storage.get(), count - first)};
+    }
+
+    // Producer: free space, refreshing the cached tail only when it looks full
+    size_t freeSpace(uint64_t write_position, size_t wanted) {
+        size_t space = limit - static_cast<size_t>(write_position - cached_tail);
+        if (space < wanted) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            space = limit - static_cast<size_t>(write_position - cached_tail);
+        }
+        return space;
+    }
+
+    // Consumer: readable elements, refreshing the cached head only when it looks short
+    size_t available(uint64_t read_position, size_t wanted) {
+        // clear() can move the read position past a stale cached head
+        size_t count = cached_head > read_position ? static_cast<size_t>(cached_head - read_position) : 0;
+        if (count < wanted) {
+            cached_head = head.load(std::memory_order_acquire);
+            count = static_cast<size_t>(cached_head - read_position);
+        }
+        return count;
+    }
+
+public:
+    explicit SpscRing(size_t capacity = 0)
+        : limit(0),
+          mask(0),
+          head(0),
+          cached_tail(0),
+          tail(0),
+          cached_head(0),
+          peeked_tail(0) {
+        reset(capacity);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Reallocate empty (not concurrent with any other call)
+    void reset(size_t capacity) {
+        capacity = std::min(capacity, MAX_CAPACITY);
+        size_t allocation = roundUpPowerOfTwo(std::max<size_t>(capacity, 1));
+        storage.reset(new T[allocation]);
+        limit = capacity;
+        mask = allocation - 1;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        cached_tail = 0;
+        cached_head = 0;
+        peeked_tail = 0;
+    }
+
+    // Reallocate keeping the newest elements that fit (not concurrent with any other call)
+    void resize(size_t capacity) {
+        uint64_t read_position = tail.load(std::memory_order_relaxed);
+        size_t count = static_cast<size_t>(head.load(std::memory_order_relaxed) - read_position);
+        size_t kept = std::min(count, std::min(capacity, MAX_CAPACITY));
+        std::unique_ptr<T[]> saved(new T[std::max<size_t>(kept, 1)]);
+        copyOut(read_position + (count - kept), saved.get(), kept);
+        reset(capacity);
+        copyIn(0, saved.get(), kept);
+        head.store(kept, std::memory_order_relaxed);
+        cached_head = kept;
+    }
+
+    size_t capacity() const { return limit; }
+
+    // Approximate when called concurrently with the other side
+    size_t size() const {
+        uint64_t read_position = tail.load(std::memory_order_acquire);
+        uint64_t write_position = head.load(std::memory_order_acquire);
+        return write_position > read_position ? static_cast<size_t>(write_position - read_position) : 0;
+    }
+    size_t space() const { return limit - std::min(size(), limit); }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= limit; }
+
+    // Producer: copy as much as fits; returns the number of elements stored
+    size_t push(const T* data, size_t count) {
+        uint64_t write_position = head.load(std::memory_order_relaxed);
+        count = std::min(count, freeSpace(write_position, count));
+        if (count == 0) {
+            return 0;
+        }
+        copyIn(write_position, data, count);
+        head.store(write_position + count, std::memory_order_release);
+        return count;
+    }
+
+    bool push(const T& value) { return push(&value, 1) == 1; }
+
+    // Producer: free space as (at most two) segments; fill a prefix, then commit()
+    RingSpan<T> writable() {
+        uint64_t write_position = head.load(std::memory_order_relaxed);
+        return segments<T>(write_position, freeSpace(write_position, limit));
+    }
+
+    // Producer: position of the first writable() element
+    uint64_t writablePosition() const { return head.load(std::memory_order_relaxed); }
+
+    void commit(size_t count) {
+        head.store(head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer: copy out up to count elements; returns the number read
+    size_t pop(T* out, size_t count) {
+        uint64_t read_position = tail.load(std::memory_order_acquire);
+        for (;;) {
+            size_t n = std::min(count, available(read_position, count));
+            if (n == 0) {
+                return 0;
+            }
+            copyOut(read_position, out, n);
+            // Fails only if clear() moved tail meanwhile: the copy may be stale, retry
+            if (tail.compare_exchange_strong(read_position, read_position + n,
+                                             std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return n;
+            }
+        }
+    }
+
+    bool pop(T& value) { return pop(&value, 1) == 1; }
+
+    // Consumer: drop up to count elements without copying them; returns the number dropped
+    size_t skip(size_t count) {
+        uint64_t read_position = tail.load(std::memory_order_acquire);
+        for (;;) {
+            size_t n = std::min(count, available(read_position, count));
+            if (n == 0 || tail.compare_exchange_strong(read_position, read_position + n,
+                                                       std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return n;
+            }
+        }
+    }
+
+    // Consumer: buffered elements as (at most two) segments, oldest first
+    RingSpan<const T> readable() {
+        peeked_tail = tail.load(std::memory_order_acquire);
+        return segments<const T>(peeked_tail, available(peeked_tail, limit));
+    }
+
+    // Consumer: read position of the last readable() view. Only consume() and
+    // clear() move it, so a change the consumer did not make means a flush
+    uint64_t readablePosition() const { return peeked_tail; }
+
+    // Consumer: release elements seen through the last readable(); false if clear() flushed them first
+    bool consume(size_t count) {
+        uint64_t read_position = peeked_tail;
+        return tail.compare_exchange_strong(read_position, read_position + count,
+                                            std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
+    // Discard everything buffered; returns the number of elements dropped. Safe
+    // against pop()/skip() on the consumer thread, not against an open readable() view
+    size_t clear() {
+        uint64_t read_position = tail.load(std::memory_order_acquire);
+        uint64_t write_position;
+        do {
+            write_position = head.load(std::memory_order_acquire);
+        } while (!tail.compare_exchange_weak(read_position, write_position,
+                                             std::memory_order_acq_rel, std::memory_order_acquire));
+        return static_cast<size_t>(write_position - read_position);
+    }
+};
+
+using SpscByteRing = SpscRing<uint8_t>;
+
+#endif // BYTE_RING_H
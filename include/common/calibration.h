@@ -0,0 +1,75 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Immutable sensor calibration curve
+ *
+ * Maps a raw input value to a calibrated value:
+ * - LINEAR: (x + offset) * scale
+ * - POLYNOMIAL: c0 + c1 x + ... + cN x^N (Horner; blocks evaluated with SIMD)
+ * - PIECEWISE_LINEAR: interpolation between (x, y) breakpoints; uniformly
+ *   spaced breakpoints are direct-indexed, others use a binary search.
+ *   Inputs outside the table extrapolate along the end segments.
+ * - TABLE: y values sampled uniformly over [input_min, input_max]
+ *   (always direct-indexed)
+ *
+ * Curves are built once by the factories and never modified, so a curve
+ * can be shared between threads and swapped atomically as a whole.
+ * Factories report invalid parameters on std::cerr and return nullptr.
+ */
+class Calibration {
+public:
+    enum class Kind {
+        LINEAR,
+        POLYNOMIAL,
+        PIECEWISE_LINEAR,
+        TABLE
+    };
+
+    static constexpr size_t MAX_POLYNOMIAL_ORDER = 15;
+    static constexpr size_t MAX_POINTS = 65536;
+
+private:
+    Kind kind;
+    float offset;
+    float scale;
+    std::vector<float> coefficients;   // c0..cN
+    std::vector<float> xs;             // Breakpoints (ascending)
+    std::vector<float> ys;
+    std::vector<float> slopes;         // Per segment
+    bool uniform;                      // Breakpoints equally spaced
+    float inv_step;
+
+    explicit Calibration(Kind kind);
+
+    void buildSegments();
+    size_t findSegment(float x) const;
+    float applyPolynomial(float x) const;
+    float applyPiecewise(float x) const;
+
+public:
+    static std::shared_ptr<const Calibration> linear(float offset, float scale);
+    static std::shared_ptr<const Calibration> polynomial(const std::vector<float>& coefficients);
+    static std::shared_ptr<const Calibration> piecewiseLinear(std::vector<std::pair<float, float>> points);
+    static std::shared_ptr<const Calibration> table(const std::vector<float>& values, float input_min, float input_max);
+
+    float apply(float x) const;
+    void applyBlock(const float* in, float* out, size_t count) const;
+
+    Kind getKind() const { return kind; }
+    float getOffset() const { return offset; }   // LINEAR only (0 otherwise)
+    float getScale() const { return scale; }     // LINEAR only (1 otherwise)
+    const std::vector<float>& getCoefficients() const { return coefficients; }
+    size_t getPointCount() const { return xs.size(); }
+    bool isDirectIndexed() const { return uniform; }
+
+    static std::string kindToString(Kind kind);
+};
+
+#endif // CALIBRATION_H
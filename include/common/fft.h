@@ -0,0 +1,38 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief In-place complex FFT for power-of-two sizes (split real/imag arrays)
+ *
+ * - Twiddle factors and the bit-reversal permutation are computed once
+ * - The first two radix-2 stages are fused into one radix-4 pass (its
+ *   twiddles are +-1 and +-j, so it needs no multiplies)
+ * - The remaining radix-2 stages run four butterflies per SSE instruction;
+ *   twiddles are stored per stage so those loads are contiguous
+ */
+class FFT {
+private:
+    size_t n;
+    size_t log2n;
+    std::vector<size_t> bit_reverse_pairs; // (i, j) swaps, i < j
+    std::vector<float> twiddle_re;         // Concatenated per stage (half-span 4, 8, ..., n/2)
+    std::vector<float> twiddle_im;
+
+    void permute(float* re, float* im) const;
+    void radix4FirstPass(float* re, float* im) const;
+    void radix2Pass(float* re, float* im, size_t half, const float* w_re, const float* w_im) const;
+
+public:
+    explicit FFT(size_t size);
+
+    // Forward transform in place (no scaling). size() must be a power of two >= 4.
+    void forward(float* re, float* im) const;
+
+    size_t size() const { return n; }
+    static bool isPowerOfTwo(size_t value) { return value >= 4 && (value & (value - 1)) == 0; }
+};
+
+#endif // FFT_H
@@ -0,0 +1,141 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include "common/simd.h"
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+/**
+ * @brief Integer arithmetic for the ADC data path
+ *
+ * Mirrors what MCU firmware does with ADC results:
+ * - Codes are uint16_t; filters run on codes carrying FRACTION_BITS of
+ *   extra precision (Q4 codes), with Q15 coefficients
+ * - Linear conversions y = x * gain + bias use a Q-format gain with a
+ *   power-of-two scale and a 64-bit accumulator (32x32->64 multiply)
+ * - applyBlock() converts eight codes per iteration with SSE2 integer
+ *   multiplies (SSE4.1 when available); other targets use the scalar path
+ */
+namespace fixedpoint {
+
+constexpr int FRACTION_BITS = 4;        // Extra precision carried by filtered codes
+constexpr int GAIN_BITS = 30;           // |gain| < 2^30 keeps the split block multiply exact
+constexpr int BIAS_BITS = 56;           // Headroom for x * gain + bias in int64
+
+// y = (x * gain + bias) * 2^-shift
+struct Linear {
+    int32_t gain;
+    int64_t bias;
+    int shift;
+    float scale;     // 2^-shift
+    bool exact;      // false: gain/bias not representable, evaluated in float
+    float gain_f;
+    float bias_f;
+};
+
+inline Linear makeLinear(double gain, double bias) {
+    Linear linear{};
+    linear.gain_f = static_cast<float>(gain);
+    linear.bias_f = static_cast<float>(bias);
+    linear.scale = 1.0f;
+
+    // Largest shift that keeps gain and bias inside their headroom
+    for (int shift = 60; shift >= 0; --shift) {
+        double gain_fixed = std::ldexp(gain, shift);
+        double bias_fixed = std::ldexp(bias, shift);
+        if (std::fabs(gain_fixed) < std::ldexp(1.0, GAIN_BITS) &&
+            std::fabs(bias_fixed) < std::ldexp(1.0, BIAS_BITS)) {
+            linear.gain = static_cast<int32_t>(std::llround(gain_fixed));
+            linear.bias = static_cast<int64_t>(std::llround(bias_fixed));
+            linear.shift = shift;
+            linear.scale = static_cast<float>(std::ldexp(1.0, -shift));
+            // A gain with fewer than 15 significant bits is no better than float
+            linear.exact = std::abs(linear.gain) >= (1 << 15);
+            return linear;
+        }
+    }
+    return linear;
+}
+
+// x carries frac_bits fractional bits
+inline float apply(const Linear& linear, int32_t x, int frac_bits = 0) {
+    if (!linear.exact) {
+        return std::ldexp(static_cast<float>(x), -frac_bits) * linear.gain_f + linear.bias_f;
+    }
+    int64_t acc = static_cast<int64_t>(x) * linear.gain + linear.bias * (int64_t(1) << frac_bits);
+    return static_cast<float>(acc) * (linear.scale / static_cast<float>(1 << frac_bits));
+}
+
+// Exponential moving average: state += alpha * (x - state)
+inline int32_t lowPassQ15(int32_t state, int32_t x, int32_t alpha_q15) {
+    return state + static_cast<int32_t>((static_cast<int64_t>(alpha_q15) * (x - state)) / 32768);
+}
+
+// First-order high-pass: y = alpha * (y_prev + x - x_prev)
+inline int32_t highPassQ15(int32_t previous_output, int32_t x, int32_t previous_input, int32_t alpha_q15) {
+    int64_t acc = static_cast<int64_t>(previous_output) + x - previous_input;
+    return static_cast<int32_t>((acc * alpha_q15) / 32768);
+}
+
+// Physical value -> ADC code: round((value - minimum) / lsb), clamped to [0, max_code]
+inline uint16_t quantize(float value, float minimum, float inv_lsb, uint16_t max_code) {
+    float code = std::clamp((value - minimum) * inv_lsb, 0.0f, static_cast<float>(max_code));
+    return static_cast<uint16_t>(std::lround(code));
+}
+
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+inline __m128i mullo32(__m128i a, __m128i b) {
+#if defined(__SSE4_1__)
+    return _mm_mullo_epi32(a, b);
+#else
+    // The low 32 bits of a product do not depend on signedness
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+#endif
+
+// out[i] = linear(codes[i])
+inline void applyBlock(const Linear& linear, const uint16_t* codes, size_t n, float* out) {
+    size_t i = 0;
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+    if (linear.exact) {
+        // gain = gain_hi * 2^15 + gain_lo: both 16x15-bit products fit in int32
+        int32_t gain_lo = linear.gain & 0x7FFF;
+        int32_t gain_hi = (linear.gain - gain_lo) / 32768;
+        const __m128i hi_gain = _mm_set1_epi32(gain_hi);
+        const __m128i lo_gain = _mm_set1_epi32(gain_lo);
+        const __m128 hi_scale = _mm_set1_ps(linear.scale * 32768.0f);
+        const __m128 lo_scale = _mm_set1_ps(linear.scale);
+        const __m128 offset = _mm_set1_ps(static_cast<float>(std::ldexp(static_cast<double>(linear.bias), -linear.shift)));
+        const __m128i zero = _mm_setzero_si128();
+
+        auto convert = [&](__m128i x) {
+            __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(mullo32(x, hi_gain)), hi_scale);
+            __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(mullo32(x, lo_gain)), lo_scale);
+            return _mm_add_ps(_mm_add_ps(hi, lo), offset);
+        };
+
+        for (; i + 8 <= n; i += 8) {
+            __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i));
+            _mm_storeu_ps(out + i, convert(_mm_unpacklo_epi16(raw, zero)));
+            _mm_storeu_ps(out + i + 4, convert(_mm_unpackhi_epi16(raw, zero)));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = apply(linear, codes[i]);
+    }
+}
+
+} // namespace fixedpoint
+
+#endif // FIXED_POINT_H
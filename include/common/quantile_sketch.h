@@ -0,0 +1,106 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Mergeable streaming quantile sketch (KLL)
+ *
+ * Keeps a hierarchy of compactors: level h holds items of weight 2^h and
+ * its capacity shrinks geometrically (factor 2/3) towards the lower
+ * levels. A full level is sorted and every other item (random offset) is
+ * promoted to the next level.
+ *
+ * - Memory: O(k) floats, independent of the stream length
+ * - Error: normalized rank error <= normalizedRankError(k) with 99%
+ *   confidence (about 1.3% for the default k = 200, 0.7% for k = 400)
+ * - Sketches with the same k merge into a sketch of the combined stream
+ *   with the same error bound (fleet-wide percentiles)
+ * - Queries build a sorted weighted view once and reuse it until the next
+ *   update, so repeated percentile lookups are a binary search
+ */
+class QuantileSketch {
+public:
+    static constexpr uint16_t DEFAULT_K = 200;
+
+private:
+    uint16_t k;
+    uint64_t count;
+    float min_value;
+    float max_value;
+    std::vector<std::vector<float>> levels;
+    std::vector<size_t> capacities;  // Per level, recomputed when a level is added
+    size_t retained;
+    size_t total_capacity;
+    uint64_t rng_state;
+
+    // Sorted (value, cumulative weight) view, rebuilt lazily after updates
+    mutable std::vector<std::pair<float, uint64_t>> sorted_view;
+    mutable bool view_valid;
+
+    void updateCapacities();
+    void compress();
+    void compactLevel(size_t level);
+    bool nextCoin();
+    void buildView() const;
+
+public:
+    explicit QuantileSketch(uint16_t k = DEFAULT_K);
+
+    void update(float value);
+    void update(const float* values, size_t n);
+    // Requires the same k; returns false otherwise
+    bool merge(const QuantileSketch& other);
+    void reset();
+
+    // q in [0, 1]; returns NaN for an empty sketch
+    float quantile(double q) const;
+    std::vector<float> quantiles(const std::vector<double>& qs) const;
+    // Fraction of the stream <= value
+    double rank(float value) const;
+
+    uint64_t getCount() const { return count; }
+    bool empty() const { return count == 0; }
+    float getMin() const { return min_value; }
+    float getMax() const { return max_value; }
+    uint16_t getK() const { return k; }
+    size_t getRetainedItems() const { return retained; }
+
+    // 99%-confidence bound on the normalized rank error of a single quantile
+    static double normalizedRankError(uint16_t k);
+};
+
+/**
+ * @brief Time-bucketed quantile sketches for rolling-window percentiles
+ *
+ * A ring of bucket_count sketches, each covering bucket_duration. Old
+ * buckets are recycled as time advances; window queries merge the buckets
+ * that overlap the window.
+ */
+class QuantileRollup {
+private:
+    std::chrono::steady_clock::duration bucket_duration;
+    std::vector<QuantileSketch> buckets;
+    std::vector<int64_t> bucket_epochs;   // Absolute bucket number held in each slot (-1 = empty)
+    uint16_t k;
+
+    int64_t epochOf(std::chrono::steady_clock::time_point tp) const;
+
+public:
+    QuantileRollup(std::chrono::steady_clock::duration bucket_duration = std::chrono::seconds(10),
+                   size_t bucket_count = 60, uint16_t k = QuantileSketch::DEFAULT_K);
+
+    void update(float value, std::chrono::steady_clock::time_point timestamp);
+    // Merge of all buckets overlapping [now - window, now]
+    QuantileSketch window(std::chrono::steady_clock::duration window,
+                          std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const;
+    void reset();
+
+    std::chrono::steady_clock::duration getBucketDuration() const { return bucket_duration; }
+    size_t getBucketCount() const { return buckets.size(); }
+};
+
+#endif // QUANTILE_SKETCH_H
@@ -0,0 +1,285 @@
+#ifndef SAMPLE_STREAM_H
+#define SAMPLE_STREAM_H
+
+#include "common/span.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+
+/**
+ * @brief Single-producer broadcast ring with batched subscriber delivery
+ *
+ * - The producer writes into a power-of-two ring and never blocks or locks
+ *   (it only takes the lock when a subscriber batch becomes due)
+ * - Each subscriber keeps its own cursor, preferred batch size and
+ *   maximum delivery latency
+ * - Batches are delivered from one delivery thread as RingSpans pointing
+ *   straight into ring memory (no copies)
+ * - Slow subscribers are lapped: skipped samples are counted, the producer
+ *   is never held back. Batches overwritten while the callback was still
+ *   reading them are reported as torn (seqlock-style validation).
+ */
+template <typename T>
+class SampleStream {
+public:
+    using SubscriberId = uint32_t;
+    static constexpr SubscriberId INVALID_SUBSCRIBER = 0;
+
+    // Called with a view into ring memory and the sequence of its first sample
+    using Callback = std::function<void(const RingSpan<const T>& batch, uint64_t first_sequence)>;
+
+    struct SubscriberStats {
+        uint64_t delivered;   // Samples handed to the callback
+        uint64_t batches;     // Callback invocations
+        uint64_t lapped;      // Samples skipped because the producer overtook the cursor
+        uint64_t torn;        // Batches overwritten while being read
+        uint64_t cursor;      // Next sequence this subscriber will receive
+    };
+
+private:
+    struct Subscriber {
+        SubscriberId id;
+        size_t batch_size;
+        std::chrono::microseconds max_latency;
+        Callback callback;
+        uint64_t cursor;
+        bool waiting;                                    // Latency timer armed
+        std::chrono::steady_clock::time_point pending_since;
+        bool busy;
+        bool removed;
+        SubscriberStats stats;
+    };
+
+    std::vector<T> ring;
+    uint64_t mask;
+    std::atomic<uint64_t> head;            // Next sequence to be written
+    std::atomic<uint64_t> wake_sequence;   // Producer notifies once head reaches this
+
+    mutable std::mutex stream_mutex;
+    std::condition_variable stream_cv;
+    std::condition_variable idle_cv;
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    SubscriberId next_id;
+
+    std::thread delivery_thread;
+    bool running;
+
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    RingSpan<const T> viewLocked(uint64_t first, size_t count) const {
+        size_t start = static_cast<size_t>(first & mask);
+        size_t head_count = std::min(count, ring.size() - start);
+        RingSpan<const T> view;
+        view.head = Span<const T>(ring.data() + start, head_count);
+        view.tail = Span<const T>(ring.data(), count - head_count);
+        return view;
+    }
+
+    void deliveryLoop() {
+        std::unique_lock<std::mutex> lock(stream_mutex);
+
+        while (running) {
+            auto now = std::chrono::steady_clock::now();
+            uint64_t current = head.load(std::memory_order_acquire);
+            auto wake_time = now + std::chrono::seconds(1);
+            uint64_t next_wake = UINT64_MAX;
+            Subscriber* due = nullptr;
+
+            for (auto& sub : subscribers) {
+                if (sub->removed) continue;
+
+                // Producer overtook this subscriber: skip to the oldest retained sample
+                if (current - sub->cursor > ring.size()) {
+                    uint64_t oldest = current - ring.size();
+                    sub->stats.lapped += oldest - sub->cursor;
+                    sub->cursor = oldest;
+                }
+
+                uint64_t pending = current - sub->cursor;
+                if (pending == 0) {
+                    sub->waiting = false;
+                    next_wake = std::min(next_wake, sub->cursor + 1); // Arm the latency timer
+                    continue;
+                }
+
+                if (!sub->waiting) {
+                    sub->waiting = true;
+                    sub->pending_since = now;
+                }
+
+                auto deadline = sub->pending_since + sub->max_latency;
+                if (pending >= sub->batch_size || now >= deadline) {
+                    if (!due) due = sub.get();
+                    continue;
+                }
+
+                wake_time = std::min(wake_time, deadline);
+                next_wake = std::min(next_wake, sub->cursor + sub->batch_size);
+            }
+
+            if (!due) {
+                wake_sequence.store(next_wake, std::memory_order_release);
+                // Re-check: the producer may have crossed the threshold before the store.
+                // Pairs with the fence in publish(): either it sees next_wake or we see its head
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (head.load(std::memory_order_acquire) >= next_wake) {
+                    continue;
+                }
+                stream_cv.wait_until(lock, wake_time);
+                continue;
+            }
+
+            // Deliver one batch to the due subscriber, then rescan
+            uint64_t first = due->cursor;
+            size_t count = static_cast<size_t>(std::min<uint64_t>(current - first, due->batch_size));
+            RingSpan<const T> batch = viewLocked(first, count);
+            due->busy = true;
+            Callback callback = due->callback;
+
+            lock.unlock();
+            try {
+                callback(batch, first);
+            } catch (const std::exception& e) {
+                std::cerr << "Error in stream subscriber callback: " << e.what() << std::endl;
+            }
+            lock.lock();
+
+            // Anything overwritten during the callback was read torn
+            if (head.load(std::memory_order_acquire) - first > ring.size()) {
+                due->stats.torn++;
+            }
+            due->cursor = first + count;
+            due->waiting = false;
+            due->stats.delivered += count;
+            due->stats.batches++;
+            due->busy = false;
+            idle_cv.notify_all();
+
+            subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                [](const std::unique_ptr<Subscriber>& s) { return s->removed && !s->busy; }),
+                subscribers.end());
+        }
+    }
+
+public:
+    explicit SampleStream(size_t capacity = 4096)
+        : ring(roundUpPowerOfTwo(std::max<size_t>(capacity, 2))),
+          mask(ring.size() - 1),
+          head(0),
+          wake_sequence(UINT64_MAX),
+          next_id(1),
+          running(false) {
+    }
+
+    ~SampleStream() {
+        {
+            std::lock_guard<std::mutex> lock(stream_mutex);
+            running = false;
+        }
+        stream_cv.notify_all();
+        if (delivery_thread.joinable()) {
+            delivery_thread.join();
+        }
+    }
+
+    SampleStream(const SampleStream&) = delete;
+    SampleStream& operator=(const SampleStream&) = delete;
+
+    // Producer side (single thread)
+    void publish(const T& sample) {
+        uint64_t sequence = head.load(std::memory_order_relaxed);
+        ring[sequence & mask] = sample;
+        head.store(sequence + 1, std::memory_order_release);
+
+        // Store-load ordering against the delivery thread's wake_sequence store
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sequence + 1 >= wake_sequence.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(stream_mutex);
+            wake_sequence.store(UINT64_MAX, std::memory_order_relaxed);
+            stream_cv.notify_one();
+        }
+    }
+
+    // Subscribers start at the current head; callbacks run on the delivery thread
+    SubscriberId subscribe(size_t batch_size, std::chrono::microseconds max_latency, Callback callback) {
+        if (!callback || batch_size == 0) {
+            std::cerr << "Error: Invalid stream subscription" << std::endl;
+            return INVALID_SUBSCRIBER;
+        }
+
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        auto sub = std::make_unique<Subscriber>();
+        sub->id = next_id++;
+        sub->batch_size = std::min(batch_size, ring.size());
+        sub->max_latency = max_latency;
+        sub->callback = std::move(callback);
+        sub->cursor = head.load(std::memory_order_acquire);
+        sub->waiting = false;
+        sub->busy = false;
+        sub->removed = false;
+        sub->stats = SubscriberStats{};
+        SubscriberId id = sub->id;
+        subscribers.push_back(std::move(sub));
+
+        if (!running) {
+            running = true;
+            delivery_thread = std::thread(&SampleStream::deliveryLoop, this);
+        }
+        wake_sequence.store(0, std::memory_order_release); // Let the delivery thread rescan
+        stream_cv.notify_one();
+        return id;
+    }
+
+    // Waits for an in-flight callback unless called from inside one
+    bool unsubscribe(SubscriberId id) {
+        std::unique_lock<std::mutex> lock(stream_mutex);
+        for (auto& sub : subscribers) {
+            if (sub->id == id && !sub->removed) {
+                sub->removed = true;
+                Subscriber* target = sub.get();
+                if (std::this_thread::get_id() != delivery_thread.get_id()) {
+                    // The delivery thread may free the entry itself once the callback returns
+                    idle_cv.wait(lock, [this, target] {
+                        auto it = std::find_if(subscribers.begin(), subscribers.end(),
+                            [target](const std::unique_ptr<Subscriber>& s) { return s.get() == target; });
+                        if (it == subscribers.end()) return true;
+                        if ((*it)->busy) return false;
+                        subscribers.erase(it);
+                        return true;
+                    });
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool getSubscriberStats(SubscriberId id, SubscriberStats& stats) const {
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        for (const auto& sub : subscribers) {
+            if (sub->id == id && !sub->removed) {
+                stats = sub->stats;
+                stats.cursor = sub->cursor;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint64_t getPublishedCount() const { return head.load(std::memory_order_acquire); }
+    size_t getCapacity() const { return ring.size(); }
+};
+
+#endif // SAMPLE_STREAM_H
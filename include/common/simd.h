@@ -0,0 +1,190 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_USE_AVX 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_USE_SSE2 1
+#endif
+
+/**
+ * @brief Lane-wise float kernels over fixed 8-wide frames
+ *
+ * Every kernel works on arrays of simd::LANES floats aligned to
+ * simd::ALIGNMENT (one AVX register, or two SSE registers). The instruction
+ * set is chosen at compile time: AVX when the compiler targets it
+ * (Release builds use -march=native), SSE2 on any x86-64, plain scalar
+ * loops elsewhere.
+ */
+namespace simd {
+
+constexpr size_t LANES = 8;
+constexpr size_t ALIGNMENT = 32;
+
+inline const char* backendName() {
+#if defined(SIMD_USE_AVX)
+    return "AVX";
+#elif defined(SIMD_USE_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+// out = (in + offset) * scale
+inline void calibrate(float* out, const float* in, const float* offset, const float* scale) {
+#if defined(SIMD_USE_AVX)
+    __m256 v = _mm256_add_ps(_mm256_load_ps(in), _mm256_load_ps(offset));
+    _mm256_store_ps(out, _mm256_mul_ps(v, _mm256_load_ps(scale)));
+#elif defined(SIMD_USE_SSE2)
+    for (size_t i = 0; i < LANES; i += 4) {
+        __m128 v = _mm_add_ps(_mm_load_ps(in + i), _mm_load_ps(offset + i));
+        _mm_store_ps(out + i, _mm_mul_ps(v, _mm_load_ps(scale + i)));
+    }
+#else
+    for (size_t i = 0; i < LANES; ++i) {
+        out[i] = (in[i] + offset[i]) * scale[i];
+    }
+#endif
+}
+
+// state = alpha * in + (1 - alpha) * state  (exponential moving average)
+inline void lowPass(float* state, const float* in, float alpha) {
+#if defined(SIMD_USE_AVX)
+    __m256 s = _mm256_load_ps(state);
+    __m256 d = _mm256_sub_ps(_mm256_load_ps(in), s);
+    _mm256_store_ps(state, _mm256_add_ps(s, _mm256_mul_ps(d, _mm256_set1_ps(alpha))));
+#elif defined(SIMD_USE_SSE2)
+    __m128 a = _mm_set1_ps(alpha);
+    for (size_t i = 0; i < LANES; i += 4) {
+        __m128 s = _mm_load_ps(state + i);
+        __m128 d = _mm_sub_ps(_mm_load_ps(in + i), s);
+        _mm_store_ps(state + i, _mm_add_ps(s, _mm_mul_ps(d, a)));
+    }
+#else
+    for (size_t i = 0; i < LANES; ++i) {
+        state[i] += alpha * (in[i] - state[i]);
+    }
+#endif
+}
+
+// out = alpha * (prev_out + in - prev_in); prev_in = in; prev_out = out
+inline void highPass(float* out, float* prev_in, float* prev_out, const float* in, float alpha) {
+#if defined(SIMD_USE_AVX)
+    __m256 x = _mm256_load_ps(in);
+    __m256 y = _mm256_mul_ps(_mm256_set1_ps(alpha),
+        _mm256_add_ps(_mm256_load_ps(prev_out), _mm256_sub_ps(x, _mm256_load_ps(prev_in))));
+    _mm256_store_ps(prev_in, x);
+    _mm256_store_ps(prev_out, y);
+    _mm256_store_ps(out, y);
+#elif defined(SIMD_USE_SSE2)
+    __m128 a = _mm_set1_ps(alpha);
+    for (size_t i = 0; i < LANES; i += 4) {
+        __m128 x = _mm_load_ps(in + i);
+        __m128 y = _mm_mul_ps(a, _mm_add_ps(_mm_load_ps(prev_out + i), _mm_sub_ps(x, _mm_load_ps(prev_in + i))));
+        _mm_store_ps(prev_in + i, x);
+        _mm_store_ps(prev_out + i, y);
+        _mm_store_ps(out + i, y);
+    }
+#else
+    for (size_t i = 0; i < LANES; ++i) {
+        float y = alpha * (prev_out[i] + in[i] - prev_in[i]);
+        prev_in[i] = in[i];
+        prev_out[i] = y;
+        out[i] = y;
+    }
+#endif
+}
+
+// Sliding-window mean: sum += in - oldest; out = sum * inv_count
+inline void slidingMean(float* out, float* sum, const float* in, const float* oldest, float inv_count) {
+#if defined(SIMD_USE_AVX)
+    __m256 s = _mm256_add_ps(_mm256_load_ps(sum), _mm256_sub_ps(_mm256_load_ps(in), _mm256_load_ps(oldest)));
+    _mm256_store_ps(sum, s);
+    _mm256_store_ps(out, _mm256_mul_ps(s, _mm256_set1_ps(inv_count)));
+#elif defined(SIMD_USE_SSE2)
+    __m128 k = _mm_set1_ps(inv_count);
+    for (size_t i = 0; i < LANES; i += 4) {
+        __m128 s = _mm_add_ps(_mm_load_ps(sum + i), _mm_sub_ps(_mm_load_ps(in + i), _mm_load_ps(oldest + i)));
+        _mm_store_ps(sum + i, s);
+        _mm_store_ps(out + i, _mm_mul_ps(s, k));
+    }
+#else
+    for (size_t i = 0; i < LANES; ++i) {
+        sum[i] += in[i] - oldest[i];
+        out[i] = sum[i] * inv_count;
+    }
+#endif
+}
+
+// Bit i set when v[i] < low[i] or v[i] > high[i]
+inline uint32_t outsideMask(const float* v, const float* low, const float* high) {
+#if defined(SIMD_USE_AVX)
+    __m256 x = _mm256_load_ps(v);
+    __m256 outside = _mm256_or_ps(_mm256_cmp_ps(x, _mm256_load_ps(low), _CMP_LT_OQ),
+                                  _mm256_cmp_ps(x, _mm256_load_ps(high), _CMP_GT_OQ));
+    return static_cast<uint32_t>(_mm256_movemask_ps(outside));
+#elif defined(SIMD_USE_SSE2)
+    uint32_t mask = 0;
+    for (size_t i = 0; i < LANES; i += 4) {
+        __m128 x = _mm_load_ps(v + i);
+        __m128 outside = _mm_or_ps(_mm_cmplt_ps(x, _mm_load_ps(low + i)),
+                                   _mm_cmpgt_ps(x, _mm_load_ps(high + i)));
+        mask |= static_cast<uint32_t>(_mm_movemask_ps(outside)) << i;
+    }
+    return mask;
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < LANES; ++i) {
+        if (v[i] < low[i] || v[i] > high[i]) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// Running min/max and Welford mean/M2 update with one new frame
+inline void accumulateStats(float* min_v, float* max_v, float* mean, float* m2,
+                            const float* in, float inv_count) {
+#if defined(SIMD_USE_AVX)
+    __m256 x = _mm256_load_ps(in);
+    _mm256_store_ps(min_v, _mm256_min_ps(_mm256_load_ps(min_v), x));
+    _mm256_store_ps(max_v, _mm256_max_ps(_mm256_load_ps(max_v), x));
+    __m256 m = _mm256_load_ps(mean);
+    __m256 delta = _mm256_sub_ps(x, m);
+    m = _mm256_add_ps(m, _mm256_mul_ps(delta, _mm256_set1_ps(inv_count)));
+    _mm256_store_ps(mean, m);
+    _mm256_store_ps(m2, _mm256_add_ps(_mm256_load_ps(m2), _mm256_mul_ps(delta, _mm256_sub_ps(x, m))));
+#elif defined(SIMD_USE_SSE2)
+    __m128 k = _mm_set1_ps(inv_count);
+    for (size_t i = 0; i < LANES; i += 4) {
+        __m128 x = _mm_load_ps(in + i);
+        _mm_store_ps(min_v + i, _mm_min_ps(_mm_load_ps(min_v + i), x));
+        _mm_store_ps(max_v + i, _mm_max_ps(_mm_load_ps(max_v + i), x));
+        __m128 m = _mm_load_ps(mean + i);
+        __m128 delta = _mm_sub_ps(x, m);
+        m = _mm_add_ps(m, _mm_mul_ps(delta, k));
+        _mm_store_ps(mean + i, m);
+        _mm_store_ps(m2 + i, _mm_add_ps(_mm_load_ps(m2 + i), _mm_mul_ps(delta, _mm_sub_ps(x, m))));
+    }
+#else
+    for (size_t i = 0; i < LANES; ++i) {
+        min_v[i] = std::min(min_v[i], in[i]);
+        max_v[i] = std::max(max_v[i], in[i]);
+        float delta = in[i] - mean[i];
+        mean[i] += delta * inv_count;
+        m2[i] += delta * (in[i] - mean[i]);
+    }
+#endif
+}
+
+} // namespace simd
+
+#endif // SIMD_H
@@ -0,0 +1,70 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @brief Non-owning view over contiguous memory (C++17 stand-in for std::span)
+ */
+template <typename T>
+class Span {
+private:
+    T* ptr;
+    size_t count;
+
+public:
+    constexpr Span() : ptr(nullptr), count(0) {}
+    constexpr Span(T* data, size_t size) : ptr(data), count(size) {}
+
+    // Allow Span<T> -> Span<const T>
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) : ptr(other.data()), count(other.size()) {}
+
+    constexpr T* data() const { return ptr; }
+    constexpr size_t size() const { return count; }
+    constexpr size_t size_bytes() const { return count * sizeof(T); }
+    constexpr bool empty() const { return count == 0; }
+
+    constexpr T& operator[](size_t index) const { return ptr[index]; }
+    constexpr T* begin() const { return ptr; }
+    constexpr T* end() const { return ptr + count; }
+
+    constexpr Span subspan(size_t offset, size_t length) const {
+        return Span(ptr + offset, length);
+    }
+    constexpr Span first(size_t length) const { return Span(ptr, length); }
+};
+
+/**
+ * @brief View over the (at most two) contiguous segments of a ring buffer
+ *
+ * `head` holds the oldest elements, `tail` the wrapped-around remainder.
+ */
+template <typename T>
+struct RingSpan {
+    Span<T> head;
+    Span<T> tail;
+
+    size_t size() const { return head.size() + tail.size(); }
+    bool empty() const { return size() == 0; }
+
+    T& operator[](size_t index) const {
+        return index < head.size() ? head[index] : tail[index - head.size()];
+    }
+
+    // The oldest length elements
+    RingSpan first(size_t length) const {
+        return length <= head.size() ? RingSpan{head.first(length), Span<T>()}
+                                     : RingSpan{head, tail.first(length - head.size())};
+    }
+
+    // Calls fn(Span<T>) once per non-empty segment, oldest first
+    template <typename Fn>
+    void forEachSegment(Fn&& fn) const {
+        if (!head.empty()) fn(head);
+        if (!tail.empty()) fn(tail);
+    }
+};
+
+#endif // SPAN_H
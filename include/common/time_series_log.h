@@ -0,0 +1,141 @@
+#ifndef TIME_SERIES_LOG_H
+#define TIME_SERIES_LOG_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Persistent Compressed Time-Series Log
+ *
+ * Append-only, memory-mapped segment log for a single sample stream:
+ * - Gorilla-style compression (delta-of-delta timestamps, XOR floats)
+ * - Fixed-size segment files, rotated when full, optional retention limit
+ * - Independently decodable blocks so any block can be read on its own
+ * - Sparse in-memory time index (one entry per block) for fast seeks
+ * - Existing segments are recovered and indexed again on open()
+ *
+ * On-disk layout per segment file:
+ *   [SegmentHeader][BlockHeader][bitstream]...[BlockHeader][bitstream]
+ * A block is only counted once it is sealed, so a crash loses at most the
+ * block that was being encoded.
+ */
+class TimeSeriesLog {
+public:
+    struct Config {
+        size_t segment_size;          // Bytes per segment file
+        size_t block_samples;         // Samples per compressed block
+        size_t max_segments;          // Retention limit (0 = unlimited)
+        int64_t timestamp_resolution_ns; // Timestamp quantum stored on disk
+    };
+
+    struct Sample {
+        int64_t timestamp_ns;
+        float value;
+    };
+
+    struct Statistics {
+        size_t samples;
+        size_t blocks;
+        size_t segments;
+        size_t compressed_bytes;
+        double bits_per_sample;
+    };
+
+    // Batched visitor used by scan(): receives decoded samples in chunks
+    using ScanCallback = std::function<void(const Sample* samples, size_t count)>;
+
+private:
+    struct Segment {
+        std::string path;
+        int fd;
+        uint8_t* base;
+        size_t size;
+        uint64_t sequence;
+        std::shared_ptr<uint8_t> mapping;   // Owns base; scans hold it past close and retention
+    };
+
+    struct IndexEntry {
+        int64_t first_ts;
+        int64_t last_ts;
+        size_t segment;   // Position in segments vector
+        size_t offset;    // Byte offset of the BlockHeader
+        uint32_t count;
+        uint32_t payload_bytes;
+    };
+
+    // Incremental Gorilla encoder state for the block being written
+    struct BlockEncoder {
+        size_t header_offset;
+        uint8_t* payload;
+        uint64_t bit_position;
+        uint32_t count;
+        int64_t first_ts;
+        int64_t previous_ts;
+        int64_t previous_delta;
+        uint32_t previous_value;
+        int leading_zeros;
+        int trailing_zeros;
+        bool active;
+    };
+
+    std::string directory;
+    Config config;
+    mutable std::mutex log_mutex;
+    bool opened;
+
+    std::vector<Segment> segments;
+    std::vector<IndexEntry> index;
+    BlockEncoder encoder;
+    size_t write_offset;          // Next free byte in the active segment
+    uint64_t next_segment_sequence;
+
+    size_t total_samples;
+    size_t total_payload_bytes;
+
+    // Helper methods
+    bool openSegment(uint64_t sequence, bool create);
+    void closeSegment(Segment& segment);
+    bool rotateSegment();
+    bool recoverSegment(size_t segment_index);
+    void enforceRetention();
+    bool beginBlock(int64_t timestamp, float value);
+    void encodeSample(int64_t timestamp, float value);
+    void sealBlock();
+    size_t maxBlockBytes() const;
+    size_t decodeBlock(const uint8_t* segment_base, const IndexEntry& entry, std::vector<Sample>& out) const;
+    std::string segmentPath(uint64_t sequence) const;
+
+public:
+    TimeSeriesLog(const std::string& dir, const Config& cfg = defaultConfig());
+    ~TimeSeriesLog();
+
+    TimeSeriesLog(const TimeSeriesLog&) = delete;
+    TimeSeriesLog& operator=(const TimeSeriesLog&) = delete;
+
+    static Config defaultConfig();
+
+    // Lifecycle
+    bool open();
+    bool close();
+    bool isOpen() const;
+
+    // Writing (timestamps must be non-decreasing)
+    bool append(int64_t timestamp_ns, float value);
+    bool flush(); // Seals the current block so it is durable and indexed
+
+    // Reading: visits all samples with from_ns <= timestamp <= to_ns. The lock
+    // is held only to snapshot the index and the open block; sealed blocks are
+    // decoded and the callback runs without it, so appends are not held up
+    size_t scan(int64_t from_ns, int64_t to_ns, const ScanCallback& callback) const;
+    bool readLatest(Sample& sample) const;
+
+    Statistics getStatistics() const;
+    const std::string& getDirectory() const { return directory; }
+};
+
+#endif // TIME_SERIES_LOG_H
@@ -0,0 +1,103 @@
+#ifndef TSC_CLOCK_H
+#define TSC_CLOCK_H
+
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Cheap monotonic timestamps from the CPU time-stamp counter
+ *
+ * Reads the TSC (a few ns) instead of calling clock_gettime (tens of ns on
+ * virtualized hosts), and converts ticks to steady_clock time points with a
+ * 64x64 fixed-point multiply. The conversion is calibrated against
+ * CLOCK_MONOTONIC (the clock behind steady_clock on Linux) on first use.
+ *
+ * A rate measured once drifts from CLOCK_MONOTONIC (1 ppm is 86 ms a day),
+ * so the first now() after each RECALIBRATION_INTERVAL re-anchors the
+ * conversion. The rate comes from the whole span since the first
+ * calibration, plus a slew that cancels the offset by the next re-anchor:
+ * readings never step backwards, and TSC and steady_clock time points agree
+ * to within a few microseconds. Readers see the conversion through a
+ * seqlock and never block.
+ *
+ * Only used when the CPU reports an invariant TSC (constant rate across
+ * frequency and sleep states); otherwise every read falls back to
+ * steady_clock. Calibration spins for CALIBRATION_PERIOD on first use.
+ */
+class TscClock {
+public:
+    static constexpr std::chrono::milliseconds CALIBRATION_PERIOD{20};
+    static constexpr std::chrono::seconds RECALIBRATION_INTERVAL{1};
+
+private:
+    bool invariant;
+    uint64_t anchor_ticks;    // First calibration: baseline for the long-term rate
+    int64_t anchor_ns;
+    uint64_t recalibration_ticks;
+    double frequency_hz;
+
+    // Current conversion, rewritten by recalibrate() under the seqlock
+    mutable std::atomic<uint32_t> version;
+    mutable std::atomic<uint64_t> base_ticks;
+    mutable std::atomic<int64_t> base_ns;      // CLOCK_MONOTONIC at base_ticks
+    mutable std::atomic<uint64_t> ns_per_tick; // 2^32 fixed point
+    mutable std::atomic<bool> recalibrating;
+
+    TscClock();
+    void calibrate();
+    void recalibrate(uint64_t tick_value) const;
+
+    static int64_t convert(uint64_t tick_value, uint64_t from_ticks, int64_t from_ns, uint64_t scale) {
+        int64_t delta = static_cast<int64_t>(tick_value - from_ticks);
+        __int128 scaled = static_cast<__int128>(delta) * static_cast<__int128>(scale);
+        return from_ns + static_cast<int64_t>(scaled >> 32);
+    }
+
+public:
+    // Process-wide instance, calibrated on first use
+    static const TscClock& instance();
+
+    bool isInvariant() const { return invariant; }
+    double getFrequencyHz() const { return frequency_hz; }
+
+    uint64_t ticks() const {
+#if defined(__x86_64__) || defined(__i386__)
+        if (invariant) {
+            return __rdtsc();
+        }
+#endif
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::chrono::steady_clock::time_point toTimePoint(uint64_t tick_value) const {
+        uint32_t seen;
+        uint64_t from_ticks, scale;
+        int64_t from_ns;
+        do {
+            seen = version.load(std::memory_order_acquire);
+            from_ticks = base_ticks.load(std::memory_order_relaxed);
+            from_ns = base_ns.load(std::memory_order_relaxed);
+            scale = ns_per_tick.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seen & 1) != 0 || version.load(std::memory_order_relaxed) != seen);
+        return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(convert(tick_value, from_ticks, from_ns, scale))));
+    }
+
+    std::chrono::steady_clock::time_point now() const {
+        uint64_t tick_value = ticks();
+        if (invariant && static_cast<int64_t>(tick_value - base_ticks.load(std::memory_order_relaxed)) >
+                             static_cast<int64_t>(recalibration_ticks)) {
+            recalibrate(tick_value);
+        }
+        return toTimePoint(tick_value);
+    }
+};
+
+#endif // TSC_CLOCK_H
@@ -0,0 +1,36 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include "common/span.h"
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Table-driven CRCs used by the serial protocols
+ *
+ * All three are reflected CRCs computed slicing-by-8: eight 256-entry
+ * tables (built at compile time) fold eight input bytes per step with
+ * eight independent lookups, about 1 cycle per byte instead of the 4-8 of
+ * a bytewise table. When the target has PCLMULQDQ (Release builds use
+ * -march=native), CRC-32 folds 64-byte blocks with carry-less multiplies
+ * instead and leaves only the last few bytes to the tables.
+ *
+ * Each function takes the previous result to continue over split data:
+ * crc32(b, crc32(a)) == crc32(a + b). The defaults start a new CRC.
+ * Check values over "123456789": X.25 0x906E, MODBUS 0x4B37, CRC-32
+ * 0xCBF43926.
+ */
+namespace crc {
+
+// CRC-16/X.25 (HDLC FCS-16): poly 0x1021 reflected, init and final XOR 0xFFFF
+uint16_t crc16X25(Span<const uint8_t> data, uint16_t previous = 0);
+
+// CRC-16/MODBUS: poly 0x8005 reflected, init 0xFFFF, no final XOR
+uint16_t crc16Modbus(Span<const uint8_t> data, uint16_t previous = 0xFFFF);
+
+// CRC-32/ISO-HDLC (Ethernet, zlib, HDLC FCS-32)
+uint32_t crc32(Span<const uint8_t> data, uint32_t previous = 0);
+
+} // namespace crc
+
+#endif // CRC_H
@@ -0,0 +1,107 @@
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include "common/span.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief Byte-stuffed packet framing over a serial byte stream
+ *
+ * Turns payloads into self-delimiting frames and back:
+ * - COBS: consistent overhead byte stuffing, at most 1 byte per 254,
+ *   frames end with 0x00
+ * - SLIP (RFC 1055): 0xC0 delimits, 0xC0/0xDB escaped as 0xDB 0xDC/0xDD;
+ *   frames start and end with 0xC0
+ * - HDLC-like (RFC 1662 octet stuffing): 0x7E flags, 0x7E/0x7D escaped as
+ *   0x7D then the byte XOR 0x20; frames start and end with a flag
+ *
+ * An optional CRC over the payload (CRC-16/X.25 or CRC-32, least
+ * significant byte first, as the HDLC FCS) is stuffed along with it.
+ *
+ * Whole buffers are processed run by run: a vector scan (SSE2/AVX2, memchr
+ * for single bytes) finds the next byte that needs stuffing, and the clean
+ * run before it is copied with memcpy, so typical data costs little more
+ * than a copy plus the CRC.
+ *
+ * The stream decoder (feed) accepts arbitrary chunks, e.g. the views handed
+ * out by UART::setRxDelivery. Frames that arrive whole in one chunk are
+ * decoded straight from it; split frames are gathered first. Empty frames
+ * (back-to-back delimiters) are skipped, so SLIP and HDLC without a
+ * checksum cannot carry empty payloads; oversized, malformed and
+ * CRC-failed frames are dropped and counted.
+ */
+class Framer {
+public:
+    enum class Scheme {
+        COBS,
+        SLIP,
+        HDLC
+    };
+
+    enum class Checksum {
+        NONE,
+        CRC16,   // CRC-16/X.25
+        CRC32
+    };
+
+    struct Statistics {
+        size_t frames_encoded;
+        size_t frames_decoded;
+        size_t crc_errors;
+        size_t format_errors;    // Bad stuffing or shorter than the checksum
+        size_t oversize_errors;  // Longer than the maximum payload
+    };
+
+    // Payload view valid during the call
+    using FrameCallback = std::function<void(Span<const uint8_t> payload)>;
+
+    static constexpr size_t DEFAULT_MAX_PAYLOAD = 4096;
+
+private:
+    Scheme scheme;
+    Checksum checksum;
+    size_t max_payload;
+    uint8_t delimiter;
+    std::vector<uint8_t> pending;    // Partial frame carried across feed() calls
+    std::vector<uint8_t> decoded;    // Payload scratch
+    bool discarding;                 // Oversized frame: skip to the next delimiter
+    Statistics stats;
+
+    static size_t checksumSize(Checksum checksum);
+    size_t computeChecksum(Span<const uint8_t> payload, uint8_t* out) const;  // Returns its size
+    bool deliverFrame(Span<const uint8_t> frame, const FrameCallback& callback);
+
+public:
+    Framer(Scheme scheme, Checksum checksum = Checksum::CRC16, size_t max_payload = DEFAULT_MAX_PAYLOAD);
+
+    Scheme getScheme() const { return scheme; }
+    Checksum getChecksum() const { return checksum; }
+    size_t getMaxPayload() const { return max_payload; }
+
+    // Worst-case frame size for a payload, delimiters included
+    static size_t maxEncodedSize(Scheme scheme, Checksum checksum, size_t payload_size);
+
+    // Encode one frame into out (room for maxEncodedSize); returns the frame length
+    size_t encode(Span<const uint8_t> payload, uint8_t* out);
+    // Append one frame to out; returns the bytes appended
+    size_t encode(Span<const uint8_t> payload, std::vector<uint8_t>& out);
+
+    // Decode one frame without its delimiters into out (room for frame.size()
+    // bytes); false on bad stuffing, checksum or an oversized payload
+    bool decode(Span<const uint8_t> frame, uint8_t* out, size_t& payload_size);
+
+    // Stream decoding: calls callback once per good frame; returns the frames delivered
+    size_t feed(Span<const uint8_t> data, const FrameCallback& callback);
+    size_t feed(const RingSpan<const uint8_t>& data, const FrameCallback& callback);
+    void resetDecoder();   // Drop a partially received frame
+
+    Statistics getStatistics() const { return stats; }
+    void resetStatistics();
+
+    static const char* schemeToString(Scheme scheme);
+};
+
+#endif // FRAMING_H
@@ -0,0 +1,356 @@
+#ifndef MODBUS_H
+#define MODBUS_H
+
+#include "sdk/uart.h"
+#include "common/quantile_sketch.h"
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Modbus RTU over the simulated UARTs
+ *
+ * RTU frames are delimited by line silence. Both sides let the UART find
+ * them: RX delivery with an idle timeout of 3.5 characters at the UART's
+ * current settings (at least min_silence; the specification fixes 1.75 ms
+ * above 19200 baud) hands over one whole frame per callback, timed by the
+ * line model rather than by polling.
+ *
+ * Supported functions: read coils / discrete inputs / holding registers /
+ * input registers (1-4), write single coil / register (5, 6), write
+ * multiple coils / registers (15, 16). CRC-16/MODBUS, low byte first.
+ */
+namespace modbus {
+
+constexpr size_t MAX_ADU_SIZE = 256;              // Address + PDU + CRC
+constexpr uint8_t BROADCAST_ADDRESS = 0;
+constexpr uint8_t MAX_SLAVE_ADDRESS = 247;
+constexpr uint16_t MAX_READ_BITS = 2000;
+constexpr uint16_t MAX_READ_REGISTERS = 125;
+constexpr uint16_t MAX_WRITE_BITS = 1968;
+constexpr uint16_t MAX_WRITE_REGISTERS = 123;
+constexpr std::chrono::microseconds SPEC_MIN_SILENCE{1750};
+
+enum class FunctionCode : uint8_t {
+    READ_COILS = 0x01,
+    READ_DISCRETE_INPUTS = 0x02,
+    READ_HOLDING_REGISTERS = 0x03,
+    READ_INPUT_REGISTERS = 0x04,
+    WRITE_SINGLE_COIL = 0x05,
+    WRITE_SINGLE_REGISTER = 0x06,
+    WRITE_MULTIPLE_COILS = 0x0F,
+    WRITE_MULTIPLE_REGISTERS = 0x10
+};
+
+enum class ExceptionCode : uint8_t {
+    NONE = 0x00,
+    ILLEGAL_FUNCTION = 0x01,
+    ILLEGAL_DATA_ADDRESS = 0x02,
+    ILLEGAL_DATA_VALUE = 0x03,
+    SLAVE_DEVICE_FAILURE = 0x04
+};
+
+// Inter-frame silence (t3.5) for the UART's current line settings
+std::chrono::microseconds frameSilence(const UART& uart, std::chrono::microseconds min_silence = SPEC_MIN_SILENCE);
+
+std::string functionToString(FunctionCode function);
+std::string exceptionToString(ExceptionCode exception);
+
+} // namespace modbus
+
+/**
+ * @brief The four Modbus data tables of a slave, built from blocks
+ *
+ * Each block covers a contiguous address range of one table and is one of:
+ * - owned storage (addRegisters), for plain set points
+ * - mapped memory (mapRegisters): read and written in place through a
+ *   volatile pointer, e.g. a peripheral's register file or a region
+ *   returned by VirtualDeviceDriver::mmapDevice
+ * - bound handlers (bindRegisters): computed from peripheral state on each
+ *   read (a sensor's latest sample), optional write handler
+ *
+ * Coils and discrete inputs are one value per bit, nonzero = on. A request
+ * may span adjacent blocks; a gap is ILLEGAL_DATA_ADDRESS. All access is
+ * serialized by the map's mutex; handlers run under it.
+ */
+class ModbusRegisterMap {
+public:
+    enum class Table {
+        COILS,
+        DISCRETE_INPUTS,
+        HOLDING_REGISTERS,
+        INPUT_REGISTERS
+    };
+
+    using ReadHandler = std::function<uint16_t(uint16_t address)>;
+    using WriteHandler = std::function<bool(uint16_t address, uint16_t value)>;  // false = device failure
+
+private:
+    struct Block {
+        uint16_t start;
+        uint32_t count;
+        volatile uint16_t* memory;      // Owned or mapped storage, null for handlers
+        std::unique_ptr<uint16_t[]> owned;
+        ReadHandler read;
+        WriteHandler write;
+    };
+
+    std::vector<Block> tables[4];       // Sorted by start, non-overlapping
+    mutable std::mutex map_mutex;
+
+    bool insertBlock(Table table, Block block);
+    template <typename Access>
+    modbus::ExceptionCode forEachSegmentLocked(Table table, uint16_t start, uint16_t count, Access access) const;
+
+public:
+    ModbusRegisterMap() = default;
+    ModbusRegisterMap(const ModbusRegisterMap&) = delete;
+    ModbusRegisterMap& operator=(const ModbusRegisterMap&) = delete;
+
+    bool addRegisters(Table table, uint16_t start, uint16_t count);
+    bool mapRegisters(Table table, uint16_t start, uint16_t count, volatile uint16_t* memory);
+    bool bindRegisters(Table table, uint16_t start, uint16_t count, ReadHandler read, WriteHandler write = nullptr);
+
+    // Protocol access (what a request sees)
+    modbus::ExceptionCode read(Table table, uint16_t start, uint16_t count, uint16_t* values) const;
+    modbus::ExceptionCode write(Table table, uint16_t start, uint16_t count, const uint16_t* values);
+
+    // Application access to one address of any table
+    bool setValue(Table table, uint16_t address, uint16_t value);
+    bool getValue(Table table, uint16_t address, uint16_t& value) const;
+};
+
+/**
+ * @brief Modbus RTU slave on a UART
+ *
+ * Runs entirely in the UART's RX thread: each delivered frame is checked
+ * (address first, so traffic for other slaves on a shared bus costs a
+ * byte compare), executed against the register map and answered through
+ * the UART's TX FIFO. Broadcasts (address 0) are executed, not answered.
+ * The UART needs RX and TX FIFOs of at least 256 bytes. stop() (and the
+ * destructor) waits for a frame being handled, so the slave may be
+ * destroyed while its UART keeps running.
+ */
+class ModbusSlave {
+public:
+    struct Statistics {
+        size_t requests;       // Addressed to this slave (broadcasts included)
+        size_t exceptions;
+        size_t crc_errors;
+        size_t ignored;        // For other slaves
+    };
+
+private:
+    UART& uart;
+    uint8_t address;
+    ModbusRegisterMap& registers;
+    std::atomic<bool> running;
+    std::atomic<size_t> requests;
+    std::atomic<size_t> exceptions;
+    std::atomic<size_t> crc_errors;
+    std::atomic<size_t> ignored;
+    uint8_t frame[modbus::MAX_ADU_SIZE];       // RX thread scratch
+    uint8_t reply[modbus::MAX_ADU_SIZE];
+    std::vector<uint16_t> values;
+
+    void onFrame(const RingSpan<const uint8_t>& data);
+    size_t execute(const uint8_t* pdu, size_t size, uint8_t* out);   // Returns the reply PDU size
+    size_t exceptionReply(uint8_t function, modbus::ExceptionCode exception, uint8_t* out);
+
+public:
+    ModbusSlave(UART& uart, uint8_t address, ModbusRegisterMap& registers);
+    ~ModbusSlave();
+
+    ModbusSlave(const ModbusSlave&) = delete;
+    ModbusSlave& operator=(const ModbusSlave&) = delete;
+
+    bool start(std::chrono::microseconds min_silence = modbus::SPEC_MIN_SILENCE);
+    bool stop();
+    bool isRunning() const { return running.load(); }
+    uint8_t getAddress() const { return address; }
+    Statistics getStatistics() const;
+};
+
+/**
+ * @brief Modbus RTU master polling many links at once
+ *
+ * Each link (a UART to one slave, or to an RS-485 bus of many) carries one
+ * transaction at a time, as RTU requires; links run independently, so
+ * requests queued on different links overlap. There is no thread per link:
+ * - A request goes out from whichever thread finds its link free: the
+ *   submitting thread, or the link's RX thread right after it delivered
+ *   the previous response, so a busy link's next request leaves as soon as
+ *   the response frame is complete
+ * - One timer thread handles response timeouts (with retries), the
+ *   turnaround delay after broadcasts and the silence after a timeout:
+ *   neither a retry nor the next request goes out until the line has
+ *   been quiet for t3.5 past the deadline, so a late response is not run
+ *   into (one that still arrives for a pending retry completes it)
+ *
+ * Completions run on the link's RX thread (responses) or the timer thread
+ * (timeouts, broadcasts); they may submit the next request. Latency per
+ * slave is measured from the first transmission of a request to its
+ * response frame being delivered (so it includes the t3.5 end-of-frame
+ * silence), and kept as a quantile sketch.
+ *
+ * Stop the master before destroying its UARTs; stop() waits for response
+ * deliveries already running on the RX threads.
+ */
+class ModbusMaster {
+public:
+    using LinkId = uint32_t;
+    static constexpr LinkId INVALID_LINK = 0;
+
+    enum class Status {
+        OK,
+        EXCEPTION,      // Slave answered with an exception
+        TIMEOUT,        // No valid response after all retries
+        CANCELLED       // Master stopped
+    };
+
+    struct Request {
+        uint8_t slave;
+        modbus::FunctionCode function;
+        uint16_t address;
+        uint16_t count;                 // Ignored by single writes
+        std::vector<uint16_t> values;   // Writes: one per register / coil
+    };
+
+    struct Result {
+        Status status;
+        modbus::ExceptionCode exception;
+        uint8_t slave;
+        modbus::FunctionCode function;
+        Span<const uint16_t> values;    // Reads; valid during the completion
+        std::chrono::microseconds latency;
+        unsigned attempts;
+    };
+
+    using Completion = std::function<void(const Result& result)>;
+
+    struct Config {
+        std::chrono::milliseconds response_timeout;
+        std::chrono::microseconds broadcast_delay;  // Turnaround after a broadcast
+        std::chrono::microseconds min_silence;      // See modbus::frameSilence
+        unsigned retries;
+    };
+
+    struct SlaveStatistics {
+        size_t requests;
+        size_t responses;
+        size_t exceptions;
+        size_t timeouts;            // Attempts without a valid response
+        float latency_min_us;       // NaN before the first response
+        float latency_mean_us;
+        float latency_p50_us;
+        float latency_p99_us;
+        float latency_max_us;
+    };
+
+    struct LinkStatistics {
+        size_t transactions;
+        size_t bad_frames;          // CRC errors, stray or mismatched responses
+        size_t queued;
+        double utilization;         // Share of time since start() with frames on the line
+    };
+
+private:
+    struct Pending {
+        Request request;
+        Completion completion;
+        unsigned attempts;
+        std::chrono::steady_clock::time_point first_sent;
+    };
+
+    struct SlaveStats {
+        size_t requests;
+        size_t responses;
+        size_t exceptions;
+        size_t timeouts;
+        double latency_sum_us;
+        QuantileSketch latency_us;
+    };
+
+    struct Link {
+        UART* uart;
+        LinkId id;
+        std::deque<Pending> queue;
+        bool in_flight;
+        bool expects_response;
+        bool retry_pending;                                 // Timed out; resent once deadline passes
+        Pending current;
+        std::chrono::steady_clock::time_point deadline;    // Timeout, broadcast turnaround or retry
+        std::chrono::steady_clock::time_point quiet_until; // Nothing is sent before: t3.5 after a timeout
+        std::chrono::microseconds silence;
+        std::chrono::nanoseconds frame_time;
+        uint64_t busy_ns;
+        size_t transactions;
+        size_t bad_frames;
+        uint8_t request_frame[modbus::MAX_ADU_SIZE];
+        size_t request_size;
+        std::array<std::unique_ptr<SlaveStats>, modbus::MAX_SLAVE_ADDRESS + 1> slaves;
+        uint8_t rx_frame[modbus::MAX_ADU_SIZE];             // RX thread scratch
+        std::vector<uint16_t> rx_values;
+    };
+
+    struct Finished {
+        Completion completion;
+        Result result;
+    };
+
+    Config config;
+    std::vector<std::unique_ptr<Link>> links;   // Index = LinkId - 1; fixed once started
+    mutable std::mutex master_mutex;
+    std::condition_variable timer_cv;
+    std::thread timer_thread;
+    std::atomic<bool> running;
+    std::chrono::steady_clock::time_point timer_wake;
+    std::chrono::steady_clock::time_point start_time;
+
+    void timerLoop();
+    void onResponse(Link& link, const RingSpan<const uint8_t>& data);
+    void pumpLocked(Link& link, std::chrono::steady_clock::time_point now);
+    bool sendLocked(Link& link, std::chrono::steady_clock::time_point now);
+    void finishLocked(Link& link, Status status, modbus::ExceptionCode exception,
+                      Span<const uint16_t> values, std::chrono::steady_clock::time_point now, Finished& out);
+    SlaveStats& slaveStatsLocked(Link& link, uint8_t slave);
+    void armTimerLocked(std::chrono::steady_clock::time_point when);
+    Link* findLink(LinkId id) const;
+    static size_t buildRequest(const Request& request, uint8_t* out);   // Returns the ADU size, 0 if invalid
+
+public:
+    explicit ModbusMaster(const Config& cfg = defaultConfig());
+    ~ModbusMaster();
+
+    ModbusMaster(const ModbusMaster&) = delete;
+    ModbusMaster& operator=(const ModbusMaster&) = delete;
+
+    static Config defaultConfig();
+
+    // Links are added before start(); the UART needs 256-byte FIFOs
+    LinkId addLink(UART& uart);
+    bool start();
+    bool stop();   // Pending requests complete as CANCELLED
+    bool isRunning() const { return running.load(); }
+
+    bool submit(LinkId link, Request request, Completion completion);
+    bool readHoldingRegisters(LinkId link, uint8_t slave, uint16_t address, uint16_t count, Completion completion);
+    bool readInputRegisters(LinkId link, uint8_t slave, uint16_t address, uint16_t count, Completion completion);
+    bool writeSingleRegister(LinkId link, uint8_t slave, uint16_t address, uint16_t value, Completion completion);
+    bool writeMultipleRegisters(LinkId link, uint8_t slave, uint16_t address, const std::vector<uint16_t>& values,
+                                Completion completion);
+
+    SlaveStatistics getSlaveStatistics(LinkId link, uint8_t slave) const;
+    LinkStatistics getLinkStatistics(LinkId link) const;
+    void resetStatistics();
+};
+
+#endif // MODBUS_H
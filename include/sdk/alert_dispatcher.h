@@ -0,0 +1,144 @@
+#ifndef ALERT_DISPATCHER_H
+#define ALERT_DISPATCHER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+/**
+ * @brief Bounded, Coalescing Alert Dispatcher
+ *
+ * Delivers peripheral alerts off the sampling path without spawning threads:
+ * - One bounded queue served by a fixed pool of worker threads
+ * - Per-source coalescing: repeats while an alert is pending become a count
+ * - Per-source rate limiting (minimum interval between callbacks)
+ * - Callbacks for one source never run concurrently
+ * - Dropped alerts (queue full) are counted and reported
+ *
+ * ThresholdMonitor provides the matching hysteresis/debounce state machine
+ * that decides when a sample stream should post alerts at all.
+ */
+class AlertDispatcher {
+public:
+    using AlertCallback = std::function<void(float value, const std::string& message)>;
+    using SourceId = uint32_t;
+    static constexpr SourceId INVALID_SOURCE = 0;
+
+    struct AlertPolicy {
+        float hysteresis;                        // Band inside the thresholds required to clear
+        uint32_t debounce_samples;               // Consecutive violations before raising
+        std::chrono::milliseconds min_interval;  // Rate limit per source
+    };
+
+    struct Statistics {
+        size_t posted;        // Alerts accepted from sources
+        size_t dispatched;    // Callback invocations
+        size_t coalesced;     // Alerts folded into a pending callback
+        size_t dropped;       // Alerts rejected because the queue was full
+        size_t callback_errors;
+        size_t queue_high_water;
+    };
+
+private:
+    struct Source {
+        std::string description;
+        AlertCallback callback;
+        std::chrono::milliseconds min_interval;
+        bool active;
+        bool queued;          // Present in the dispatch queue
+        bool deferred;        // Waiting for the rate limit or an in-flight callback
+        bool in_flight;
+        size_t pending_count;
+        float latest_value;
+        size_t dropped;
+        std::chrono::steady_clock::time_point next_allowed;
+    };
+
+    mutable std::mutex dispatch_mutex;
+    std::condition_variable dispatch_cv;
+    std::condition_variable idle_cv;
+
+    std::deque<Source> sources;          // Index = SourceId - 1; growth keeps references valid
+    std::vector<SourceId> free_ids;
+    std::vector<SourceId> deferred_ids;
+
+    // Bounded FIFO of source ids ready for dispatch
+    std::vector<SourceId> queue;
+    size_t queue_head;
+    size_t queue_count;
+
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+
+    Statistics stats;
+
+    // Helper methods
+    void workerLoop();
+    bool enqueueLocked(SourceId id);
+    void promoteDeferredLocked(std::chrono::steady_clock::time_point now);
+    bool isWorkerThread() const;
+    static std::string formatMessage(const std::string& description, float value, size_t count);
+
+public:
+    AlertDispatcher(size_t queue_capacity = 256, size_t worker_count = 1);
+    ~AlertDispatcher();
+
+    AlertDispatcher(const AlertDispatcher&) = delete;
+    AlertDispatcher& operator=(const AlertDispatcher&) = delete;
+
+    // Process-wide dispatcher shared by peripherals that are not given one
+    static std::shared_ptr<AlertDispatcher> getDefault();
+    static AlertPolicy defaultPolicy();
+
+    // Source management; unregisterSource() waits for an in-flight callback
+    SourceId registerSource(const std::string& description, AlertCallback callback,
+                            std::chrono::milliseconds min_interval);
+    bool unregisterSource(SourceId id);
+    // Also applies to an alert already waiting for the rate limit
+    bool setMinInterval(SourceId id, std::chrono::milliseconds min_interval);
+
+    // Non-blocking; returns false only if the alert was dropped
+    bool post(SourceId id, float value);
+
+    Statistics getStatistics() const;
+    size_t getDroppedCount(SourceId id) const;
+    size_t getQueueCapacity() const { return queue.size(); }
+};
+
+/**
+ * @brief Threshold crossing state machine with hysteresis and debounce
+ *
+ * Raises after debounce_samples consecutive out-of-range samples and only
+ * clears once the value is back inside the thresholds by the hysteresis band.
+ */
+class ThresholdMonitor {
+public:
+    enum class Transition {
+        NONE,      // Normal, or still debouncing
+        RAISED,    // Alarm just became active
+        REPEATED,  // Alarm active and still violating
+        HOLDING,   // Alarm active, inside the hysteresis band
+        CLEARED    // Alarm just cleared
+    };
+
+private:
+    bool active;
+    uint32_t violation_streak;
+
+public:
+    ThresholdMonitor() : active(false), violation_streak(0) {}
+
+    Transition update(float value, float low, float high, const AlertDispatcher::AlertPolicy& policy);
+    void reset() { active = false; violation_streak = 0; }
+    bool isActive() const { return active; }
+};
+
+#endif // ALERT_DISPATCHER_H
@@ -0,0 +1,148 @@
+#ifndef ANOMALY_DETECTOR_H
+#define ANOMALY_DETECTOR_H
+
+#include "sdk/sensor.h"
+#include "sdk/alert_dispatcher.h"
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Windowed anomaly detection on sensor streams
+ *
+ * Evaluates blocks of samples with SIMD kernels (predictive maintenance):
+ * - Rolling z-score: |x - mean| > z_threshold * std, against the baseline
+ *   window preceding the block (rounded up to whole blocks; only per-block
+ *   sums are kept, so the window costs no per-sample memory)
+ * - Rate of change: |x[i] - x[i-1]| exceeds max_rate (units per second)
+ * - Two-sided CUSUM on the deviation from the baseline mean; slack and
+ *   threshold are in baseline standard deviations. Evaluated as a prefix
+ *   sum / running minimum scan, so it vectorizes like the others.
+ *
+ * The z-score and CUSUM detectors start once the baseline window is full.
+ * A detector raises an event on the first anomalous sample after a clean
+ * block; events are posted through the AlertDispatcher (rate limited and
+ * coalesced there), one alert source per detector.
+ */
+class AnomalyDetector {
+public:
+    enum class Detector {
+        Z_SCORE,
+        RATE_OF_CHANGE,
+        CUSUM
+    };
+    static constexpr size_t DETECTOR_COUNT = 3;
+    static constexpr size_t MAX_BLOCK_SIZE = 4096;
+
+    struct Config {
+        size_t window;            // Baseline samples (z-score, CUSUM), multiple of block_size
+        size_t block_size;        // Samples per evaluation block
+        float z_threshold;        // 0 = disabled
+        float max_rate;           // Units per second, 0 = disabled
+        float cusum_slack;        // k, in baseline standard deviations
+        float cusum_threshold;    // h, in baseline standard deviations, 0 = disabled
+        float sample_rate_hz;     // 0 = take the attached sensor's sampling rate
+    };
+
+    struct Event {
+        std::chrono::steady_clock::time_point timestamp;
+        Detector detector;
+        float value;              // Offending sample
+        float score;              // |z|, rate (units/s) or CUSUM statistic (std units)
+    };
+
+    struct Statistics {
+        size_t samples_processed;
+        size_t blocks_processed;
+        size_t anomalies[DETECTOR_COUNT];  // Anomalous samples
+        size_t events[DETECTOR_COUNT];     // Raised events
+        double ns_per_sample;              // Evaluation cost, sampled every few blocks
+    };
+
+    using AlertCallback = AlertDispatcher::AlertCallback;
+
+private:
+    std::string name;
+    Config config;
+    mutable std::mutex detector_mutex;
+
+    // Pending block (samples are evaluated block_size at a time)
+    std::vector<float> block;
+    std::chrono::steady_clock::time_point block_time;   // Newest sample in the block
+
+    // Baseline: ring of per-block sums of (x - reference), reference avoids cancellation
+    struct BlockSums {
+        double sum;
+        double sum_squares;
+    };
+    std::vector<BlockSums> baseline_blocks;
+    size_t baseline_pos;
+    size_t baseline_filled;       // Blocks
+    double baseline_sum;
+    double baseline_sum_squares;
+    float reference;
+    bool has_reference;
+
+    float previous_value;
+    bool has_previous;
+    float cusum_high;
+    float cusum_low;
+    float sample_rate;
+    float max_step;               // max_rate / sample_rate
+    bool active[DETECTOR_COUNT];
+
+    Event latest_event;
+    bool has_event;
+    Statistics stats;
+    double total_ns;              // Over sampled blocks
+    size_t timed_samples;
+
+    // Alert path
+    std::shared_ptr<AlertDispatcher> alert_dispatcher;
+    AlertDispatcher::SourceId alert_sources[DETECTOR_COUNT];
+
+    Sensor* sensor;
+    Sensor::SubscriberId subscription;
+
+    // Helper methods
+    void configureRateLocked(float rate_hz);
+    size_t pushLocked(float value, std::chrono::steady_clock::time_point timestamp,
+                      std::vector<std::pair<AlertDispatcher::SourceId, float>>& alerts);
+    size_t evaluateBlockLocked(std::vector<std::pair<AlertDispatcher::SourceId, float>>& alerts);
+    void updateBaselineLocked(const BlockSums& sums);
+    void raiseLocked(Detector detector, size_t index, float score, size_t count,
+                     std::vector<std::pair<AlertDispatcher::SourceId, float>>& alerts);
+
+public:
+    explicit AnomalyDetector(const std::string& name, const Config& cfg = defaultConfig(),
+                             std::shared_ptr<AlertDispatcher> dispatcher = AlertDispatcher::getDefault());
+    ~AnomalyDetector();
+
+    AnomalyDetector(const AnomalyDetector&) = delete;
+    AnomalyDetector& operator=(const AnomalyDetector&) = delete;
+
+    static Config defaultConfig();
+
+    // Stream attachment (one sensor at a time)
+    bool attach(Sensor& source);
+    bool detach();
+    bool isAttached() const;
+
+    // Events are delivered through the dispatcher; callback gets the sample value
+    bool enableAlerts(AlertCallback callback, std::chrono::milliseconds min_interval = std::chrono::milliseconds(1000));
+    bool disableAlerts();
+
+    // Direct feed for recorded data; returns the number of anomalous samples found
+    size_t process(const float* values, size_t count, float sample_rate_hz);
+
+    bool readLatestEvent(Event& event) const;
+    Statistics getStatistics() const;
+    void reset();
+
+    static std::string detectorToString(Detector detector);
+};
+
+#endif // ANOMALY_DETECTOR_H
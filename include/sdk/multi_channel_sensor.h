@@ -0,0 +1,180 @@
+#ifndef MULTI_CHANNEL_SENSOR_H
+#define MULTI_CHANNEL_SENSOR_H
+
+#include "sdk/peripheral.h"
+#include "sdk/sensor.h"
+#include "sdk/alert_dispatcher.h"
+#include "common/sample_stream.h"
+#include "common/simd.h"
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <array>
+#include <thread>
+#include <chrono>
+#include <functional>
+
+/**
+ * @brief Multi-Channel Sensor Peripheral Class
+ *
+ * Samples up to eight channels (3-axis IMU, ADC input multiplexer, ...)
+ * from a single thread into fixed-width frames that share one timestamp:
+ * - Per-channel calibration, thresholds and filter state
+ * - Calibration, filtering, threshold checks and statistics run lane-wise
+ *   across all channels at once (see common/simd.h)
+ * - Frame ring buffer, publish/subscribe streaming and per-channel alerts
+ *   through the shared AlertDispatcher
+ */
+class MultiChannelSensor : public Peripheral {
+public:
+    static constexpr size_t MAX_CHANNELS = simd::LANES;
+
+    using SensorType = Sensor::SensorType;
+    using FilterType = Sensor::FilterType;
+    using AlertCallback = std::function<void(size_t channel, float value, const std::string& message)>;
+
+    // One sample of every channel; unused lanes are zero
+    struct Frame {
+        alignas(simd::ALIGNMENT) float raw[MAX_CHANNELS];
+        alignas(simd::ALIGNMENT) float calibrated[MAX_CHANNELS];
+        std::chrono::steady_clock::time_point timestamp;
+        uint32_t threshold_mask;  // Bit per channel outside its thresholds
+    };
+
+    struct ChannelStatistics {
+        float min_val;
+        float max_val;
+        float avg_val;
+        size_t count;
+        float std_deviation;
+    };
+
+    using FrameStreamType = SampleStream<Frame>;
+    using SubscriberId = FrameStreamType::SubscriberId;
+    using FrameBatchCallback = FrameStreamType::Callback;
+
+private:
+    // Lane-aligned per-channel parameter/state vector
+    struct alignas(simd::ALIGNMENT) Lanes {
+        float v[MAX_CHANNELS];
+    };
+
+    SensorType sensor_type;
+    size_t channel_count;
+    std::atomic<bool> sampling_enabled;
+    std::atomic<int> sampling_rate_hz;
+
+    mutable std::mutex sensor_mutex;
+
+    // Frame ring buffer
+    std::vector<Frame> frame_buffer;
+    size_t buffer_index;
+    size_t frames_stored;
+
+    // Calibration and thresholds (unused lanes: offset 0, scale 1, open band)
+    Lanes calibration_offset;
+    Lanes calibration_scale;
+    Lanes low_threshold;
+    Lanes high_threshold;
+
+    // Filtering
+    FilterType filter_type;
+    int filter_window_size;
+    std::vector<Lanes> filter_window;  // Moving-average history
+    size_t filter_position;
+    size_t filter_filled;
+    Lanes filter_sum;
+    Lanes filter_state;                // Low-pass output / high-pass output
+    Lanes filter_prev_input;
+    bool filter_primed;
+
+    // Statistics
+    Lanes stat_min;
+    Lanes stat_max;
+    Lanes stat_mean;
+    Lanes stat_m2;
+    size_t sample_count;
+
+    // Alerts: one dispatcher source and threshold monitor per channel
+    std::atomic<bool> alerts_enabled;
+    std::shared_ptr<AlertDispatcher> alert_dispatcher;
+    std::array<AlertDispatcher::SourceId, MAX_CHANNELS> alert_sources;
+    AlertDispatcher::AlertPolicy alert_policy;
+    std::array<ThresholdMonitor, MAX_CHANNELS> threshold_monitors;
+
+    std::unique_ptr<FrameStreamType> frame_stream;
+
+    // Background sampling thread (one for all channels)
+    std::thread sampling_thread;
+    std::atomic<bool> sampling_running;
+
+    std::chrono::steady_clock::time_point last_device_file_update;
+    static constexpr std::chrono::milliseconds DEVICE_FILE_INTERVAL{100};
+
+    // Helper methods
+    void samplingLoop();
+    void generateRawFrame(float* raw) const;
+    void applyFilter(float* values);
+    void resetFilterLocked();
+    void resetStatisticsLocked();
+    std::string formatDeviceData() const;
+
+public:
+    MultiChannelSensor(const std::string& name, SensorType type, size_t channels);
+    ~MultiChannelSensor();
+
+    // Inherited from Peripheral
+    bool initialize() override;
+    bool cleanup() override;
+    std::string getStatus() const override;
+
+    size_t getChannelCount() const { return channel_count; }
+    SensorType getSensorType() const { return sensor_type; }
+
+    bool setSamplingRate(int hz);
+    int getSamplingRate() const { return sampling_rate_hz.load(); }
+
+    bool setBufferSize(size_t frames);
+    size_t getBufferSize() const;
+
+    // Filtering (applied per channel)
+    bool setFilter(FilterType type, int window_size = 5);
+    FilterType getFilterType() const;
+
+    // Per-channel calibration: calibrated = (raw + offset) * scale
+    bool setCalibration(const std::vector<float>& offsets, const std::vector<float>& scales);
+    bool setChannelCalibration(size_t channel, float offset, float scale);
+
+    // Per-channel thresholds
+    bool setThresholds(const std::vector<float>& low, const std::vector<float>& high);
+    bool setChannelThresholds(size_t channel, float low, float high);
+
+    // Alerts: hysteresis/debounce per channel, delivery through the dispatcher
+    bool enableAlerts(AlertCallback callback);
+    bool disableAlerts();
+    bool areAlertsEnabled() const { return alerts_enabled.load(); }
+    bool setAlertPolicy(const AlertDispatcher::AlertPolicy& policy);
+    bool setAlertDispatcher(std::shared_ptr<AlertDispatcher> dispatcher);
+
+    // Sampling control
+    bool startSampling();
+    bool stopSampling();
+    bool isSampling() const { return sampling_enabled.load(); }
+
+    // Data access
+    bool readLatestFrame(Frame& frame) const;
+    std::vector<Frame> readFrames(size_t num_frames = 0) const; // 0 = all
+    bool readSingle(Frame& frame);
+    bool clearBuffer();
+
+    // Streaming (see Sensor::subscribe)
+    SubscriberId subscribe(size_t batch_size, std::chrono::microseconds max_latency,
+                           FrameBatchCallback callback);
+    bool unsubscribe(SubscriberId id);
+
+    // Statistics
+    ChannelStatistics getChannelStatistics(size_t channel) const;
+    bool resetStatistics();
+};
+
+#endif // MULTI_CHANNEL_SENSOR_H
@@ -0,0 +1,139 @@
+#ifndef RS485_BUS_H
+#define RS485_BUS_H
+
+#include "sdk/uart.h"
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief RS-485 multidrop bus shared by many UARTs
+ *
+ * Every attached UART's TX line drives the bus; each burst is fanned out to
+ * the receivers straight from the sender's burst buffer (one shared copy of
+ * the frames, no per-node queue or thread), with the sender's stop-bit
+ * timestamps, so RX DMA, batching and idle-line detection work on every
+ * node. Collisions are decided under the bus lock; the fan-out itself runs
+ * without it, so receivers' RX callbacks may call back into the bus and a
+ * slow receiver holds up only its sender. The bus is passive: dozens of buses with hundreds of nodes cost
+ * nothing but the UARTs themselves.
+ *
+ * - TWO_WIRE (half duplex, nodes in RS485_HALF_DUPLEX mode): one pair; a
+ *   node's receiver is disabled while its driver is enabled, so it does
+ *   not hear itself
+ * - FOUR_WIRE (full duplex, nodes in RS485_FULL_DUPLEX mode): the master
+ *   drives the pair all slaves listen to, slaves share the return pair
+ * - A transmission holds its pair from its first start bit until
+ *   turnaround after its last stop bit (driver release). A node whose
+ *   frames overlap another driver's on the same pair collides. Collisions
+ *   are detected when a burst arrives, so the bursts fanned out before
+ *   that stay delivered (intact; the receivers see no corruption). The
+ *   burst that collides and every later burst of either driver are lost
+ *   until each transmission ends. One collision is reported per pair of
+ *   transmissions
+ * - enable_delay models a late driver enable: bytes whose start bit
+ *   begins before the driver is active never reach the bus
+ *
+ * Line settings of the nodes are not compared; mismatched nodes simply
+ * receive each other's bytes. Destroy the bus (or detach the nodes)
+ * before the UARTs.
+ */
+class RS485Bus {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId INVALID_NODE = 0;
+
+    enum class Wiring {
+        TWO_WIRE,   // Half duplex
+        FOUR_WIRE   // Full duplex
+    };
+
+    enum class Role {
+        MASTER,     // FOUR_WIRE: drives the slaves' receive pair
+        SLAVE
+    };
+
+    struct BusConfig {
+        Wiring wiring;
+        std::chrono::nanoseconds turnaround;    // Driver held after the last stop bit
+        std::chrono::nanoseconds enable_delay;  // Driver enable to driver active
+    };
+
+    struct CollisionEvent {
+        NodeId first;                           // Node already driving
+        NodeId second;                          // Node that drove over it
+        std::chrono::steady_clock::time_point time;  // Start of the overlapping burst
+    };
+
+    struct Statistics {
+        size_t bytes_carried;     // Bytes put on the bus (each counted once, not per receiver)
+        size_t bytes_lost;        // Collisions and driver-enable delay
+        size_t collisions;
+        size_t transmissions;     // Driver enable cycles
+    };
+
+    using CollisionCallback = std::function<void(const CollisionEvent& event)>;  // Runs on the sender's TX thread
+
+private:
+    struct Node {
+        UART* uart;
+        NodeId id;
+        int drive_pair;
+        int listen_pair;
+        bool driving;
+        bool colliding;                                // Collided during the current transmission
+        std::chrono::nanoseconds frame;
+        std::chrono::steady_clock::time_point drive_start;
+        std::chrono::steady_clock::time_point drive_end;   // Last stop bit put on the bus
+        std::chrono::steady_clock::time_point enabled_at;  // Driver active
+        size_t fanouts;                                // Bursts being fanned out to this node
+        std::vector<Node*> receivers;                  // Sender's fan-out scratch (its TX thread only)
+    };
+
+    std::string bus_name;
+    BusConfig config;
+    mutable std::mutex bus_mutex;
+    std::condition_variable fanout_cv;                 // A node's last fan-out finished
+    std::vector<std::unique_ptr<Node>> nodes;          // Index = NodeId - 1, null once detached
+    std::vector<Node*> listeners[2];                   // Per pair
+    std::vector<Node*> drivers[2];
+    CollisionCallback collision_callback;
+    Statistics stats;
+
+    static constexpr int MASTER_PAIR = 0;              // TWO_WIRE: the only pair
+    static constexpr int SLAVE_PAIR = 1;
+
+    void transmit(Node& sender, Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times);
+    void release(Node& sender, std::chrono::steady_clock::time_point last_stop);
+    bool overlapsLocked(const Node& other, std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end) const;
+    void rebuildPairsLocked();
+
+public:
+    explicit RS485Bus(const std::string& name, const BusConfig& cfg = defaultConfig());
+    ~RS485Bus();
+
+    RS485Bus(const RS485Bus&) = delete;
+    RS485Bus& operator=(const RS485Bus&) = delete;
+
+    static BusConfig defaultConfig();
+
+    // The UART must be in the RS-485 mode matching the wiring; role is ignored on TWO_WIRE
+    NodeId attach(UART& uart, Role role = Role::SLAVE);
+    bool detach(NodeId node);
+    size_t getNodeCount() const;
+    const std::string& getName() const { return bus_name; }
+    const BusConfig& getConfiguration() const { return config; }
+
+    bool isBusy() const;   // Some driver enabled
+    bool setCollisionCallback(CollisionCallback callback);
+    Statistics getStatistics() const;
+    void resetStatistics();
+};
+
+#endif // RS485_BUS_H
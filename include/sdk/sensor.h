@@ -2,6 +2,15 @@
 #define SENSOR_H
 
 #include "sdk/peripheral.h"
+#include "common/time_series_log.h"
+#include "sdk/trace_replay.h"
+#include "sdk/alert_dispatcher.h"
+#include "common/sample_stream.h"
+#include "common/span.h"
+#include "common/quantile_sketch.h"
+#include "common/fixed_point.h"
+#include "common/calibration.h"
+#include "common/tsc_clock.h"
 #include <mutex>
 #include <atomic>
 #include <vector>
@@ -14,13 +23,21 @@
  * @brief Sensor Peripheral Class
  * 
  * Simulates a real sensor peripheral with embedded systems features:
- * - ADC simulation (Analog-to-Digital Conversion)
+ * - ADC simulation: samples are quantized to adc_resolution-bit codes and
+ *   filtered/calibrated in fixed point, like MCU firmware
  * - Multiple sensor types (temperature, pressure, accelerometer, etc.)
  * - Configurable sampling rates and resolution
- * - Data filtering and calibration
- * - Threshold-based alerts/interrupts
- * - Ring buffer for data storage
- * - Statistical analysis (min, max, average)
+ * - Data filtering and calibration (linear, polynomial, piecewise-linear
+ *   or table curves, compiled to a per-code lookup table)
+ * - Threshold-based alerts/interrupts (debounced, rate limited, coalesced)
+ * - Ring buffer for data storage (zero-copy views and visitors)
+ * - Statistical analysis (min, max, average, streaming percentiles)
+ * - Persistent compressed history log (optional)
+ * - Replay of recorded field traces instead of synthetic data
+ * - Publish/subscribe streaming with batched, zero-copy delivery
+ * - Block timestamping for high rates: one clock read per block of samples
+ *   (optionally from the calibrated TSC), sample times derived from the
+ *   block base and the sample period
  */
 class Sensor : public Peripheral {
 public:
@@ -40,16 +57,42 @@ public:
         HIGH_PASS      // High-pass filter
     };
     
+    enum class TimestampMode {
+        PER_SAMPLE,    // Clock read for every sample, paced per sample
+        BLOCK          // One clock read per block; times = base + index * period
+    };
+    
+    enum class ClockSource {
+        STEADY,        // std::chrono::steady_clock
+        TSC            // Time-stamp counter calibrated against CLOCK_MONOTONIC (see TscClock)
+    };
+    
     struct SensorData {
         std::chrono::steady_clock::time_point timestamp;
-        float raw_value;        // Raw ADC value
+        float raw_value;        // ADC input in physical units (dequantized adc_code)
         float calibrated_value; // Calibrated sensor value
         bool threshold_exceeded; // Alert flag
+        uint16_t adc_code;      // Quantized ADC result (adc_resolution bits)
     };
     
     // Alert callback function type
     using AlertCallback = std::function<void(float value, const std::string& message)>;
     
+    // Streaming subscriptions
+    using SampleStreamType = SampleStream<SensorData>;
+    using SubscriberId = SampleStreamType::SubscriberId;
+    using SubscriberStats = SampleStreamType::SubscriberStats;
+    using SampleBatchCallback = SampleStreamType::Callback;
+    
+    // Zero-copy ring buffer access
+    using BufferVisitor = std::function<void(Span<const SensorData> segment)>;
+    
+    struct BufferView {
+        RingSpan<const SensorData> samples; // Oldest first, at most two segments
+        uint64_t first_sequence;            // Write sequence of samples[0]
+        uint64_t generation;                // Bumped when the buffer is cleared or resized
+    };
+    
 private:
     SensorType sensor_type;
     std::atomic<bool> sampling_enabled;
@@ -59,44 +102,104 @@ private:
     mutable std::mutex sensor_mutex;
     
     // Data storage (ring buffer)
-    std::vector<SensorData> data_buffer;
+    std::vector<SensorData> data_buffer;     // adc_code fills the record's padding: no per-sample overhead
     std::atomic<size_t> buffer_size;
     std::atomic<size_t> buffer_index;
+    std::atomic<uint64_t> write_sequence;    // Slot writes ever started (monotonic, bumped before the store)
+    std::atomic<uint64_t> buffer_generation;
+    uint64_t generation_start;               // write_sequence when the generation began
     
     // Filtering
     FilterType filter_type;
     std::atomic<int> filter_window_size;
-    std::vector<float> filter_buffer;
+    struct FilterState {
+        std::vector<int32_t> window;  // Q4 codes (moving average)
+        size_t position;
+        size_t filled;
+        int64_t sum;
+        int32_t output;               // Q4 codes
+        int32_t previous_input;
+        bool primed;
+    } filter_state;
+    
+    // Fixed-point ADC model (rebuilt when type or resolution change)
+    float adc_min;                 // Physical value of code 0
+    float adc_lsb;                 // Physical value of one code step
+    uint16_t adc_max_code;
     
-    // Calibration
-    std::atomic<float> calibration_offset;
-    std::atomic<float> calibration_scale;
+    // Calibration compiled for the current ADC model. Immutable once published:
+    // replaced under sensor_mutex with std::atomic_store, read lock-free with
+    // std::atomic_load, and read directly by the sampling thread under the lock.
+    struct CalibrationState {
+        std::shared_ptr<const Calibration> curve;
+        fixedpoint::Linear code_linear;  // LINEAR curves: ADC code -> value
+        fixedpoint::Linear ac_linear;    // LINEAR curves: high-pass output (no DC term) -> value
+        std::vector<float> code_table;   // Other curves: value of every ADC code
+    };
+    std::shared_ptr<const CalibrationState> calibration_state;
     
     // Thresholds and alerts
     std::atomic<float> high_threshold;
     std::atomic<float> low_threshold;
     std::atomic<bool> alerts_enabled;
-    AlertCallback alert_callback;
+    std::shared_ptr<AlertDispatcher> alert_dispatcher;
+    std::atomic<AlertDispatcher::SourceId> alert_source;
+    AlertDispatcher::AlertPolicy alert_policy;
+    ThresholdMonitor threshold_monitor;
     
     // Background sampling thread
     std::thread sampling_thread;
     std::atomic<bool> sampling_running;
     std::condition_variable sampling_cv;
     
+    // The sample stream takes one publisher at a time: held by external feeds for
+    // the whole call, and by startSampling() so the sampler never overlaps one
+    std::mutex feed_mutex;
+    
     // Statistics
     mutable std::atomic<float> min_value;
     mutable std::atomic<float> max_value;
     mutable std::atomic<float> avg_value;
     mutable std::atomic<size_t> sample_count;
+    QuantileSketch value_sketch;     // Since the last reset
+    QuantileRollup value_rollup;     // Rolling time buckets
+    
+    // Persistent history (compressed time-series log); shared so readers scan outside sensor_mutex
+    std::shared_ptr<TimeSeriesLog> history_log;
+    int64_t log_clock_offset_ns; // steady_clock -> system_clock offset
+    
+    // Broadcast ring feeding subscribers (independent of data_buffer)
+    std::unique_ptr<SampleStreamType> sample_stream;
+    
+    // Recorded trace replay (replaces generateRawValue when set)
+    std::shared_ptr<TraceReplaySource> replay_source;
+    
+    // Timestamping (fixed while sampling)
+    TimestampMode timestamp_mode;
+    size_t timestamp_block_size;     // Samples per clock read in BLOCK mode
+    ClockSource clock_source;
+    
+    // Device file refresh throttling (the file is a status summary, not a data path)
+    std::chrono::steady_clock::time_point last_device_file_update;
+    static constexpr std::chrono::milliseconds DEVICE_FILE_INTERVAL{100};
     
     // Helper methods
     std::string formatDeviceData() const;
     void samplingLoop();
     float generateRawValue() const;
-    float applyCalibration(float raw_value) const;
-    float applyFilter(float value);
+    uint16_t quantizeLocked(float value) const;
+    int32_t applyFilterLocked(uint16_t code);
+    void resetFilterLocked();
+    void rebuildFixedPointLocked();
+    void publishCalibrationLocked(std::shared_ptr<const Calibration> curve);
+    float calibrateFilteredLocked(int32_t filtered_q4) const;
+    void convertSampleLocked(float raw_value, SensorData& sample);
+    ThresholdMonitor::Transition commitSampleLocked(SensorData& sample);
+    void deliverSample(const SensorData& sample, ThresholdMonitor::Transition transition);
     bool checkThresholds(float value);
     void updateStatistics(float value);
+    BufferView viewBufferLocked(size_t num_samples) const;
+    void resetBufferLocked();
     std::string sensorTypeToString() const;
     
 public:
@@ -126,10 +229,12 @@ public:
     FilterType getFilterType() const { return filter_type; }
     int getFilterWindowSize() const { return filter_window_size.load(); }
     
-    // Calibration
+    // Calibration: curves map the ADC input (raw_value units) to the calibrated value
     bool setCalibration(float offset, float scale);
-    float getCalibrationOffset() const { return calibration_offset.load(); }
-    float getCalibrationScale() const { return calibration_scale.load(); }
+    bool setCalibration(std::shared_ptr<const Calibration> curve);
+    std::shared_ptr<const Calibration> getCalibration() const;
+    float getCalibrationOffset() const { return getCalibration()->getOffset(); }
+    float getCalibrationScale() const { return getCalibration()->getScale(); }
     
     // Threshold configuration
     bool setThresholds(float low, float high);
@@ -140,19 +245,79 @@ public:
     bool disableAlerts();
     bool areAlertsEnabled() const { return alerts_enabled.load(); }
     
+    // Alert delivery: hysteresis/debounce policy and the dispatcher used for callbacks
+    bool setAlertPolicy(const AlertDispatcher::AlertPolicy& policy);
+    AlertDispatcher::AlertPolicy getAlertPolicy() const;
+    bool setAlertDispatcher(std::shared_ptr<AlertDispatcher> dispatcher);
+    size_t getDroppedAlerts() const;
+    
     // Sampling control
     bool startSampling();
     bool stopSampling();
     bool isSampling() const { return sampling_enabled.load(); }
     
+    // Persistent history: samples are appended with wall-clock timestamps (ns since epoch)
+    bool enableLogging(const std::string& directory = "",
+                       const TimeSeriesLog::Config& log_config = TimeSeriesLog::defaultConfig());
+    bool disableLogging();
+    bool isLogging() const;
+    // The callback runs with no lock held: sampling and appends continue meanwhile
+    size_t readHistory(int64_t from_ns, int64_t to_ns, const TimeSeriesLog::ScanCallback& callback) const;
+    
+    // Trace replay: must be configured while not sampling (nullptr = synthetic data).
+    // Sampling stops on its own at the end of a non-looping trace
+    bool setReplaySource(std::shared_ptr<TraceReplaySource> source);
+    std::shared_ptr<TraceReplaySource> getReplaySource() const;
+    
+    // Timestamping: must be configured while not sampling. In BLOCK mode the clock
+    // is read once per block_size samples, the block is stamped backwards from that
+    // read (its last sample is "now") and sampling is paced per block, like a DMA ADC.
+    bool setTimestampMode(TimestampMode mode, size_t block_size = 64,
+                          ClockSource source = ClockSource::STEADY);
+    TimestampMode getTimestampMode() const;
+    size_t getTimestampBlockSize() const;
+    ClockSource getClockSource() const;
+    
+    // Streaming: batches of up to batch_size samples, or fewer once max_latency expires.
+    // Callbacks run on the stream's delivery thread and must not block for long.
+    SubscriberId subscribe(size_t batch_size, std::chrono::microseconds max_latency,
+                           SampleBatchCallback callback);
+    bool unsubscribe(SubscriberId id);
+    bool getSubscriberStats(SubscriberId id, SubscriberStats& stats) const;
+    
     // Data access
     bool readLatestSample(SensorData& data) const;
     std::vector<SensorData> readBuffer(size_t num_samples = 0) const; // 0 = all
+    
+    // Calls visitor once per contiguous segment of the newest num_samples (0 = all),
+    // oldest first, under the sensor lock. Returns the number of samples visited.
+    size_t visitBuffer(size_t num_samples, const BufferVisitor& visitor) const;
+    
+    // Lock-free view of the newest num_samples (0 = all). The sampling thread keeps
+    // writing: check isViewValid() after consuming the data (seqlock style) and retry
+    // if it was overwritten. Views must not be held across setBufferSize()/cleanup().
+    BufferView viewBuffer(size_t num_samples = 0) const;
+    bool isViewValid(const BufferView& view) const;
+    uint64_t getWriteSequence() const { return write_sequence.load(std::memory_order_acquire); }
     bool clearBuffer();
     
     // Single sample (for manual reading)
     bool readSingle(float& raw_value, float& calibrated_value);
     
+    // External feeds, rejected while sampling. processSample() runs one input
+    // through the sensor's own pipeline; commitSamples() stores samples converted
+    // elsewhere (e.g. StaticSensor) and fills in threshold_exceeded. Both then go through
+    // the ring, statistics, history log, subscribers and alerts like sampled data.
+    // Calls from several threads are serialized; startSampling() waits for one in progress.
+    bool processSample(float raw_value,
+                       std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+    size_t commitSamples(SensorData* samples, size_t count);
+    
+    // Raw ADC codes of the newest num_samples (0 = all), oldest first
+    size_t readADCCodes(std::vector<uint16_t>& codes, size_t num_samples = 0) const;
+    // Bulk code -> calibrated value conversion with the current calibration (SIMD)
+    bool convertADCCodes(const uint16_t* codes, size_t count, float* values) const;
+    
     // Statistics
     struct Statistics {
         float min_val;
@@ -160,11 +325,21 @@ public:
         float avg_val;
         size_t count;
         float std_deviation;
+        float p50;              // Streaming percentile estimates (see QuantileSketch)
+        float p95;
+        float p99;
     };
     
     Statistics getStatistics() const;
     bool resetStatistics();
     
+    // Percentiles: rank error bounded by QuantileSketch::normalizedRankError().
+    // Sketches merge across sensors for fleet-wide percentiles.
+    float getPercentile(double q) const;
+    QuantileSketch getQuantileSketch() const;
+    QuantileSketch getRecentQuantiles(std::chrono::seconds window) const;
+    bool setPercentileRollup(std::chrono::seconds bucket_duration, size_t bucket_count);
+    
     // Hardware register simulation
     struct SensorRegisters {
         uint16_t control;      // Control register
@@ -183,6 +358,9 @@ public:
     // Utility methods
     static std::string sensorTypeToString(SensorType type);
     static std::string filterTypeToString(FilterType type);
+    static std::string timestampModeToString(TimestampMode mode);
+    // Physical input range covered by the ADC for a sensor type
+    static void getADCRange(SensorType type, float& minimum, float& maximum);
 };
 
 #endif // SENSOR_H
\ No newline at end of file
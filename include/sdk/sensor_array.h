@@ -0,0 +1,292 @@
+#ifndef SENSOR_ARRAY_H
+#define SENSOR_ARRAY_H
+
+#include "sdk/peripheral.h"
+#include "sdk/sensor.h"
+#include "sdk/alert_dispatcher.h"
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+
+/**
+ * @brief Fleet of homogeneous sensors simulated as one peripheral
+ *
+ * Keeps the state of N sensors of one type in structure-of-arrays form
+ * instead of one Sensor object (thread, mutex, device file, atomics) each,
+ * so plants with hundreds of thousands of points fit in memory:
+ * - One fused kernel per tick generates, quantizes, filters, calibrates,
+ *   threshold-checks and accumulates statistics, eight sensors at a time
+ *   (SSE2 lanes; scalar on other targets)
+ * - Sensors are split into contiguous slices across a worker pool; a batch
+ *   of ticks runs slice by slice, so each slice's state stays in cache
+ * - History keeps the ADC code, the calibrated value and a threshold bit per
+ *   sensor per tick; timestamps are per tick (base + index * period)
+ * - SensorView exposes the Sensor read API for a single sensor
+ * - One alert source for the whole array: it posts the number of sensors
+ *   that crossed their thresholds, readExceeded() lists the offenders
+ *
+ * Synthetic noise comes from a per-sensor xorshift32 generator; normal
+ * distributions are approximated by the sum of four uniforms (Irwin-Hall).
+ * Filters run in float like MultiChannelSensor.
+ */
+class SensorArray : public Peripheral {
+public:
+    using SensorType = Sensor::SensorType;
+    using FilterType = Sensor::FilterType;
+    using SensorData = Sensor::SensorData;
+    using Statistics = Sensor::Statistics;
+    using AlertCallback = AlertDispatcher::AlertCallback;
+
+    static constexpr size_t MAX_SENSORS = size_t(1) << 24;
+    static constexpr size_t MAX_HISTORY = 4096;
+    static constexpr size_t MAX_THREADS = 64;
+
+    struct Config {
+        size_t history;          // Ticks kept per sensor
+        size_t threads;          // Worker threads including the ticking one, 0 = hardware concurrency
+        int adc_resolution;      // Bits (8-16)
+    };
+
+    // Read-only handle on one sensor, mirroring the Sensor data access API
+    class SensorView {
+    private:
+        const SensorArray* array;
+        size_t index;
+
+    public:
+        SensorView(const SensorArray& owner, size_t sensor) : array(&owner), index(sensor) {}
+
+        size_t getIndex() const { return index; }
+        SensorType getSensorType() const { return array->getSensorType(); }
+        int getSamplingRate() const { return array->getSamplingRate(); }
+        int getADCResolution() const { return array->getADCResolution(); }
+        float getCalibrationOffset() const { return array->getCalibrationOffset(index); }
+        float getCalibrationScale() const { return array->getCalibrationScale(index); }
+        float getLowThreshold() const { return array->getLowThreshold(index); }
+        float getHighThreshold() const { return array->getHighThreshold(index); }
+
+        bool readLatestSample(SensorData& data) const { return array->readLatestSample(index, data); }
+        std::vector<SensorData> readBuffer(size_t num_samples = 0) const { return array->readBuffer(index, num_samples); }
+        Statistics getStatistics() const { return array->getStatistics(index); }
+    };
+
+private:
+    // Everything a slice of the fused kernel touches for one batch of ticks
+    struct TickJob {
+        size_t stride;                 // Padded sensor count (row length)
+        size_t ticks;
+
+        // Synthetic source: value = offset + spread * noise, clamped
+        uint32_t* rng;
+        bool uniform;
+        float source_offset;
+        float source_spread;
+        float source_min;
+        float source_max;
+
+        // ADC model
+        float adc_min;
+        float adc_lsb;
+        float adc_inv_lsb;
+        float adc_max_code;
+
+        // Filter
+        FilterType filter_type;
+        float* filter_state;
+        float* filter_prev_input;
+        float* filter_sum;
+        float* filter_window;          // window_size rows
+        size_t window_size;
+        size_t window_position;
+        size_t filter_ticks;           // Ticks since the filter was reset
+
+        // Calibration, thresholds, statistics
+        const float* calibration_offset;
+        const float* calibration_scale;
+        const float* low_threshold;
+        const float* high_threshold;
+        float* stat_min;
+        float* stat_max;
+        float* stat_mean;
+        float* stat_m2;
+        size_t stat_count;
+
+        // History rows
+        uint16_t* history_codes;
+        float* history_values;
+        uint8_t* history_flags;        // One bit per sensor
+        size_t history_size;
+        size_t history_head;           // Row of the first tick
+        size_t history_stored;
+    };
+
+    SensorType sensor_type;
+    size_t sensor_count;
+    size_t padded_count;               // Multiple of SLICE_ALIGNMENT
+    Config config;
+    std::atomic<bool> sampling_enabled;
+    std::atomic<int> sampling_rate_hz;
+
+    mutable std::mutex array_mutex;
+
+    // ADC model and synthetic source (shared by all sensors)
+    float adc_min;
+    float adc_lsb;
+    uint16_t adc_max_code;
+    bool source_uniform;
+    float source_offset;
+    float source_spread;
+    float source_min;
+    float source_max;
+
+    // Per-sensor state, padded_count entries each
+    std::vector<uint32_t> rng_state;
+    std::vector<float> calibration_offset;
+    std::vector<float> calibration_scale;
+    std::vector<float> low_threshold;
+    std::vector<float> high_threshold;
+
+    // Filtering
+    FilterType filter_type;
+    size_t filter_window_size;
+    std::vector<float> filter_state;         // Low-pass output / high-pass output
+    std::vector<float> filter_prev_input;
+    std::vector<float> filter_sum;
+    std::vector<float> filter_window;        // filter_window_size rows
+    size_t filter_position;
+    size_t filter_ticks;
+
+    // Statistics (every sensor has seen the same number of ticks)
+    std::vector<float> stat_min;
+    std::vector<float> stat_max;
+    std::vector<float> stat_mean;
+    std::vector<float> stat_m2;
+    size_t stat_count;
+
+    // History ring: one row per tick
+    std::vector<uint16_t> history_codes;
+    std::vector<float> history_values;
+    std::vector<uint8_t> history_flags;
+    std::vector<std::chrono::steady_clock::time_point> history_times;
+    size_t history_head;                     // Next row
+    size_t history_stored;
+    uint64_t tick_count;
+    uint64_t threshold_crossings;
+
+    // Alerts
+    std::atomic<bool> alerts_enabled;
+    std::shared_ptr<AlertDispatcher> alert_dispatcher;
+    AlertDispatcher::SourceId alert_source;
+
+    // Worker pool: slice 0 runs on the ticking thread
+    std::vector<size_t> slice_bounds;
+    std::vector<size_t> slice_crossings;
+    std::vector<std::thread> workers;
+    std::mutex pool_mutex;
+    std::condition_variable pool_cv;
+    std::condition_variable pool_done_cv;
+    TickJob current_job;
+    uint64_t job_id;
+    size_t pool_pending;
+    bool pool_stop;
+
+    // Background ticking thread
+    std::thread sampling_thread;
+    std::atomic<bool> sampling_running;
+    std::condition_variable sampling_cv;
+
+    std::chrono::steady_clock::time_point last_device_file_update;
+    static constexpr std::chrono::milliseconds DEVICE_FILE_INTERVAL{100};
+    static constexpr std::chrono::milliseconds MIN_WAKE_INTERVAL{1};
+    static constexpr size_t SLICE_ALIGNMENT = 64;   // Sensors; keeps slices on whole cache lines
+
+    // Helper methods
+    template <FilterType Filter>
+    static size_t runSlice(const TickJob& job, size_t begin, size_t end);
+    static size_t runFiltered(const TickJob& job, size_t begin, size_t end);
+    void samplingLoop();
+    void workerLoop(size_t slice, uint64_t seen);
+    void startWorkersLocked();
+    void stopWorkers();
+    size_t advanceLocked(size_t ticks, std::chrono::steady_clock::time_point first_time,
+                         std::chrono::nanoseconds interval);
+    size_t runJobLocked(size_t ticks);
+    void rebuildModelLocked();
+    void resetFilterLocked();
+    void resetStatisticsLocked();
+    void resetHistoryLocked();
+    bool validSensor(size_t sensor) const;
+    std::string formatDeviceData() const;
+
+public:
+    SensorArray(const std::string& name, SensorType type, size_t count, const Config& cfg = defaultConfig());
+    ~SensorArray();
+
+    SensorArray(const SensorArray&) = delete;
+    SensorArray& operator=(const SensorArray&) = delete;
+
+    static Config defaultConfig();
+
+    // Inherited from Peripheral
+    bool initialize() override;
+    bool cleanup() override;
+    std::string getStatus() const override;
+
+    size_t getSensorCount() const { return sensor_count; }
+    SensorType getSensorType() const { return sensor_type; }
+    int getADCResolution() const { return config.adc_resolution; }
+    size_t getHistorySize() const { return config.history; }
+    size_t getThreadCount() const;
+
+    // Ticks per second while sampling
+    bool setSamplingRate(int hz);
+    int getSamplingRate() const { return sampling_rate_hz.load(); }
+
+    // Filtering (same filter for every sensor; resets the filter state)
+    bool setFilter(FilterType type, int window_size = 5);
+    FilterType getFilterType() const;
+
+    // Calibration: calibrated = (raw + offset) * scale
+    bool setCalibration(size_t sensor, float offset, float scale);
+    bool setCalibration(const std::vector<float>& offsets, const std::vector<float>& scales);
+    float getCalibrationOffset(size_t sensor) const;
+    float getCalibrationScale(size_t sensor) const;
+
+    // Thresholds for one sensor, or the same band for all
+    bool setThresholds(size_t sensor, float low, float high);
+    bool setThresholds(float low, float high);
+    float getLowThreshold(size_t sensor) const;
+    float getHighThreshold(size_t sensor) const;
+
+    // One alert per batch of ticks with crossings; the callback gets the crossing count
+    bool enableAlerts(AlertCallback callback, std::chrono::milliseconds min_interval = std::chrono::milliseconds(1000));
+    bool disableAlerts();
+    bool areAlertsEnabled() const { return alerts_enabled.load(); }
+    bool setAlertDispatcher(std::shared_ptr<AlertDispatcher> dispatcher);
+
+    // Background ticking at the sampling rate
+    bool startSampling();
+    bool stopSampling();
+    bool isSampling() const { return sampling_enabled.load(); }
+
+    // Manual stepping (not while sampling); returns the number of threshold crossings
+    size_t advance(size_t ticks = 1);
+
+    // Data access
+    SensorView view(size_t sensor) const { return SensorView(*this, sensor); }
+    bool readLatestSample(size_t sensor, SensorData& data) const;
+    std::vector<SensorData> readBuffer(size_t sensor, size_t num_samples = 0) const; // 0 = all
+    Statistics getStatistics(size_t sensor) const;   // Percentiles are not tracked (NaN)
+    size_t readExceeded(std::vector<size_t>& sensors) const;  // Outside thresholds on the latest tick
+    uint64_t getTickCount() const;
+    uint64_t getThresholdCrossings() const;
+    bool resetStatistics();
+    bool clearBuffer();
+};
+
+#endif // SENSOR_ARRAY_H
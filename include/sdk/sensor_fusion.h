@@ -0,0 +1,173 @@
+#ifndef SENSOR_FUSION_H
+#define SENSOR_FUSION_H
+
+#include "sdk/peripheral.h"
+#include "sdk/sensor.h"
+#include "common/sample_stream.h"
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Timestamp-Aligned Sensor Fusion (derived sensor)
+ *
+ * Correlates several sample streams and publishes fused results:
+ * - Inputs are Sensor streams (via subscribe) or manually pushed samples
+ * - Every sample of the reference input produces one aligned vector; the
+ *   other inputs are resampled at its timestamp (zero-order hold, linear
+ *   or nearest-neighbour interpolation)
+ * - Complementary and scalar Kalman filters run over the aligned vectors
+ * - Results are published as FusedFrame batches and, per filter output,
+ *   as ordinary Sensor::SensorData streams
+ *
+ * All buffers are sized at configuration time; the per-sample path does
+ * not allocate.
+ */
+class SensorFusion : public Peripheral {
+public:
+    static constexpr size_t MAX_INPUTS = 8;
+    static constexpr size_t MAX_OUTPUTS = 8;
+
+    enum class Interpolation {
+        ZERO_ORDER_HOLD, // Latest sample at or before the reference time
+        LINEAR,          // Linear between the bracketing samples
+        NEAREST          // Closest sample in time
+    };
+
+    struct FusedFrame {
+        std::chrono::steady_clock::time_point timestamp; // Reference sample time
+        float inputs[MAX_INPUTS];    // Aligned input values
+        float outputs[MAX_OUTPUTS];  // Filter outputs
+        uint32_t valid_mask;         // Bit per input that had data to align
+    };
+
+    struct Statistics {
+        size_t samples_received;
+        size_t frames_fused;
+        size_t extrapolated;   // Inputs held past their newest sample (max skew expired)
+        size_t overruns;       // Samples lost because an input history wrapped
+    };
+
+    using FrameStreamType = SampleStream<FusedFrame>;
+    using SubscriberId = FrameStreamType::SubscriberId;
+    using FrameBatchCallback = FrameStreamType::Callback;
+
+private:
+    struct TimedValue {
+        int64_t timestamp_ns;
+        float value;
+    };
+
+    // Per-input history ring (power-of-two capacity)
+    struct Input {
+        std::string label;
+        Sensor* sensor;                  // nullptr for pushed inputs
+        Sensor::SubscriberId subscription;
+        std::vector<TimedValue> history;
+        uint64_t mask;
+        uint64_t written;                // Samples ever stored
+        uint64_t seek;                   // Newest sample at or before the last aligned time
+    };
+
+    enum class FilterKind { COMPLEMENTARY, KALMAN };
+
+    struct Filter {
+        FilterKind kind;
+        // Complementary
+        size_t rate_input;
+        size_t absolute_input;
+        float alpha;
+        bool integrate_rate;
+        float previous_fast;
+        // Kalman
+        uint32_t measurement_mask;
+        float process_noise;
+        std::array<float, MAX_INPUTS> measurement_noise;
+        float covariance;
+        // Shared
+        float state;
+        bool primed;
+    };
+
+    mutable std::mutex fusion_mutex;
+    std::atomic<bool> running;
+
+    size_t history_capacity;
+    std::vector<Input> inputs;
+    size_t reference_input;
+    uint64_t reference_cursor;           // Next reference sample to fuse
+    Interpolation interpolation;
+    int64_t max_skew_ns;
+    int64_t last_frame_ns;
+
+    std::vector<Filter> filters;
+    FusedFrame latest_frame;
+    bool has_frame;
+    Statistics stats;
+
+    std::unique_ptr<FrameStreamType> frame_stream;
+    std::vector<std::unique_ptr<Sensor::SampleStreamType>> output_streams;
+
+    // Helper methods
+    void storeLocked(size_t input, int64_t timestamp_ns, float value);
+    void fuseLocked();
+    bool alignLocked(Input& input, int64_t t, int64_t reference_newest, float& value);
+    void runFiltersLocked(FusedFrame& frame, float dt);
+    int addFilterLocked(const Filter& filter);
+    static int64_t toNanoseconds(std::chrono::steady_clock::time_point tp);
+
+public:
+    SensorFusion(const std::string& name, size_t history_capacity = 1024);
+    ~SensorFusion();
+
+    // Inherited from Peripheral
+    bool initialize() override;
+    bool cleanup() override;
+    std::string getStatus() const override;
+
+    // Inputs (configure while stopped); return the input index or -1
+    int addInput(Sensor& sensor);
+    int addInput(const std::string& label);
+    bool pushSample(size_t input, std::chrono::steady_clock::time_point timestamp, float value);
+
+    bool setReferenceInput(size_t input);
+    bool setInterpolation(Interpolation mode);
+    // How long to wait for late inputs before holding their newest value
+    bool setMaxSkew(std::chrono::microseconds skew);
+
+    // Filters (configure while stopped); return the output index or -1
+    // integrate_rate: rate_input is a derivative (e.g. gyro) integrated over dt;
+    // otherwise its changes are high-passed onto absolute_input
+    int addComplementaryFilter(size_t rate_input, size_t absolute_input, float alpha,
+                               bool integrate_rate = true);
+    // Random-walk state measured by several inputs with their own noise variances
+    int addKalmanFilter(const std::vector<size_t>& measured_inputs, float process_noise,
+                        const std::vector<float>& measurement_noise);
+
+    // Subscribes to all Sensor inputs
+    bool start();
+    bool stop();
+    bool isRunning() const { return running.load(); }
+
+    // Derived sensor outputs
+    SubscriberId subscribe(size_t batch_size, std::chrono::microseconds max_latency,
+                           FrameBatchCallback callback);
+    Sensor::SubscriberId subscribeOutput(size_t output, size_t batch_size,
+                                         std::chrono::microseconds max_latency,
+                                         Sensor::SampleBatchCallback callback);
+    bool unsubscribe(SubscriberId id);
+    bool unsubscribeOutput(size_t output, Sensor::SubscriberId id);
+
+    bool readLatest(FusedFrame& frame) const;
+    size_t getInputCount() const;
+    size_t getOutputCount() const;
+    Statistics getStatistics() const;
+
+    static std::string interpolationToString(Interpolation mode);
+};
+
+#endif // SENSOR_FUSION_H
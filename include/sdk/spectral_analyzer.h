@@ -0,0 +1,133 @@
+#ifndef SPECTRAL_ANALYZER_H
+#define SPECTRAL_ANALYZER_H
+
+#include "sdk/sensor.h"
+#include "common/fft.h"
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @brief Streaming Spectral Analysis Stage
+ *
+ * Frequency-domain features for vibration monitoring:
+ * - Attaches to a Sensor stream (or is fed blocks directly)
+ * - Windowed FFT over overlapping blocks (fft_size samples every hop_size)
+ * - Band power for configurable frequency bands
+ * - Peak frequency with parabolic interpolation between bins, plus a
+ *   smoothed tracked peak
+ *
+ * All buffers are allocated up front; blocks are analysed on the sensor's
+ * stream delivery thread.
+ */
+class SpectralAnalyzer {
+public:
+    static constexpr size_t MAX_BANDS = 16;
+
+    enum class Window {
+        RECTANGULAR,
+        HANN,
+        HAMMING
+    };
+
+    struct Band {
+        float low_hz;
+        float high_hz;  // Exclusive
+    };
+
+    struct Config {
+        size_t fft_size;        // Power of two
+        size_t hop_size;        // New samples per block (fft_size / 2 = 50% overlap)
+        float sample_rate_hz;   // 0 = take the attached sensor's sampling rate
+        Window window;
+        std::vector<Band> bands;
+        float peak_smoothing;   // EMA factor for the tracked peak (1 = no smoothing)
+    };
+
+    struct Features {
+        std::chrono::steady_clock::time_point timestamp; // Newest sample in the block
+        uint64_t block;
+        float rms;                  // Time-domain RMS of the block
+        float peak_frequency_hz;
+        float peak_amplitude;       // Amplitude of the peak component
+        float tracked_frequency_hz;
+        float band_power[MAX_BANDS]; // Signal power (mean square) per band
+        size_t band_count;
+    };
+
+    struct Statistics {
+        size_t samples_processed;
+        size_t blocks_analysed;
+        double last_block_us;       // Processing time of the latest block
+        double max_block_us;
+    };
+
+    using FeatureCallback = std::function<void(const Features& features)>;
+
+private:
+    Config config;
+    FFT fft;
+    mutable std::mutex analyzer_mutex;
+
+    // Sliding input history (circular, fft_size samples)
+    std::vector<float> history;
+    size_t history_pos;
+    size_t history_filled;
+    size_t since_last_block;
+
+    // Work buffers and tables
+    std::vector<float> window_coefficients;
+    std::vector<float> work_re;
+    std::vector<float> work_im;
+    std::vector<float> power_spectrum;   // One-sided, fft_size / 2 + 1 bins
+    std::vector<std::pair<size_t, size_t>> band_bins;
+    float power_scale;
+    float band_scale;
+    float sample_rate;
+
+    Features latest;
+    bool has_features;
+    bool tracking;
+    Statistics stats;
+    FeatureCallback callback;
+
+    Sensor* sensor;
+    Sensor::SubscriberId subscription;
+
+    // Helper methods
+    void configureRateLocked(float rate_hz);
+    bool pushLocked(float value, std::chrono::steady_clock::time_point timestamp);
+    void analyseLocked(std::chrono::steady_clock::time_point timestamp);
+
+public:
+    explicit SpectralAnalyzer(const Config& cfg = defaultConfig());
+    ~SpectralAnalyzer();
+
+    SpectralAnalyzer(const SpectralAnalyzer&) = delete;
+    SpectralAnalyzer& operator=(const SpectralAnalyzer&) = delete;
+
+    static Config defaultConfig();
+
+    // Stream attachment (one sensor at a time)
+    bool attach(Sensor& source);
+    bool detach();
+    bool isAttached() const;
+
+    // Invoked after every analysed block (on the analysing thread)
+    void setCallback(FeatureCallback cb);
+
+    // Direct feed for recorded data; returns the number of blocks analysed
+    size_t process(const float* samples, size_t count, float sample_rate_hz);
+
+    bool readLatest(Features& features) const;
+    bool getSpectrum(std::vector<float>& power) const;
+    float binFrequency(size_t bin) const;
+    Statistics getStatistics() const;
+    void reset();
+
+    static std::string windowToString(Window window);
+};
+
+#endif // SPECTRAL_ANALYZER_H
@@ -0,0 +1,302 @@
+#ifndef STATIC_SENSOR_H
+#define STATIC_SENSOR_H
+
+#include "sdk/sensor.h"
+#include "common/fixed_point.h"
+#include "common/calibration.h"
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <ratio>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Building blocks for compile-time sensor pipelines (see StaticSensor)
+ *
+ * Stages work on Q4 codes like Sensor's filters and reproduce them exactly
+ * (same Q15 arithmetic, seeding and rounding), so a static pipeline and a
+ * dynamic Sensor configured alike produce the same filtered codes. Stages
+ * provide apply(), reset() and REMOVES_DC (output is a deviation, not a code).
+ */
+namespace pipeline {
+
+// ADC range per sensor type (matches Sensor::getADCRange)
+template <Sensor::SensorType Type> struct SensorTraits;
+template <> struct SensorTraits<Sensor::SensorType::TEMPERATURE> { static constexpr float MIN = -40.0f; static constexpr float MAX = 85.0f; };
+template <> struct SensorTraits<Sensor::SensorType::PRESSURE> { static constexpr float MIN = 0.0f; static constexpr float MAX = 1200.0f; };
+template <> struct SensorTraits<Sensor::SensorType::HUMIDITY> { static constexpr float MIN = 0.0f; static constexpr float MAX = 100.0f; };
+template <> struct SensorTraits<Sensor::SensorType::ACCELEROMETER> { static constexpr float MIN = -2.0f; static constexpr float MAX = 2.0f; };
+template <> struct SensorTraits<Sensor::SensorType::LIGHT> { static constexpr float MIN = 0.0f; static constexpr float MAX = 65535.0f; };
+template <> struct SensorTraits<Sensor::SensorType::VOLTAGE> { static constexpr float MIN = 0.0f; static constexpr float MAX = 3.6f; };
+
+// Fixed-point ADC model, folded at compile time
+template <Sensor::SensorType Type, int Bits>
+struct AdcModel {
+    static_assert(Bits >= 8 && Bits <= 16, "ADC resolution must be between 8-16 bits");
+
+    static constexpr float MIN = SensorTraits<Type>::MIN;
+    static constexpr float MAX = SensorTraits<Type>::MAX;
+    static constexpr uint16_t MAX_CODE = static_cast<uint16_t>((1u << Bits) - 1);
+    static constexpr float LSB = (MAX - MIN) / static_cast<float>(MAX_CODE);
+    static constexpr float INV_LSB = 1.0f / LSB;
+
+    static uint16_t quantize(float value) { return fixedpoint::quantize(value, MIN, INV_LSB, MAX_CODE); }
+    static constexpr float dequantize(uint16_t code) { return MIN + static_cast<float>(code) * LSB; }
+};
+
+// Exponential moving average, seeded with the first sample
+template <int32_t AlphaQ15 = 3277>
+class LowPass {
+    static_assert(AlphaQ15 > 0 && AlphaQ15 <= 32768, "Alpha must be in (0, 1] (Q15)");
+
+    int32_t output = 0;
+    bool primed = false;
+
+public:
+    static constexpr bool REMOVES_DC = false;
+
+    int32_t apply(int32_t value) {
+        output = primed ? fixedpoint::lowPassQ15(output, value, AlphaQ15) : value;
+        primed = true;
+        return output;
+    }
+    void reset() { output = 0; primed = false; }
+};
+
+// First-order high-pass; the first sample only primes the input history
+template <int32_t AlphaQ15 = 29491>
+class HighPass {
+    static_assert(AlphaQ15 > 0 && AlphaQ15 <= 32768, "Alpha must be in (0, 1] (Q15)");
+
+    int32_t output = 0;
+    int32_t previous_input = 0;
+    bool primed = false;
+
+public:
+    static constexpr bool REMOVES_DC = true;
+
+    int32_t apply(int32_t value) {
+        if (!primed) {
+            previous_input = value;
+            output = 0;
+            primed = true;
+        }
+        output = fixedpoint::highPassQ15(output, value, previous_input, AlphaQ15);
+        previous_input = value;
+        return output;
+    }
+    void reset() { output = 0; previous_input = 0; primed = false; }
+};
+
+// Moving average over the last Window samples (fewer until the window fills)
+template <size_t Window = 5>
+class MovingAverage {
+    static_assert(Window >= 1 && Window <= 100, "Window size must be between 1-100");
+
+    std::array<int32_t, Window> window{};
+    size_t position = 0;
+    size_t filled = 0;
+    int64_t sum = 0;
+
+public:
+    static constexpr bool REMOVES_DC = false;
+
+    int32_t apply(int32_t value) {
+        sum += value - window[position];
+        window[position] = value;
+        position = (position + 1 == Window) ? 0 : position + 1;
+        filled = (filled < Window) ? filled + 1 : Window;
+        int64_t count = static_cast<int64_t>(filled);
+        return static_cast<int32_t>((sum + count / 2) / count);
+    }
+    void reset() { window.fill(0); position = 0; filled = 0; sum = 0; }
+};
+
+// Stages applied in order; an empty chain passes codes through
+template <typename... Stages>
+class Chain {
+    std::tuple<Stages...> stages;
+
+public:
+    static constexpr bool REMOVES_DC = (false || ... || Stages::REMOVES_DC);
+
+    int32_t apply(int32_t value) {
+        std::apply([&value](Stages&... stage) { ((value = stage.apply(value)), ...); }, stages);
+        return value;
+    }
+    void reset() {
+        std::apply([](Stages&... stage) { (stage.reset(), ...); }, stages);
+    }
+};
+
+/**
+ * Calibrations map the filtered Q4 code to the calibrated value. apply<Adc, AC>()
+ * gets the ADC model and whether the input is a deviation (chain removes DC);
+ * makeCalibration() gives the equivalent runtime curve for reporting.
+ */
+
+// calibrated = (x + Offset) * Scale, folded into one constexpr gain and bias on Q4 codes
+template <typename Offset = std::ratio<0>, typename Scale = std::ratio<1>>
+struct LinearCalibration {
+    static_assert(Scale::num != 0, "Calibration scale cannot be zero");
+
+    static constexpr double OFFSET = static_cast<double>(Offset::num) / static_cast<double>(Offset::den);
+    static constexpr double SCALE = static_cast<double>(Scale::num) / static_cast<double>(Scale::den);
+
+    template <typename Adc, bool AC>
+    static float apply(int32_t filtered_q4) {
+        constexpr float gain = static_cast<float>(static_cast<double>(Adc::LSB) * SCALE / (1 << fixedpoint::FRACTION_BITS));
+        constexpr float bias = static_cast<float>(((AC ? 0.0 : static_cast<double>(Adc::MIN)) + OFFSET) * SCALE);
+        return static_cast<float>(filtered_q4) * gain + bias;
+    }
+
+    static std::shared_ptr<const Calibration> makeCalibration() {
+        return Calibration::linear(static_cast<float>(OFFSET), static_cast<float>(SCALE));
+    }
+};
+
+using Identity = LinearCalibration<>;
+
+// calibrated = c0 + c1 x + ... + cN x^N on the physical input (Horner, constexpr coefficients)
+template <typename... Coefficients>
+struct PolynomialCalibration {
+    static_assert(sizeof...(Coefficients) >= 1 && sizeof...(Coefficients) <= Calibration::MAX_POLYNOMIAL_ORDER + 1,
+                  "Polynomial needs 1-16 coefficients");
+
+    static constexpr std::array<float, sizeof...(Coefficients)> COEFFICIENTS{
+        static_cast<float>(static_cast<double>(Coefficients::num) / static_cast<double>(Coefficients::den))...};
+
+    template <typename Adc, bool AC>
+    static float apply(int32_t filtered_q4) {
+        constexpr float step = Adc::LSB / (1 << fixedpoint::FRACTION_BITS);
+        float x = (AC ? 0.0f : Adc::MIN) + static_cast<float>(filtered_q4) * step;
+        float y = COEFFICIENTS[COEFFICIENTS.size() - 1];
+        for (size_t i = COEFFICIENTS.size() - 1; i > 0; --i) {
+            y = y * x + COEFFICIENTS[i - 1];
+        }
+        return y;
+    }
+
+    static std::shared_ptr<const Calibration> makeCalibration() {
+        return Calibration::polynomial(std::vector<float>(COEFFICIENTS.begin(), COEFFICIENTS.end()));
+    }
+};
+
+} // namespace pipeline
+
+/**
+ * @brief Sensor whose conversion pipeline is fixed at compile time
+ *
+ * Type, ADC resolution, filter chain and calibration are template
+ * parameters, so the per-sample path is quantize -> stages -> calibration
+ * with constexpr coefficients and no runtime dispatch, locks or shared
+ * state; the compiler inlines the whole chain. Converted samples are
+ * committed to an embedded Sensor (sensor()), which provides the ring
+ * buffer, statistics, history log, subscribers and alerts exactly as for
+ * sampled data. Calibrated values differ from a dynamic Sensor with the
+ * same configuration only by float rounding (linear curves) or the
+ * dynamic table interpolation (polynomials).
+ *
+ * The pipeline is driven by the caller (step()/process()); the filter
+ * state is not locked, so feed each StaticSensor from one thread. Commits
+ * fail while the embedded Sensor is sampling.
+ *
+ *     using Probe = StaticSensor<Sensor::SensorType::TEMPERATURE,
+ *                                pipeline::Chain<pipeline::MovingAverage<8>>,
+ *                                pipeline::LinearCalibration<std::ratio<-1, 2>, std::ratio<101, 100>>>;
+ */
+template <Sensor::SensorType Type,
+          typename FilterChain = pipeline::Chain<>,
+          typename Curve = pipeline::Identity,
+          int AdcBits = 12>
+class StaticSensor {
+public:
+    using SensorData = Sensor::SensorData;
+    using Adc = pipeline::AdcModel<Type, AdcBits>;
+
+    static constexpr size_t BATCH_SIZE = 256;   // Samples committed per lock in process()
+
+private:
+    Sensor sink;
+    FilterChain filters;
+    std::vector<SensorData> batch;
+
+public:
+    explicit StaticSensor(const std::string& name)
+        : sink(name, Type),
+          filters(),
+          batch(BATCH_SIZE) {
+        // Mirror the compiled configuration so getters and status report it
+        sink.setADCResolution(AdcBits);
+        sink.setCalibration(Curve::makeCalibration());
+    }
+
+    StaticSensor(const StaticSensor&) = delete;
+    StaticSensor& operator=(const StaticSensor&) = delete;
+
+    bool initialize() {
+        filters.reset();
+        return sink.initialize();
+    }
+
+    bool cleanup() { return sink.cleanup(); }
+
+    // Ring buffer, statistics, alerts and subscriptions
+    Sensor& sensor() { return sink; }
+    const Sensor& sensor() const { return sink; }
+
+    // Run one input through the pipeline without storing it
+    SensorData convert(float raw_value, std::chrono::steady_clock::time_point timestamp) {
+        SensorData sample;
+        uint16_t code = Adc::quantize(raw_value);
+        int32_t filtered = filters.apply(static_cast<int32_t>(code) << fixedpoint::FRACTION_BITS);
+        sample.timestamp = timestamp;
+        sample.raw_value = Adc::dequantize(code);
+        sample.calibrated_value = Curve::template apply<Adc, FilterChain::REMOVES_DC>(filtered);
+        sample.threshold_exceeded = false;  // Set on commit
+        sample.adc_code = code;
+        return sample;
+    }
+
+    // Convert and commit one input
+    bool step(float raw_value, std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now()) {
+        SensorData sample = convert(raw_value, timestamp);
+        return sink.commitSamples(&sample, 1) == 1;
+    }
+
+    // Convert and commit count inputs sampled every interval from first_time;
+    // returns the number of samples stored
+    size_t process(const float* raw_values, size_t count,
+                   std::chrono::steady_clock::time_point first_time,
+                   std::chrono::nanoseconds interval) {
+        size_t stored = 0;
+        for (size_t begin = 0; begin < count; begin += BATCH_SIZE) {
+            size_t n = std::min(BATCH_SIZE, count - begin);
+            for (size_t i = 0; i < n; ++i) {
+                auto offset = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    interval * static_cast<int64_t>(begin + i));
+                batch[i] = convert(raw_values[begin + i], first_time + offset);
+            }
+            size_t committed = sink.commitSamples(batch.data(), n);
+            stored += committed;
+            if (committed != n) {
+                break;
+            }
+        }
+        return stored;
+    }
+
+    // Restart the filters (e.g. after a gap in the input)
+    void resetFilters() { filters.reset(); }
+
+    static constexpr Sensor::SensorType getSensorType() { return Type; }
+    static constexpr int getADCResolution() { return AdcBits; }
+    static constexpr bool removesDC() { return FilterChain::REMOVES_DC; }
+};
+
+#endif // STATIC_SENSOR_H
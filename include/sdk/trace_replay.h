@@ -0,0 +1,129 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Recorded Trace Replay Source
+ *
+ * Streams recorded field captures through the Sensor pipeline instead of
+ * synthetic noise:
+ * - Memory-mapped input, nothing is loaded or copied up front
+ * - Binary traces are read zero-copy straight from the mapping
+ * - CSV traces ("time_s,value" per line, optional header) are parsed lazily
+ * - Rate scaling: 1.0 = real time, 10.0 = 10x, 0 = as fast as possible
+ * - Optional looping with monotonically increasing timestamps
+ *
+ * Binary layout: [TraceHeader][TraceRecord]...[TraceRecord]
+ */
+class TraceReplaySource {
+public:
+    enum class Format {
+        AUTO,   // Detect from file contents
+        BINARY, // Packed TraceRecord array
+        CSV     // Text, one "time_s,value" sample per line
+    };
+
+    struct Sample {
+        int64_t timestamp_ns; // Trace time
+        float value;
+    };
+
+    // On-disk binary format
+    struct TraceHeader {
+        char magic[4];          // "ESTR"
+        uint32_t version;
+        uint64_t sample_count;
+        uint64_t reserved;
+    };
+
+    struct TraceRecord {
+        int64_t timestamp_ns;
+        float value;
+        uint32_t flags;         // Reserved, written as 0
+    };
+
+private:
+    std::string file_path;
+    Format format;
+    mutable std::mutex replay_mutex;
+
+    // Memory mapping
+    int fd;
+    const uint8_t* mapping;
+    size_t mapping_size;
+
+    // Binary view (points into the mapping)
+    const TraceRecord* records;
+    size_t record_count;
+
+    // CSV cursor (points into the mapping)
+    const char* csv_begin;
+    const char* csv_cursor;
+    const char* csv_end;
+
+    size_t binary_cursor;
+
+    // Playback control
+    double rate_scale;
+    bool looping;
+    int64_t first_timestamp;
+    int64_t loop_period_ns;    // Added to timestamps on each loop pass
+    int64_t loop_offset_ns;
+    size_t loops_completed;
+    size_t samples_replayed;
+    int64_t anchor_timestamp;  // Trace time that maps to playback_start
+    bool playback_anchored;
+    std::chrono::steady_clock::time_point playback_start;
+
+    // Helper methods
+    Format detectFormat() const;
+    bool prepareBinary();
+    bool prepareCsv();
+    bool parseCsvLine(const char*& cursor, Sample& sample) const;
+    bool readRaw(Sample& sample);
+    void restart();
+
+public:
+    TraceReplaySource(const std::string& path, Format fmt = Format::AUTO);
+    ~TraceReplaySource();
+
+    TraceReplaySource(const TraceReplaySource&) = delete;
+    TraceReplaySource& operator=(const TraceReplaySource&) = delete;
+
+    bool open();
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+
+    // Playback configuration
+    bool setRateScale(double scale);
+    double getRateScale() const;
+    bool setLooping(bool enable);   // False for a trace that spans no time (fewer than 2 timestamps)
+    bool isLooping() const;
+
+    // Streaming access; returns false at the end of a non-looping trace
+    bool next(Sample& sample);
+    void rewind();
+
+    // Wall time at which a sample is due for the current rate scale
+    std::chrono::steady_clock::time_point dueTime(const Sample& sample) const;
+
+    Format getFormat() const { return format; }
+    size_t getSampleCount() const;
+    size_t getSamplesReplayed() const;
+    size_t getLoopsCompleted() const;
+
+    // Zero-copy access to a binary trace (nullptr for CSV traces)
+    const TraceRecord* getRecords() const { return records; }
+
+    // Converts captured samples into the binary trace format
+    static bool writeBinaryTrace(const std::string& path, const std::vector<Sample>& samples);
+    static std::string formatToString(Format format);
+};
+
+#endif // TRACE_REPLAY_H
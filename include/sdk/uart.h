@@ -2,13 +2,18 @@
 #define UART_H
 
 #include "sdk/peripheral.h"
+#include "common/byte_ring.h"
+#include "common/span.h"
 #include <mutex>
 #include <atomic>
-#include <queue>
 #include <thread>
 #include <condition_variable>
 #include <chrono>
 #include <functional>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <memory>
 
 /**
  * @brief UART Peripheral Class
@@ -16,11 +21,35 @@
  * Simulates a real UART peripheral with embedded systems features:
  * - Configurable baud rates, data bits, parity, stop bits
  * - Hardware flow control (RTS/CTS) simulation
- * - Interrupt-driven TX/RX with FIFOs
+ * - Interrupt-driven TX/RX with lock-free FIFOs (SPSC byte rings moved
+ *   in bulk; the application side and the line threads never share a lock)
+ * - Virtual-time line model: a line clock advances one frame per byte at
+ *   the configured baud rate and the TX thread drains whatever line time
+ *   has accrued in one burst, so throughput matches the baud rate exactly
+ *   regardless of sleep granularity; every byte gets the exact time its
+ *   stop bit ends (RX arrival time in loopback). UNTHROTTLED timing drains
+ *   as fast as possible with the line clock running ahead of real time.
  * - Error detection (framing, parity, overrun)
- * - RS-232 and RS-485 mode simulation
- * - Loop-back testing mode
- * - DMA simulation for high-speed transfers
+ * - RS-232 and RS-485 mode simulation (in RS-485 modes RTS follows the
+ *   driver enable while transmitting; see rs485_bus.h for the bus)
+ * - Loop-back testing mode; otherwise the TX line drives an attached line
+ *   sink (null-modem peer, pseudo-terminal bridge, bus) with whole bursts
+ *   of stamped bytes, and receiveFromLine() is the RX input for whatever
+ *   drives this UART's RX pin (see uart_link.h)
+ * - Batched RX delivery: one callback per message (FIFO threshold, idle
+ *   line or delimiter), called from the RX thread with a view into the
+ *   RX FIFO instead of a thread and a vector per byte; idle-line deadlines
+ *   of all UARTs share one timer thread, so a pause on a bus wakes each
+ *   receiver once rather than twice
+ * - DMA block transfers: TX drains a caller buffer through the line model
+ *   once the FIFO is empty, RX fills a caller buffer (one-shot or circular)
+ *   ahead of the FIFO; half/full-transfer and idle-line events are reported
+ *   from the line threads like DMA interrupts
+ *
+ * FIFO access is single-producer/single-consumer: one application thread
+ * may transmit and one may receive at a time. FIFO flushes are safe from
+ * any thread. Do not call transmit/receive concurrently with initialize(),
+ * cleanup() or a configure() that resizes the FIFOs.
  */
 class UART : public Peripheral {
 public:
@@ -70,6 +99,11 @@ public:
         LOOPBACK
     };
     
+    enum class LineTiming {
+        BAUD_RATE,    // Bytes leave the TX FIFO at the configured baud rate
+        UNTHROTTLED   // No pacing (throughput tests); timestamps still advance per frame
+    };
+    
     struct UARTConfig {
         BaudRate baud_rate;
         DataBits data_bits;
@@ -80,6 +114,7 @@ public:
         size_t tx_fifo_size;
         size_t rx_fifo_size;
         bool enable_dma;
+        size_t tx_error_interval;  // Simulated TX errors: drop every Nth byte sent (0 = off)
     };
     
     struct UARTStatus {
@@ -95,32 +130,101 @@ public:
         bool rts_state;
     };
     
+    enum class DMAEvent {
+        HALF_TRANSFER,      // First half of the buffer transferred
+        TRANSFER_COMPLETE,  // Whole buffer transferred (circular RX wraps and continues)
+        IDLE_LINE,          // RX: line idle for one frame after the last received byte
+        ABORTED             // Stopped before completion
+    };
+    
+    // When buffered RX bytes are handed to the delivery callback
+    struct RxDeliveryConfig {
+        size_t threshold;                        // Bytes buffered (0 = half the RX FIFO)
+        std::chrono::microseconds idle_timeout;  // Line idle after the last byte (0 = one frame)
+        int delimiter;                           // Deliver each message ending in this byte (-1 = none)
+    };
+    
     // Callback function types
+    using DataSpanCallback = std::function<void(const RingSpan<const uint8_t>& data)>;  // View valid during the call
     using DataReceivedCallback = std::function<void(const std::vector<uint8_t>& data)>;
     using ErrorCallback = std::function<void(const std::string& error_type, const std::string& description)>;
     using StatusChangeCallback = std::function<void(const UARTStatus& status)>;
+    // position = bytes transferred into/out of the buffer (circular RX: write offset).
+    // Runs on a line thread: keep it short; starting the next transfer from it is allowed.
+    using DMACallback = std::function<void(DMAEvent event, size_t position)>;
+    
+    // Far end of the TX line. Called from the TX thread: receive() with each
+    // burst (stop_times[i] = end of byte i's stop bit, never in the future in
+    // BAUD_RATE timing), idle() once the stream pauses after the last burst.
+    struct LineSink {
+        std::function<void(Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times)> receive;
+        std::function<void(std::chrono::steady_clock::time_point last_stop)> idle;
+    };
     
 private:
     UARTConfig config;
     UARTStatus status;
     mutable std::mutex uart_mutex;
     
-    // FIFOs for TX and RX
-    std::queue<uint8_t> tx_fifo;
-    std::queue<uint8_t> rx_fifo;
+    // FIFOs for TX (application -> line thread) and RX (line thread -> application)
+    SpscByteRing tx_fifo;
+    SpscByteRing rx_fifo;
+    // Arrival time per RX byte, kept at the byte's FIFO position (slot
+    // position & rx_times_mask) and written before the byte is published, so
+    // a byte and its time cannot drift apart, however the FIFO is flushed
+    std::unique_ptr<std::chrono::steady_clock::time_point[]> rx_times;
+    size_t rx_times_mask;
     std::atomic<size_t> tx_fifo_size;
     std::atomic<size_t> rx_fifo_size;
     
-    // Threading for interrupt simulation
+    // Threading for interrupt simulation. The line threads sleep on wait_mutex
+    // only when idle; producers take it just to wake an idle thread.
     std::thread tx_thread;
     std::thread rx_thread;
     std::atomic<bool> tx_running;
     std::atomic<bool> rx_running;
+    std::atomic<bool> tx_idle;
+    std::atomic<int> tx_space_waiters;   // Writers blocked on a full TX FIFO
+    std::mutex wait_mutex;
     std::condition_variable tx_cv;
+    std::condition_variable tx_space_cv;
+    std::atomic<LineTiming> line_timing;
+    mutable std::mutex line_mutex;       // Held by the TX thread while it drives line_sink
+    LineSink line_sink;
+    
+    // Virtual line clock: half bit k ends at epoch + k / half_bit_rate
+    struct LineClock {
+        int64_t epoch_ns;           // steady_clock nanoseconds
+        uint64_t position;          // Half bits sent since epoch
+        uint64_t half_bit_rate;     // 2 * baud
+        uint32_t frame_half_bits;
+        
+        int64_t timeAt(uint64_t half_bits) const {
+            return epoch_ns + static_cast<int64_t>(static_cast<__int128>(half_bits) * 1000000000 / half_bit_rate);
+        }
+        uint64_t positionAt(int64_t ns) const {
+            return ns <= epoch_ns ? 0 : static_cast<uint64_t>(static_cast<__int128>(ns - epoch_ns) * half_bit_rate / 1000000000);
+        }
+    };
     std::condition_variable rx_cv;
     
-    // Callbacks
-    DataReceivedCallback data_received_callback;
+    // Line reader (readUntil) waiting for its delimiter or a byte count
+    std::condition_variable rx_line_cv;
+    std::atomic<int> rx_wait_delimiter;    // -1 = no reader waiting
+    std::atomic<size_t> rx_wait_bytes;
+    std::atomic<bool> rx_line_ready;
+    
+    // Callbacks. The RX delivery callback is swapped with std::atomic_store
+    // and read lock-free by the line threads; rx_delivering marks a delivery
+    // in flight so clearing or replacing the callback can wait it out.
+    std::shared_ptr<const DataSpanCallback> rx_delivery;
+    std::atomic<bool> rx_delivering;
+    std::atomic<int> rx_delivery_waiters;
+    std::condition_variable rx_delivery_cv;
+    std::atomic<size_t> rx_threshold;
+    std::atomic<int64_t> rx_idle_timeout_ns;
+    std::atomic<int> rx_delimiter;
+    std::atomic<bool> rx_batch_ready;
     ErrorCallback error_callback;
     StatusChangeCallback status_change_callback;
     
@@ -135,12 +239,48 @@ private:
     std::atomic<size_t> transmission_errors;
     std::atomic<size_t> reception_errors;
     
-    // DMA simulation
+    // DMA channels; the buffers belong to the caller until TRANSFER_COMPLETE/ABORTED
+    struct DMATransfer {
+        size_t length;
+        size_t position;
+        bool circular;
+        bool half_reported;
+        DMACallback callback;
+    };
     std::atomic<bool> dma_tx_active;
     std::atomic<bool> dma_rx_active;
+    std::mutex dma_mutex;
+    const uint8_t* dma_tx_buffer;
+    uint8_t* dma_rx_buffer;
+    DMATransfer dma_tx;
+    DMATransfer dma_rx;
+    std::vector<std::pair<DMAEvent, size_t>> dma_rx_events;  // Line thread scratch
+    std::atomic<int64_t> rx_idle_deadline_ns;                 // 0 = no idle event pending
+    class IdleTimer;                                          // Wakes RX threads at their idle deadlines
+    std::atomic<int64_t> rx_idle_late_ns;                     // Expired deadline overtaken by new traffic (0 = none)
+    
+    static constexpr size_t MAX_FIFO_SIZE = 1 << 20;
+    static constexpr size_t MAX_TX_BURST = 256;   // Most bytes shifted out per TX thread wakeup
+    static constexpr std::chrono::milliseconds MIN_WAKE_INTERVAL{1};  // TX batches this much line time
     
     // Internal helper methods
     std::string formatDeviceData() const;
+    void startLineThreads();
+    void stopLineThreads();
+    void wakeTransmitter();
+    void wakeWriters();
+    size_t popReceived(uint8_t* data, size_t count, std::chrono::steady_clock::time_point* arrival_times);
+    size_t pullTxDMA(uint8_t* out, size_t count);
+    size_t deliverReceived(const uint8_t* data, const std::chrono::steady_clock::time_point* times, size_t count);
+    void abortDMA(bool tx, bool rx);
+    void driveLine(Mode mode, Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times);
+    void driveLineIdle(Mode mode, std::chrono::steady_clock::time_point last_stop);
+    void signalRxBatch(const uint8_t* data, size_t count);
+    void signalLineReader(const uint8_t* data, size_t count);
+    void dispatchReceived(bool flush, int64_t idle_at_ns = 0);  // Flush only bytes received before idle_at (0 = all)
+    void finishDispatch();
+    void resizeRxTimes(size_t capacity);   // Before the RX FIFO is resized, with the line threads parked
+    void waitForDelivery();
     void transmissionLoop();
     void receptionLoop();
     bool calculateParity(uint8_t data) const;
@@ -148,6 +288,7 @@ private:
     void updateStatus();
     void triggerErrorCallback(const std::string& error_type, const std::string& description);
     uint32_t calculateTransmissionTime(size_t bytes) const; // in microseconds
+    static uint32_t frameHalfBits(const UARTConfig& line);  // Start + data + parity + stop, in half bits
     
     // Simulation methods
     void simulateRS485Direction(bool transmit);
@@ -170,19 +311,69 @@ public:
     bool setDataFormat(DataBits data, Parity parity, StopBits stop);
     bool setFlowControl(FlowControl flow);
     bool setMode(Mode mode);
-    bool enableDMA(bool enable);
-    
-    // Data transmission
+    bool enableDMA(bool enable);  // Disabling aborts active transfers
+    bool setLineTiming(LineTiming timing);
+    LineTiming getLineTiming() const { return line_timing.load(); }
+    
+    // Bulk transmit (POSIX write-like): queues as much as fits in one FIFO
+    // operation; with a timeout, waits for the line to free space until all
+    // bytes are queued or the timeout expires. Returns the bytes queued.
+    static constexpr std::chrono::milliseconds WAIT_FOREVER = std::chrono::milliseconds::max();
+    size_t write(Span<const uint8_t> data, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+    size_t write(std::string_view text, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+    
+    // Data transmission (all or nothing is not guaranteed: false after a partial write)
     bool transmit(uint8_t byte);
     bool transmit(const std::vector<uint8_t>& data);
     bool transmit(const std::string& text);
     
+    // DMA transfers (require enableDMA(true)); one transfer per direction at a time
+    bool startTxDMA(Span<const uint8_t> buffer, DMACallback callback);
+    bool startRxDMA(Span<uint8_t> buffer, bool circular, DMACallback callback);
+    bool stopTxDMA();
+    bool stopRxDMA();
+    bool isTxDMAActive() const { return dma_tx_active.load(); }
+    bool isRxDMAActive() const { return dma_rx_active.load(); }
+    
     // Data reception
     bool receive(uint8_t& byte);
     std::vector<uint8_t> receive(size_t max_bytes = 0); // 0 = all available
     std::string receiveString(size_t max_chars = 0);
-    
-    // FIFO control
+    // Bulk receive into caller memory; optionally the arrival time of each byte
+    size_t read(Span<uint8_t> data, std::chrono::steady_clock::time_point* arrival_times = nullptr);
+    
+    // Delimited reads for line protocols (AT commands, NMEA), without an RX
+    // delivery callback and from one reader thread. readUntil waits up to
+    // timeout for a message ending in delimiter, or max_bytes without one
+    // (0 = the RX FIFO size), and returns it in place, delimiter included:
+    // a view of one or two FIFO segments, empty on timeout. The view stays
+    // valid until consumeReceived() releases it. Nothing is allocated.
+    RingSpan<const uint8_t> readUntil(uint8_t delimiter, size_t max_bytes = 0,
+                                      std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+    bool consumeReceived(size_t count);   // False if clearRxFifo() dropped the bytes: the view may be torn
+    // Copying form: one line into line (truncated to its size), returns its length
+    size_t readLine(Span<uint8_t> line, std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                    uint8_t delimiter = '\n');
+    
+    // Line connection (outside LOOPBACK mode). detachLine() returns once the
+    // TX thread has stopped using the old sink, so its target may be destroyed.
+    bool attachLine(LineSink sink);
+    bool detachLine();
+    bool isLineAttached() const;
+    
+    // RX pin input for whatever drives this UART's line: one producer at a
+    // time, and not while the UART is in LOOPBACK mode. stop_times has one
+    // entry per byte. Returns the bytes taken (RX DMA and FIFO; the rest overrun).
+    size_t receiveFromLine(Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times);
+    // The remote transmitter paused: the line reads idle one idle timeout
+    // (at least one frame) after last_stop
+    void lineIdle(std::chrono::steady_clock::time_point last_stop);
+    std::chrono::nanoseconds getFrameTime() const;  // One frame at the current baud rate and format
+    
+    // FIFO control. Clearing from another thread is safe for receive()/read(),
+    // which discard bytes flushed under them. A readUntil() view or an RX
+    // delivery callback racing clearRxFifo() may see slots refilled by new
+    // traffic; consumeReceived() then returns false.
     bool clearTxFifo();
     bool clearRxFifo();
     size_t getTxFifoCount() const;
@@ -198,7 +389,7 @@ public:
     bool getCTS() const { return cts_state.load(); }
     
     // Status and errors
-    UARTStatus getUARTStatus() const { return status; }
+    UARTStatus getUARTStatus() const;
     bool hasErrors() const;
     void clearErrors();
     
@@ -215,9 +406,16 @@ public:
     Statistics getStatistics() const;
     void resetStatistics();
     
-    // Callbacks
-    bool setDataReceivedCallback(DataReceivedCallback callback);
-    bool setErrorCallback(ErrorCallback callback);
+    // Callbacks. While an RX delivery callback is set the RX thread consumes
+    // the RX FIFO: read the data in the callback, not with receive().
+    // Clearing or replacing it waits for a delivery already running (unless
+    // called from that callback), so the old callback's captures may then be
+    // destroyed; do not hold a lock the callback takes while doing so.
+    static RxDeliveryConfig defaultRxDelivery();
+    bool setRxDelivery(DataSpanCallback callback, const RxDeliveryConfig& delivery = defaultRxDelivery());
+    bool clearRxDelivery();
+    bool setDataReceivedCallback(DataReceivedCallback callback);  // Copying adapter over setRxDelivery
+    bool setErrorCallback(ErrorCallback callback);  // Runs on the thread that hit the error: keep it short
     bool setStatusChangeCallback(StatusChangeCallback callback);
     
     // Testing and debugging
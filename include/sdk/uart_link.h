@@ -0,0 +1,100 @@
+#ifndef UART_LINK_H
+#define UART_LINK_H
+
+#include "sdk/uart.h"
+#include <atomic>
+#include <thread>
+#include <string>
+#include <chrono>
+
+/**
+ * @brief Null-modem cable between two UARTs
+ *
+ * Each UART's TX line drives the other's RX input: bursts leave the sending
+ * UART's TX thread with their stop-bit timestamps (so the line model, RX
+ * DMA, batched delivery and idle-line detection all apply on the far side)
+ * and are copied straight into the receiver's RX ring, with no thread or
+ * queue of their own. Throughput is set by each sender's baud rate; the two
+ * sides' line settings are not checked against each other beyond a warning.
+ *
+ * Neither UART may be in LOOPBACK mode while linked. Destroy the link (or
+ * call disconnect()) before either UART.
+ */
+class UARTLink {
+private:
+    UART& first;
+    UART& second;
+    bool connected;
+
+    static UART::LineSink sinkFor(UART& receiver);
+
+public:
+    UARTLink(UART& a, UART& b);
+    ~UARTLink();
+
+    UARTLink(const UARTLink&) = delete;
+    UARTLink& operator=(const UARTLink&) = delete;
+
+    bool connect();
+    bool disconnect();
+    bool isConnected() const { return connected; }
+};
+
+/**
+ * @brief Bridge between a UART and a Linux pseudo-terminal
+ *
+ * Creates a PTY (posix_openpt) whose slave side, e.g. /dev/pts/7, can be
+ * opened by any serial tool (minicom, pyserial, a second simulator):
+ * - UART TX: each burst is written to the PTY master from the UART's TX
+ *   thread in one call; bytes the client has not made room for are dropped
+ *   and counted, like a line with no flow control
+ * - UART RX: a reader thread polls the master and replays what the client
+ *   wrote at the UART's frame rate (stop-bit timestamps, about a millisecond
+ *   of line time per delivery), then reports the line idle when the client
+ *   pauses
+ *
+ * The slave is switched to raw mode and kept open by the bridge so the
+ * master never sees a hangup while no client is attached.
+ */
+class PtyBridge {
+public:
+    struct Statistics {
+        size_t bytes_to_pty;
+        size_t bytes_from_pty;
+        size_t bytes_dropped;      // UART TX bytes the PTY had no room for
+    };
+
+private:
+    UART& uart;
+    int master_fd;
+    int slave_fd;
+    std::string slave_path;
+    std::thread reader_thread;
+    std::atomic<bool> running;
+    std::atomic<size_t> bytes_to_pty;
+    std::atomic<size_t> bytes_from_pty;
+    std::atomic<size_t> bytes_dropped;
+
+    static constexpr size_t READ_CHUNK = 4096;
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{20};     // Stop latency of the reader
+    static constexpr std::chrono::microseconds DELIVERY_SLICE{1000};  // Line time per RX delivery
+
+    void readerLoop();
+    void writeToPty(Span<const uint8_t> data);
+    void closeDescriptors();
+
+public:
+    explicit PtyBridge(UART& uart);
+    ~PtyBridge();
+
+    PtyBridge(const PtyBridge&) = delete;
+    PtyBridge& operator=(const PtyBridge&) = delete;
+
+    bool open();
+    bool close();
+    bool isOpen() const { return running.load(); }
+    const std::string& getSlavePath() const { return slave_path; }
+    Statistics getStatistics() const;
+};
+
+#endif // UART_LINK_H
@@ -0,0 +1,220 @@
+#include "common/calibration.h"
+#include "common/simd.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+Calibration::Calibration(Kind k)
+    : kind(k),
+      offset(0.0f),
+      scale(1.0f),
+      uniform(false),
+      inv_step(0.0f) {
+}
+
+std::shared_ptr<const Calibration> Calibration::linear(float offset, float scale) {
+    if (scale == 0.0f || !std::isfinite(offset) || !std::isfinite(scale)) {
+        std::cerr << "Error: Calibration scale must be non-zero and finite" << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<Calibration> curve(new Calibration(Kind::LINEAR));
+    curve->offset = offset;
+    curve->scale = scale;
+    return curve;
+}
+
+std::shared_ptr<const Calibration> Calibration::polynomial(const std::vector<float>& coefficients) {
+    if (coefficients.empty() || coefficients.size() > MAX_POLYNOMIAL_ORDER + 1) {
+        std::cerr << "Error: Polynomial calibration needs 1-" << MAX_POLYNOMIAL_ORDER + 1
+                  << " coefficients" << std::endl;
+        return nullptr;
+    }
+    for (float c : coefficients) {
+        if (!std::isfinite(c)) {
+            std::cerr << "Error: Polynomial coefficients must be finite" << std::endl;
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<Calibration> curve(new Calibration(Kind::POLYNOMIAL));
+    curve->coefficients = coefficients;
+    return curve;
+}
+
+std::shared_ptr<const Calibration> Calibration::piecewiseLinear(std::vector<std::pair<float, float>> points) {
+    if (points.size() < 2 || points.size() > MAX_POINTS) {
+        std::cerr << "Error: Piecewise calibration needs 2-" << MAX_POINTS << " points" << std::endl;
+        return nullptr;
+    }
+
+    std::sort(points.begin(), points.end());
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!std::isfinite(points[i].first) || !std::isfinite(points[i].second)) {
+            std::cerr << "Error: Calibration points must be finite" << std::endl;
+            return nullptr;
+        }
+        if (i > 0 && points[i].first == points[i - 1].first) {
+            std::cerr << "Error: Duplicate calibration breakpoint at " << points[i].first << std::endl;
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<Calibration> curve(new Calibration(Kind::PIECEWISE_LINEAR));
+    curve->xs.reserve(points.size());
+    curve->ys.reserve(points.size());
+    for (const auto& point : points) {
+        curve->xs.push_back(point.first);
+        curve->ys.push_back(point.second);
+    }
+    curve->buildSegments();
+    return curve;
+}
+
+std::shared_ptr<const Calibration> Calibration::table(const std::vector<float>& values, float input_min, float input_max) {
+    if (values.size() < 2 || values.size() > MAX_POINTS) {
+        std::cerr << "Error: Calibration table needs 2-" << MAX_POINTS << " entries" << std::endl;
+        return nullptr;
+    }
+    if (!(input_max > input_min)) {
+        std::cerr << "Error: Calibration table input range is empty" << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<Calibration> curve(new Calibration(Kind::TABLE));
+    double step = (static_cast<double>(input_max) - input_min) / static_cast<double>(values.size() - 1);
+    curve->xs.resize(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        curve->xs[i] = static_cast<float>(input_min + step * static_cast<double>(i));
+    }
+    curve->ys = values;
+    curve->buildSegments();
+    return curve;
+}
+
+void Calibration::buildSegments() {
+    size_t segments = xs.size() - 1;
+    slopes.resize(segments);
+    for (size_t i = 0; i < segments; ++i) {
+        slopes[i] = (ys[i + 1] - ys[i]) / (xs[i + 1] - xs[i]);
+    }
+
+    // Equal spacing (within float rounding) allows an O(1) segment index
+    float step = (xs.back() - xs.front()) / static_cast<float>(segments);
+    uniform = true;
+    for (size_t i = 0; i < segments && uniform; ++i) {
+        uniform = std::fabs((xs[i + 1] - xs[i]) - step) <= step * 1e-3f;
+    }
+    inv_step = uniform ? 1.0f / step : 0.0f;
+}
+
+size_t Calibration::findSegment(float x) const {
+    size_t last = slopes.size() - 1;
+    if (uniform) {
+        float position = (x - xs.front()) * inv_step;
+        if (!(position > 0.0f)) {
+            return 0;
+        }
+        size_t index = (position >= static_cast<float>(last)) ? last : static_cast<size_t>(position);
+        // Rounding in the spacing can put x one segment off near a breakpoint
+        if (index > 0 && x < xs[index]) {
+            index--;
+        } else if (index < last && x >= xs[index + 1]) {
+            index++;
+        }
+        return index;
+    }
+
+    auto it = std::upper_bound(xs.begin() + 1, xs.end() - 1, x);
+    return static_cast<size_t>(it - xs.begin()) - 1;
+}
+
+float Calibration::applyPolynomial(float x) const {
+    float acc = coefficients.back();
+    for (size_t i = coefficients.size() - 1; i-- > 0;) {
+        acc = acc * x + coefficients[i];
+    }
+    return acc;
+}
+
+float Calibration::applyPiecewise(float x) const {
+    size_t i = findSegment(x);
+    return ys[i] + slopes[i] * (x - xs[i]);
+}
+
+float Calibration::apply(float x) const {
+    switch (kind) {
+        case Kind::LINEAR: return (x + offset) * scale;
+        case Kind::POLYNOMIAL: return applyPolynomial(x);
+        case Kind::PIECEWISE_LINEAR:
+        case Kind::TABLE: return applyPiecewise(x);
+        default: return x;
+    }
+}
+
+void Calibration::applyBlock(const float* in, float* out, size_t count) const {
+    size_t i = 0;
+
+    if (kind == Kind::PIECEWISE_LINEAR || kind == Kind::TABLE) {
+        // Gathers do not vectorize profitably on SSE/AVX; the lookup is O(1) or O(log n)
+        for (; i < count; ++i) {
+            out[i] = applyPiecewise(in[i]);
+        }
+        return;
+    }
+
+    if (kind == Kind::LINEAR) {
+#if defined(SIMD_USE_AVX)
+        const __m256 o = _mm256_set1_ps(offset);
+        const __m256 s = _mm256_set1_ps(scale);
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(in + i), o), s));
+        }
+#elif defined(SIMD_USE_SSE2)
+        const __m128 o = _mm_set1_ps(offset);
+        const __m128 s = _mm_set1_ps(scale);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(in + i), o), s));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = (in[i] + offset) * scale;
+        }
+        return;
+    }
+
+    // Horner's scheme, one polynomial per lane
+    const size_t order = coefficients.size() - 1;
+#if defined(SIMD_USE_AVX)
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(in + i);
+        __m256 acc = _mm256_set1_ps(coefficients[order]);
+        for (size_t c = order; c-- > 0;) {
+            acc = _mm256_add_ps(_mm256_mul_ps(acc, x), _mm256_set1_ps(coefficients[c]));
+        }
+        _mm256_storeu_ps(out + i, acc);
+    }
+#elif defined(SIMD_USE_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(in + i);
+        __m128 acc = _mm_set1_ps(coefficients[order]);
+        for (size_t c = order; c-- > 0;) {
+            acc = _mm_add_ps(_mm_mul_ps(acc, x), _mm_set1_ps(coefficients[c]));
+        }
+        _mm_storeu_ps(out + i, acc);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = applyPolynomial(in[i]);
+    }
+}
+
+std::string Calibration::kindToString(Kind kind) {
+    switch (kind) {
+        case Kind::LINEAR: return "Linear";
+        case Kind::POLYNOMIAL: return "Polynomial";
+        case Kind::PIECEWISE_LINEAR: return "Piecewise Linear";
+        case Kind::TABLE: return "Table";
+        default: return "Unknown";
+    }
+}
@@ -0,0 +1,111 @@
+#include "common/fft.h"
+#include "common/simd.h"
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+}
+
+FFT::FFT(size_t size) : n(size), log2n(0) {
+    if (!isPowerOfTwo(n)) {
+        std::cerr << "Error: FFT size must be a power of two >= 4 (got " << size << ")" << std::endl;
+        n = 4;
+        while (n < size) n <<= 1;
+    }
+    while ((size_t(1) << log2n) < n) log2n++;
+
+    for (size_t i = 0; i < n; ++i) {
+        size_t j = 0;
+        for (size_t bit = 0; bit < log2n; ++bit) {
+            if (i & (size_t(1) << bit)) {
+                j |= size_t(1) << (log2n - 1 - bit);
+            }
+        }
+        if (i < j) {
+            bit_reverse_pairs.push_back(i);
+            bit_reverse_pairs.push_back(j);
+        }
+    }
+
+    // Stages after the fused radix-4 pass: butterfly half-spans 4, 8, ..., n/2
+    for (size_t half = 4; half < n; half <<= 1) {
+        for (size_t k = 0; k < half; ++k) {
+            double angle = -PI * static_cast<double>(k) / static_cast<double>(half);
+            twiddle_re.push_back(static_cast<float>(std::cos(angle)));
+            twiddle_im.push_back(static_cast<float>(std::sin(angle)));
+        }
+    }
+}
+
+void FFT::forward(float* re, float* im) const {
+    permute(re, im);
+    radix4FirstPass(re, im);
+
+    size_t offset = 0;
+    for (size_t half = 4; half < n; half <<= 1) {
+        radix2Pass(re, im, half, twiddle_re.data() + offset, twiddle_im.data() + offset);
+        offset += half;
+    }
+}
+
+void FFT::permute(float* re, float* im) const {
+    for (size_t p = 0; p < bit_reverse_pairs.size(); p += 2) {
+        size_t i = bit_reverse_pairs[p];
+        size_t j = bit_reverse_pairs[p + 1];
+        std::swap(re[i], re[j]);
+        std::swap(im[i], im[j]);
+    }
+}
+
+void FFT::radix4FirstPass(float* re, float* im) const {
+    for (size_t s = 0; s < n; s += 4) {
+        // Two radix-2 stages at once: span 2 (twiddle 1), then span 4 (twiddles 1, -j)
+        float b0r = re[s] + re[s + 1], b0i = im[s] + im[s + 1];
+        float b1r = re[s] - re[s + 1], b1i = im[s] - im[s + 1];
+        float b2r = re[s + 2] + re[s + 3], b2i = im[s + 2] + im[s + 3];
+        float b3r = re[s + 2] - re[s + 3], b3i = im[s + 2] - im[s + 3];
+
+        re[s] = b0r + b2r;     im[s] = b0i + b2i;
+        re[s + 2] = b0r - b2r; im[s + 2] = b0i - b2i;
+        re[s + 1] = b1r + b3i; im[s + 1] = b1i - b3r;  // b1 + (-j) * b3
+        re[s + 3] = b1r - b3i; im[s + 3] = b1i + b3r;  // b1 - (-j) * b3
+    }
+}
+
+void FFT::radix2Pass(float* re, float* im, size_t half, const float* w_re, const float* w_im) const {
+    for (size_t s = 0; s < n; s += 2 * half) {
+        float* a_re = re + s;
+        float* a_im = im + s;
+        float* b_re = re + s + half;
+        float* b_im = im + s + half;
+
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+        // half >= 4, so every span is a whole number of SSE vectors
+        for (size_t k = 0; k < half; k += 4) {
+            __m128 wr = _mm_loadu_ps(w_re + k);
+            __m128 wi = _mm_loadu_ps(w_im + k);
+            __m128 br = _mm_loadu_ps(b_re + k);
+            __m128 bi = _mm_loadu_ps(b_im + k);
+            __m128 tr = _mm_sub_ps(_mm_mul_ps(wr, br), _mm_mul_ps(wi, bi));
+            __m128 ti = _mm_add_ps(_mm_mul_ps(wr, bi), _mm_mul_ps(wi, br));
+            __m128 ar = _mm_loadu_ps(a_re + k);
+            __m128 ai = _mm_loadu_ps(a_im + k);
+            _mm_storeu_ps(b_re + k, _mm_sub_ps(ar, tr));
+            _mm_storeu_ps(b_im + k, _mm_sub_ps(ai, ti));
+            _mm_storeu_ps(a_re + k, _mm_add_ps(ar, tr));
+            _mm_storeu_ps(a_im + k, _mm_add_ps(ai, ti));
+        }
+#else
+        for (size_t k = 0; k < half; ++k) {
+            float tr = w_re[k] * b_re[k] - w_im[k] * b_im[k];
+            float ti = w_re[k] * b_im[k] + w_im[k] * b_re[k];
+            b_re[k] = a_re[k] - tr;
+            b_im[k] = a_im[k] - ti;
+            a_re[k] += tr;
+            a_im[k] += ti;
+        }
+#endif
+    }
+}
@@ -0,0 +1,282 @@
+#include "common/quantile_sketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+constexpr double CAPACITY_DECAY = 2.0 / 3.0;
+constexpr size_t MIN_LEVEL_CAPACITY = 2;
+}
+
+QuantileSketch::QuantileSketch(uint16_t k_param)
+    : k(std::max<uint16_t>(k_param, 8)),
+      count(0),
+      min_value(std::numeric_limits<float>::quiet_NaN()),
+      max_value(std::numeric_limits<float>::quiet_NaN()),
+      retained(0),
+      total_capacity(0),
+      rng_state(0x9E3779B97F4A7C15ULL),
+      view_valid(false) {
+    levels.emplace_back();
+    levels[0].reserve(k);
+    updateCapacities();
+}
+
+void QuantileSketch::update(float value) {
+    if (std::isnan(value)) {
+        return;
+    }
+
+    if (count == 0) {
+        min_value = value;
+        max_value = value;
+    } else {
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+    }
+
+    levels[0].push_back(value);
+    count++;
+    retained++;
+    view_valid = false;
+
+    if (retained >= total_capacity) {
+        compress();
+    }
+}
+
+void QuantileSketch::update(const float* values, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        update(values[i]);
+    }
+}
+
+bool QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.k != k) {
+        return false;
+    }
+    if (other.count == 0) {
+        return true;
+    }
+
+    if (count == 0) {
+        min_value = other.min_value;
+        max_value = other.max_value;
+    } else {
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    if (levels.size() < other.levels.size()) {
+        levels.resize(other.levels.size());
+        updateCapacities();
+    }
+    for (size_t h = 0; h < other.levels.size(); ++h) {
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+    }
+    count += other.count;
+    retained += other.retained;
+    view_valid = false;
+
+    compress();
+    return true;
+}
+
+void QuantileSketch::reset() {
+    count = 0;
+    min_value = std::numeric_limits<float>::quiet_NaN();
+    max_value = std::numeric_limits<float>::quiet_NaN();
+    levels.assign(1, std::vector<float>());
+    levels[0].reserve(k);
+    retained = 0;
+    updateCapacities();
+    sorted_view.clear();
+    view_valid = false;
+}
+
+void QuantileSketch::updateCapacities() {
+    // The top level gets k, every level below 2/3 of the one above it
+    capacities.resize(levels.size());
+    total_capacity = 0;
+    for (size_t h = 0; h < levels.size(); ++h) {
+        size_t depth = levels.size() - 1 - h;
+        double capacity = static_cast<double>(k) * std::pow(CAPACITY_DECAY, static_cast<double>(depth));
+        capacities[h] = std::max(MIN_LEVEL_CAPACITY, static_cast<size_t>(std::ceil(capacity)));
+        total_capacity += capacities[h];
+    }
+}
+
+void QuantileSketch::compress() {
+    // Compact the lowest over-full level until everything fits
+    while (retained >= total_capacity) {
+        size_t h = 0;
+        while (h < levels.size() && levels[h].size() < capacities[h]) {
+            h++;
+        }
+        if (h == levels.size()) {
+            break;
+        }
+        compactLevel(h);
+    }
+}
+
+void QuantileSketch::compactLevel(size_t level) {
+    if (level + 1 == levels.size()) {
+        levels.emplace_back();
+        updateCapacities();
+    }
+
+    std::vector<float>& items = levels[level];
+    std::sort(items.begin(), items.end());
+
+    // An odd item stays behind so the promoted weight is exact
+    float leftover = 0.0f;
+    bool has_leftover = (items.size() % 2) == 1;
+    if (has_leftover) {
+        leftover = items.back();
+        items.pop_back();
+    }
+
+    std::vector<float>& next = levels[level + 1];
+    size_t offset = nextCoin() ? 1 : 0;
+    for (size_t i = offset; i < items.size(); i += 2) {
+        next.push_back(items[i]);
+    }
+
+    retained -= items.size() / 2; // Half of an even run is promoted
+    items.clear();
+    if (has_leftover) {
+        items.push_back(leftover);
+    }
+}
+
+bool QuantileSketch::nextCoin() {
+    // xorshift64: deterministic, cheap, good enough for unbiased compaction
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (rng_state & 1) != 0;
+}
+
+void QuantileSketch::buildView() const {
+    sorted_view.clear();
+    sorted_view.reserve(getRetainedItems());
+    for (size_t h = 0; h < levels.size(); ++h) {
+        uint64_t weight = uint64_t(1) << h;
+        for (float value : levels[h]) {
+            sorted_view.emplace_back(value, weight);
+        }
+    }
+    std::sort(sorted_view.begin(), sorted_view.end(),
+              [](const std::pair<float, uint64_t>& a, const std::pair<float, uint64_t>& b) {
+                  return a.first < b.first;
+              });
+
+    uint64_t cumulative = 0;
+    for (auto& entry : sorted_view) {
+        cumulative += entry.second;
+        entry.second = cumulative;
+    }
+    view_valid = true;
+}
+
+float QuantileSketch::quantile(double q) const {
+    if (count == 0) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (q <= 0.0) return min_value;
+    if (q >= 1.0) return max_value;
+
+    if (!view_valid) {
+        buildView();
+    }
+
+    uint64_t total = sorted_view.back().second;
+    uint64_t target = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+    auto it = std::lower_bound(sorted_view.begin(), sorted_view.end(), target,
+                               [](const std::pair<float, uint64_t>& entry, uint64_t rank) {
+                                   return entry.second < rank;
+                               });
+    if (it == sorted_view.end()) {
+        return max_value;
+    }
+    return it->first;
+}
+
+std::vector<float> QuantileSketch::quantiles(const std::vector<double>& qs) const {
+    std::vector<float> result;
+    result.reserve(qs.size());
+    for (double q : qs) {
+        result.push_back(quantile(q));
+    }
+    return result;
+}
+
+double QuantileSketch::rank(float value) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    if (!view_valid) {
+        buildView();
+    }
+
+    auto it = std::upper_bound(sorted_view.begin(), sorted_view.end(), value,
+                               [](float v, const std::pair<float, uint64_t>& entry) {
+                                   return v < entry.first;
+                               });
+    if (it == sorted_view.begin()) {
+        return 0.0;
+    }
+    return static_cast<double>((it - 1)->second) / static_cast<double>(sorted_view.back().second);
+}
+
+double QuantileSketch::normalizedRankError(uint16_t k) {
+    // Empirical single-quantile bound for KLL at 99% confidence
+    return 2.296 / std::pow(static_cast<double>(k), 0.9723);
+}
+
+QuantileRollup::QuantileRollup(std::chrono::steady_clock::duration duration, size_t bucket_count, uint16_t k_param)
+    : bucket_duration(duration.count() > 0 ? duration : std::chrono::seconds(10)),
+      buckets(std::max<size_t>(bucket_count, 1), QuantileSketch(k_param)),
+      bucket_epochs(buckets.size(), -1),
+      k(k_param) {
+}
+
+int64_t QuantileRollup::epochOf(std::chrono::steady_clock::time_point tp) const {
+    return static_cast<int64_t>(tp.time_since_epoch() / bucket_duration);
+}
+
+void QuantileRollup::update(float value, std::chrono::steady_clock::time_point timestamp) {
+    int64_t epoch = epochOf(timestamp);
+    size_t slot = static_cast<size_t>(epoch % static_cast<int64_t>(buckets.size()));
+
+    if (bucket_epochs[slot] != epoch) {
+        if (bucket_epochs[slot] > epoch) {
+            return; // Older than anything the ring still holds
+        }
+        buckets[slot].reset();
+        bucket_epochs[slot] = epoch;
+    }
+    buckets[slot].update(value);
+}
+
+QuantileSketch QuantileRollup::window(std::chrono::steady_clock::duration span,
+                                      std::chrono::steady_clock::time_point now) const {
+    QuantileSketch merged(k);
+    int64_t newest = epochOf(now);
+    int64_t oldest = epochOf(now - span);
+
+    for (size_t slot = 0; slot < buckets.size(); ++slot) {
+        if (bucket_epochs[slot] >= oldest && bucket_epochs[slot] <= newest) {
+            merged.merge(buckets[slot]);
+        }
+    }
+    return merged;
+}
+
+void QuantileRollup::reset() {
+    for (auto& bucket : buckets) {
+        bucket.reset();
+    }
+    std::fill(bucket_epochs.begin(), bucket_epochs.end(), -1);
+}
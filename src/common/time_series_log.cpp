@@ -0,0 +1,677 @@
+#include "common/time_series_log.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr uint32_t SEGMENT_MAGIC = 0x53545345; // "ESTS"
+constexpr uint32_t BLOCK_MAGIC = 0x4B4C4254;   // "TBLK"
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t SEGMENT_HEADER_SIZE = 64;
+constexpr size_t DECODE_BATCH = 1024;
+
+struct SegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sequence;
+    uint64_t segment_size;
+    uint64_t used_bytes;          // Bytes covered by sealed blocks (incl. header)
+    int64_t timestamp_resolution_ns;
+};
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t count;
+    int64_t first_ts;             // Nanoseconds
+    int64_t last_ts;              // Nanoseconds
+    uint32_t payload_bytes;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SegmentHeader) <= SEGMENT_HEADER_SIZE, "segment header too large");
+
+// Worst case per sample: 5 + 64 timestamp bits and 2 + 5 + 5 + 32 value bits
+constexpr size_t MAX_BITS_PER_SAMPLE = 113;
+
+// Bits are packed MSB-first; the target area must be zeroed beforehand
+inline void writeBits(uint8_t* buffer, uint64_t& position, uint64_t value, int bits) {
+    while (bits > 0) {
+        size_t byte = position >> 3;
+        int used = static_cast<int>(position & 7);
+        int space = 8 - used;
+        int take = bits < space ? bits : space;
+        uint8_t chunk = static_cast<uint8_t>((value >> (bits - take)) & ((1u << take) - 1));
+        buffer[byte] |= static_cast<uint8_t>(chunk << (space - take));
+        position += take;
+        bits -= take;
+    }
+}
+
+// Reads up to 57 bits using a 64-bit big-endian window (blocks carry 8 bytes of padding)
+class BitReader {
+    const uint8_t* data;
+    uint64_t position;
+
+public:
+    BitReader(const uint8_t* buffer) : data(buffer), position(0) {}
+
+    uint64_t read(int bits) {
+        if (bits > 56) {
+            uint64_t high = read(bits - 32);
+            return (high << 32) | read(32);
+        }
+        const uint8_t* p = data + (position >> 3);
+        uint64_t window = 0;
+        for (int i = 0; i < 8; ++i) {
+            window = (window << 8) | p[i];
+        }
+        window <<= (position & 7);
+        position += bits;
+        return window >> (64 - bits);
+    }
+
+    bool readBit() { return read(1) != 0; }
+};
+
+// Block headers are kept 8-byte aligned inside the mapping
+inline size_t alignBlock(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+inline int64_t signExtend(uint64_t value, int bits) {
+    uint64_t sign = 1ULL << (bits - 1);
+    return static_cast<int64_t>((value ^ sign) - sign);
+}
+
+inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool makeDirectories(const std::string& path) {
+    std::string partial;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t slash = path.find('/', start);
+        if (slash == std::string::npos) slash = path.size();
+        partial = path.substr(0, slash);
+        if (!partial.empty() && mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        start = slash + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+TimeSeriesLog::TimeSeriesLog(const std::string& dir, const Config& cfg)
+    : directory(dir),
+      config(cfg),
+      opened(false),
+      encoder{},
+      write_offset(0),
+      next_segment_sequence(0),
+      total_samples(0),
+      total_payload_bytes(0) {
+
+    if (config.block_samples < 2) config.block_samples = 2;
+    if (config.timestamp_resolution_ns <= 0) config.timestamp_resolution_ns = 1;
+    size_t minimum = SEGMENT_HEADER_SIZE + maxBlockBytes();
+    if (config.segment_size < minimum) config.segment_size = minimum;
+}
+
+TimeSeriesLog::~TimeSeriesLog() {
+    close();
+}
+
+TimeSeriesLog::Config TimeSeriesLog::defaultConfig() {
+    Config cfg;
+    cfg.segment_size = 4 * 1024 * 1024; // 4 MiB segments
+    cfg.block_samples = 1024;
+    cfg.max_segments = 0;
+    cfg.timestamp_resolution_ns = 1000; // Microsecond timestamps on disk
+    return cfg;
+}
+
+bool TimeSeriesLog::open() {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (opened) {
+        return true;
+    }
+
+    if (!makeDirectories(directory)) {
+        std::cerr << "Error: Cannot create log directory " << directory
+                  << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Discover existing segments
+    std::vector<uint64_t> sequences;
+    if (DIR* dir = opendir(directory.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            unsigned long long sequence = 0;
+            char suffix[8] = {};
+            if (sscanf(entry->d_name, "segment_%llu.%4s", &sequence, suffix) == 2 &&
+                std::strcmp(suffix, "tsl") == 0) {
+                sequences.push_back(sequence);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(sequences.begin(), sequences.end());
+
+    segments.clear();
+    index.clear();
+    total_samples = 0;
+    total_payload_bytes = 0;
+    encoder = BlockEncoder{};
+
+    for (uint64_t sequence : sequences) {
+        if (!openSegment(sequence, false)) {
+            continue;
+        }
+        if (!recoverSegment(segments.size() - 1)) {
+            closeSegment(segments.back());
+            segments.pop_back();
+        }
+    }
+
+    next_segment_sequence = sequences.empty() ? 1 : sequences.back() + 1;
+
+    if (segments.empty()) {
+        if (!openSegment(next_segment_sequence++, true)) {
+            return false;
+        }
+        write_offset = SEGMENT_HEADER_SIZE;
+    } else {
+        auto* header = reinterpret_cast<SegmentHeader*>(segments.back().base);
+        write_offset = header->used_bytes;
+    }
+
+    opened = true;
+    enforceRetention();
+    return true;
+}
+
+bool TimeSeriesLog::close() {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (!opened) {
+        return true;
+    }
+
+    sealBlock();
+    for (auto& segment : segments) {
+        msync(segment.base, segment.size, MS_ASYNC);
+        closeSegment(segment);
+    }
+    segments.clear();
+    index.clear();
+    opened = false;
+    return true;
+}
+
+bool TimeSeriesLog::isOpen() const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    return opened;
+}
+
+bool TimeSeriesLog::append(int64_t timestamp_ns, float value) {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (!opened) {
+        return false;
+    }
+
+    if (encoder.active) {
+        int64_t quantized = timestamp_ns / config.timestamp_resolution_ns;
+        if (quantized < encoder.previous_ts) {
+            return false; // Out-of-order samples are rejected
+        }
+        encodeSample(quantized, value);
+        if (encoder.count >= config.block_samples) {
+            sealBlock();
+        }
+        return true;
+    }
+
+    if (!index.empty() && timestamp_ns < index.back().last_ts) {
+        return false;
+    }
+    return beginBlock(timestamp_ns, value);
+}
+
+bool TimeSeriesLog::flush() {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (!opened) {
+        return false;
+    }
+
+    sealBlock();
+    const Segment& active = segments.back();
+    return msync(active.base, active.size, MS_ASYNC) == 0;
+}
+
+size_t TimeSeriesLog::scan(int64_t from_ns, int64_t to_ns, const ScanCallback& callback) const {
+    // Sealed blocks never change once indexed: note them (keeping their
+    // segment mapped) and decode the block being encoded, then drop the lock
+    struct Candidate {
+        IndexEntry entry;
+        std::shared_ptr<uint8_t> mapping;
+    };
+    std::vector<Candidate> candidates;
+    std::vector<Sample> live;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        if (!opened || !callback || from_ns > to_ns) {
+            return 0;
+        }
+
+        auto first = std::lower_bound(index.begin(), index.end(), from_ns,
+            [](const IndexEntry& entry, int64_t ts) { return entry.last_ts < ts; });
+        for (auto it = first; it != index.end() && it->first_ts <= to_ns; ++it) {
+            candidates.push_back(Candidate{*it, segments[it->segment].mapping});
+        }
+        if (encoder.active && encoder.first_ts * config.timestamp_resolution_ns <= to_ns &&
+            encoder.previous_ts * config.timestamp_resolution_ns >= from_ns) {
+            IndexEntry entry;
+            entry.first_ts = encoder.first_ts * config.timestamp_resolution_ns;
+            entry.last_ts = encoder.previous_ts * config.timestamp_resolution_ns;
+            entry.segment = segments.size() - 1;
+            entry.offset = encoder.header_offset;
+            entry.count = encoder.count;
+            entry.payload_bytes = 0;
+            decodeBlock(segments.back().base, entry, live);
+        }
+    }
+
+    size_t visited = 0;
+    // Trim to the requested window, then hand out in batches
+    auto visit = [&](const std::vector<Sample>& decoded) {
+        auto begin = std::lower_bound(decoded.begin(), decoded.end(), from_ns,
+            [](const Sample& s, int64_t ts) { return s.timestamp_ns < ts; });
+        auto end = std::upper_bound(begin, decoded.end(), to_ns,
+            [](int64_t ts, const Sample& s) { return ts < s.timestamp_ns; });
+
+        for (auto it = begin; it < end; it += std::min<ptrdiff_t>(DECODE_BATCH, end - it)) {
+            size_t batch = static_cast<size_t>(std::min<ptrdiff_t>(DECODE_BATCH, end - it));
+            callback(&*it, batch);
+            visited += batch;
+        }
+    };
+
+    std::vector<Sample> decoded;
+    decoded.reserve(config.block_samples);
+    for (const auto& candidate : candidates) {
+        decodeBlock(candidate.mapping.get(), candidate.entry, decoded);
+        visit(decoded);
+    }
+    visit(live);
+
+    return visited;
+}
+
+bool TimeSeriesLog::readLatest(Sample& sample) const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (!opened) {
+        return false;
+    }
+
+    IndexEntry entry;
+    if (encoder.active) {
+        entry.first_ts = encoder.first_ts * config.timestamp_resolution_ns;
+        entry.last_ts = encoder.previous_ts * config.timestamp_resolution_ns;
+        entry.segment = segments.size() - 1;
+        entry.offset = encoder.header_offset;
+        entry.count = encoder.count;
+        entry.payload_bytes = 0;
+    } else if (!index.empty()) {
+        entry = index.back();
+    } else {
+        return false;
+    }
+
+    std::vector<Sample> decoded;
+    decodeBlock(segments[entry.segment].base, entry, decoded);
+    if (decoded.empty()) {
+        return false;
+    }
+    sample = decoded.back();
+    return true;
+}
+
+TimeSeriesLog::Statistics TimeSeriesLog::getStatistics() const {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    Statistics stats;
+    stats.samples = total_samples + (encoder.active ? encoder.count : 0);
+    stats.blocks = index.size();
+    stats.segments = segments.size();
+    stats.compressed_bytes = total_payload_bytes +
+        (encoder.active ? static_cast<size_t>((encoder.bit_position + 7) / 8) : 0);
+    stats.bits_per_sample = stats.samples > 0 ?
+        (8.0 * static_cast<double>(stats.compressed_bytes)) / static_cast<double>(stats.samples) : 0.0;
+    return stats;
+}
+
+std::string TimeSeriesLog::segmentPath(uint64_t sequence) const {
+    char name[64];
+    snprintf(name, sizeof(name), "/segment_%012llu.tsl", static_cast<unsigned long long>(sequence));
+    return directory + name;
+}
+
+bool TimeSeriesLog::openSegment(uint64_t sequence, bool create) {
+    Segment segment;
+    segment.path = segmentPath(sequence);
+    segment.sequence = sequence;
+
+    segment.fd = ::open(segment.path.c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0644);
+    if (segment.fd < 0) {
+        std::cerr << "Error: Cannot open log segment " << segment.path
+                  << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (create) {
+        if (ftruncate(segment.fd, static_cast<off_t>(config.segment_size)) != 0) {
+            std::cerr << "Error: Cannot size log segment " << segment.path
+                      << " - " << strerror(errno) << std::endl;
+            ::close(segment.fd);
+            unlink(segment.path.c_str());
+            return false;
+        }
+        segment.size = config.segment_size;
+    } else {
+        struct stat st;
+        if (fstat(segment.fd, &st) != 0 || static_cast<size_t>(st.st_size) < SEGMENT_HEADER_SIZE) {
+            ::close(segment.fd);
+            return false;
+        }
+        segment.size = static_cast<size_t>(st.st_size);
+    }
+
+    void* mapping = mmap(nullptr, segment.size, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Cannot map log segment " << segment.path
+                  << " - " << strerror(errno) << std::endl;
+        ::close(segment.fd);
+        return false;
+    }
+    segment.base = static_cast<uint8_t*>(mapping);
+    size_t mapped_size = segment.size;
+    segment.mapping.reset(segment.base, [mapped_size](uint8_t* base) { munmap(base, mapped_size); });
+
+    if (create) {
+        auto* header = reinterpret_cast<SegmentHeader*>(segment.base);
+        header->magic = SEGMENT_MAGIC;
+        header->version = FORMAT_VERSION;
+        header->sequence = sequence;
+        header->segment_size = segment.size;
+        header->used_bytes = SEGMENT_HEADER_SIZE;
+        header->timestamp_resolution_ns = config.timestamp_resolution_ns;
+    }
+
+    segments.push_back(segment);
+    return true;
+}
+
+void TimeSeriesLog::closeSegment(Segment& segment) {
+    // Unmapped once no scan still decodes from it
+    segment.mapping.reset();
+    segment.base = nullptr;
+    if (segment.fd >= 0) {
+        ::close(segment.fd);
+        segment.fd = -1;
+    }
+}
+
+bool TimeSeriesLog::recoverSegment(size_t segment_index) {
+    const Segment& segment = segments[segment_index];
+    const auto* header = reinterpret_cast<const SegmentHeader*>(segment.base);
+
+    if (header->magic != SEGMENT_MAGIC || header->version != FORMAT_VERSION ||
+        header->used_bytes > segment.size ||
+        header->timestamp_resolution_ns != config.timestamp_resolution_ns) {
+        std::cerr << "Warning: Skipping incompatible log segment " << segment.path << std::endl;
+        return false;
+    }
+
+    // Walk the sealed blocks to rebuild the sparse index
+    size_t offset = SEGMENT_HEADER_SIZE;
+    while (offset + sizeof(BlockHeader) <= header->used_bytes) {
+        const auto* block = reinterpret_cast<const BlockHeader*>(segment.base + offset);
+        if (block->magic != BLOCK_MAGIC || block->count == 0) {
+            break;
+        }
+
+        IndexEntry entry;
+        entry.first_ts = block->first_ts;
+        entry.last_ts = block->last_ts;
+        entry.segment = segment_index;
+        entry.offset = offset;
+        entry.count = block->count;
+        entry.payload_bytes = block->payload_bytes;
+        index.push_back(entry);
+
+        total_samples += block->count;
+        total_payload_bytes += block->payload_bytes;
+        offset = alignBlock(offset + sizeof(BlockHeader) + block->payload_bytes + 8); // 8 bytes reader padding
+    }
+    return true;
+}
+
+bool TimeSeriesLog::rotateSegment() {
+    if (!openSegment(next_segment_sequence++, true)) {
+        return false;
+    }
+    write_offset = SEGMENT_HEADER_SIZE;
+    enforceRetention();
+    return true;
+}
+
+void TimeSeriesLog::enforceRetention() {
+    if (config.max_segments == 0) {
+        return;
+    }
+
+    while (segments.size() > config.max_segments) {
+        Segment oldest = segments.front();
+        closeSegment(oldest);
+        unlink(oldest.path.c_str());
+        segments.erase(segments.begin());
+
+        // Drop index entries for the removed segment and shift the rest
+        for (const auto& entry : index) {
+            if (entry.segment == 0) {
+                total_samples -= entry.count;
+                total_payload_bytes -= entry.payload_bytes;
+            }
+        }
+        index.erase(std::remove_if(index.begin(), index.end(),
+            [](const IndexEntry& entry) { return entry.segment == 0; }), index.end());
+        for (auto& entry : index) {
+            entry.segment--;
+        }
+    }
+}
+
+size_t TimeSeriesLog::maxBlockBytes() const {
+    return alignBlock(sizeof(BlockHeader) + 4 + (MAX_BITS_PER_SAMPLE * config.block_samples + 7) / 8 + 8);
+}
+
+bool TimeSeriesLog::beginBlock(int64_t timestamp_ns, float value) {
+    if (write_offset + maxBlockBytes() > segments.back().size) {
+        if (!rotateSegment()) {
+            return false;
+        }
+    }
+
+    uint8_t* block = segments.back().base + write_offset;
+    std::memset(block, 0, maxBlockBytes()); // Bit writer ORs into zeroed memory
+
+    int64_t quantized = timestamp_ns / config.timestamp_resolution_ns;
+    encoder.header_offset = write_offset;
+    encoder.payload = block + sizeof(BlockHeader);
+    encoder.bit_position = 0;
+    encoder.count = 1;
+    encoder.first_ts = quantized;
+    encoder.previous_ts = quantized;
+    encoder.previous_delta = 0;
+    encoder.previous_value = floatBits(value);
+    encoder.leading_zeros = -1;
+    encoder.trailing_zeros = 0;
+    encoder.active = true;
+
+    writeBits(encoder.payload, encoder.bit_position, encoder.previous_value, 32);
+    return true;
+}
+
+void TimeSeriesLog::encodeSample(int64_t timestamp, float value) {
+    uint8_t* out = encoder.payload;
+    uint64_t& pos = encoder.bit_position;
+
+    // Timestamp: delta-of-delta with variable-width buckets
+    int64_t delta = timestamp - encoder.previous_ts;
+    int64_t dod = delta - encoder.previous_delta;
+    if (dod == 0) {
+        writeBits(out, pos, 0x0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        writeBits(out, pos, 0x2, 2);
+        writeBits(out, pos, static_cast<uint64_t>(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        writeBits(out, pos, 0x6, 3);
+        writeBits(out, pos, static_cast<uint64_t>(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        writeBits(out, pos, 0xE, 4);
+        writeBits(out, pos, static_cast<uint64_t>(dod + 2047), 12);
+    } else if (dod >= -524287 && dod <= 524288) {
+        writeBits(out, pos, 0x1E, 5);
+        writeBits(out, pos, static_cast<uint64_t>(dod + 524287), 20);
+    } else {
+        writeBits(out, pos, 0x1F, 5);
+        writeBits(out, pos, static_cast<uint64_t>(dod), 64);
+    }
+    encoder.previous_delta = delta;
+    encoder.previous_ts = timestamp;
+
+    // Value: XOR against the previous value, reusing the leading/trailing window
+    uint32_t bits = floatBits(value);
+    uint32_t x = bits ^ encoder.previous_value;
+    if (x == 0) {
+        writeBits(out, pos, 0x0, 1);
+    } else {
+        int leading = __builtin_clz(x);
+        int trailing = __builtin_ctz(x);
+
+        if (encoder.leading_zeros >= 0 && leading >= encoder.leading_zeros &&
+            trailing >= encoder.trailing_zeros) {
+            int meaningful = 32 - encoder.leading_zeros - encoder.trailing_zeros;
+            writeBits(out, pos, 0x2, 2);
+            writeBits(out, pos, x >> encoder.trailing_zeros, meaningful);
+        } else {
+            int meaningful = 32 - leading - trailing;
+            writeBits(out, pos, 0x3, 2);
+            writeBits(out, pos, static_cast<uint64_t>(leading), 5);
+            writeBits(out, pos, static_cast<uint64_t>(meaningful - 1), 5);
+            writeBits(out, pos, x >> trailing, meaningful);
+            encoder.leading_zeros = leading;
+            encoder.trailing_zeros = trailing;
+        }
+    }
+    encoder.previous_value = bits;
+    encoder.count++;
+}
+
+void TimeSeriesLog::sealBlock() {
+    if (!encoder.active) {
+        return;
+    }
+
+    Segment& segment = segments.back();
+    auto* header = reinterpret_cast<BlockHeader*>(segment.base + encoder.header_offset);
+    uint32_t payload_bytes = static_cast<uint32_t>((encoder.bit_position + 7) / 8);
+
+    header->count = encoder.count;
+    header->first_ts = encoder.first_ts * config.timestamp_resolution_ns;
+    header->last_ts = encoder.previous_ts * config.timestamp_resolution_ns;
+    header->payload_bytes = payload_bytes;
+    header->reserved = 0;
+    header->magic = BLOCK_MAGIC; // Written last: marks the block as sealed
+
+    IndexEntry entry;
+    entry.first_ts = header->first_ts;
+    entry.last_ts = header->last_ts;
+    entry.segment = segments.size() - 1;
+    entry.offset = encoder.header_offset;
+    entry.count = encoder.count;
+    entry.payload_bytes = payload_bytes;
+    index.push_back(entry);
+
+    write_offset = alignBlock(encoder.header_offset + sizeof(BlockHeader) + payload_bytes + 8);
+    reinterpret_cast<SegmentHeader*>(segment.base)->used_bytes = write_offset;
+
+    total_samples += encoder.count;
+    total_payload_bytes += payload_bytes;
+    encoder.active = false;
+}
+
+size_t TimeSeriesLog::decodeBlock(const uint8_t* segment_base, const IndexEntry& entry, std::vector<Sample>& out) const {
+    out.clear();
+    const uint8_t* payload = segment_base + entry.offset + sizeof(BlockHeader);
+    const int64_t resolution = config.timestamp_resolution_ns;
+
+    BitReader reader(payload);
+    int64_t timestamp = entry.first_ts / resolution;
+    int64_t delta = 0;
+    uint32_t value = static_cast<uint32_t>(reader.read(32));
+    int leading = 0;
+    int trailing = 0;
+
+    out.push_back({timestamp * resolution, bitsFloat(value)});
+
+    for (uint32_t i = 1; i < entry.count; ++i) {
+        int64_t dod;
+        if (!reader.readBit()) {
+            dod = 0;
+        } else if (!reader.readBit()) {
+            dod = static_cast<int64_t>(reader.read(7)) - 63;
+        } else if (!reader.readBit()) {
+            dod = static_cast<int64_t>(reader.read(9)) - 255;
+        } else if (!reader.readBit()) {
+            dod = static_cast<int64_t>(reader.read(12)) - 2047;
+        } else if (!reader.readBit()) {
+            dod = static_cast<int64_t>(reader.read(20)) - 524287;
+        } else {
+            dod = signExtend(reader.read(64), 64);
+        }
+        delta += dod;
+        timestamp += delta;
+
+        if (reader.readBit()) {
+            if (reader.readBit()) {
+                leading = static_cast<int>(reader.read(5));
+                int meaningful = static_cast<int>(reader.read(5)) + 1;
+                trailing = 32 - leading - meaningful;
+            }
+            int meaningful = 32 - leading - trailing;
+            value ^= static_cast<uint32_t>(reader.read(meaningful)) << trailing;
+        }
+
+        out.push_back({timestamp * resolution, bitsFloat(value)});
+    }
+
+    return out.size();
+}
@@ -0,0 +1,139 @@
+#include "common/tsc_clock.h"
+#include <ctime>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+// Largest rate correction applied while slewing toward CLOCK_MONOTONIC
+constexpr double MAX_SLEW = 500e-6;
+
+int64_t monotonicNanoseconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+bool hasInvariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000007 &&
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return (edx & (1u << 8)) != 0;  // Advanced power management: invariant TSC
+    }
+#endif
+    return false;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Pair a TSC read with a CLOCK_MONOTONIC read; keep the tightest of a few
+// attempts so preemption between the reads does not skew the pair
+void samplePair(uint64_t& tick_value, int64_t& ns) {
+    uint64_t best_window = UINT64_MAX;
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        uint64_t before = __rdtsc();
+        int64_t mono = monotonicNanoseconds();
+        uint64_t after = __rdtsc();
+        if (after - before < best_window) {
+            best_window = after - before;
+            tick_value = before + (after - before) / 2;
+            ns = mono;
+        }
+    }
+}
+#endif
+
+} // namespace
+
+TscClock::TscClock()
+    : invariant(hasInvariantTsc()),
+      anchor_ticks(0),
+      anchor_ns(0),
+      recalibration_ticks(UINT64_MAX >> 1),
+      frequency_hz(1e9),
+      version(0),
+      base_ticks(0),
+      base_ns(0),
+      ns_per_tick(uint64_t(1) << 32),
+      recalibrating(false) {
+    if (invariant) {
+        calibrate();
+    }
+}
+
+const TscClock& TscClock::instance() {
+    static const TscClock clock;
+    return clock;
+}
+
+void TscClock::calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t start_ticks = 0, end_ticks = 0;
+    int64_t start_ns = 0, end_ns = 0;
+    samplePair(start_ticks, start_ns);
+    int64_t deadline = start_ns + std::chrono::duration_cast<std::chrono::nanoseconds>(CALIBRATION_PERIOD).count();
+    while (monotonicNanoseconds() < deadline) {
+    }
+    samplePair(end_ticks, end_ns);
+
+    if (end_ticks <= start_ticks || end_ns <= start_ns) {
+        invariant = false;  // Counter not usable; fall back to steady_clock
+        return;
+    }
+
+    double elapsed_ticks = static_cast<double>(end_ticks - start_ticks);
+    double elapsed_ns = static_cast<double>(end_ns - start_ns);
+    frequency_hz = elapsed_ticks * 1e9 / elapsed_ns;
+    anchor_ticks = start_ticks;
+    anchor_ns = start_ns;
+    recalibration_ticks = static_cast<uint64_t>(
+        frequency_hz * std::chrono::duration<double>(RECALIBRATION_INTERVAL).count());
+    ns_per_tick = static_cast<uint64_t>(elapsed_ns / elapsed_ticks * 4294967296.0 + 0.5);
+    base_ticks = end_ticks;
+    base_ns = end_ns;
+#else
+    invariant = false;
+#endif
+}
+
+void TscClock::recalibrate(uint64_t tick_value) const {
+#if defined(__x86_64__) || defined(__i386__)
+    // One thread re-anchors; the others keep converting with the current state
+    if (recalibrating.exchange(true, std::memory_order_acquire)) {
+        return;
+    }
+    uint64_t from_ticks = base_ticks.load(std::memory_order_relaxed);
+    if (static_cast<int64_t>(tick_value - from_ticks) <= static_cast<int64_t>(recalibration_ticks)) {
+        recalibrating.store(false, std::memory_order_release);
+        return;  // Someone else just did
+    }
+
+    uint64_t now_ticks = 0;
+    int64_t now_ns = 0;
+    samplePair(now_ticks, now_ns);
+
+    // Continue from where the current conversion puts now_ticks, so readings
+    // never step; the long-term rate plus a slew closes the offset to
+    // CLOCK_MONOTONIC over the next interval
+    int64_t converted = convert(now_ticks, from_ticks, base_ns.load(std::memory_order_relaxed),
+                                ns_per_tick.load(std::memory_order_relaxed));
+    double rate = static_cast<double>(now_ns - anchor_ns) / static_cast<double>(now_ticks - anchor_ticks);
+    double slew = static_cast<double>(now_ns - converted) / (rate * static_cast<double>(recalibration_ticks));
+    rate *= 1.0 + std::max(-MAX_SLEW, std::min(MAX_SLEW, slew));
+
+    uint32_t seen = version.load(std::memory_order_relaxed);
+    version.store(seen + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_ticks.store(now_ticks, std::memory_order_relaxed);
+    base_ns.store(converted, std::memory_order_relaxed);
+    ns_per_tick.store(static_cast<uint64_t>(rate * 4294967296.0 + 0.5), std::memory_order_relaxed);
+    version.store(seen + 2, std::memory_order_release);
+
+    recalibrating.store(false, std::memory_order_release);
+#else
+    (void)tick_value;
+#endif
+}
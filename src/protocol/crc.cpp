@@ -0,0 +1,160 @@
+#include "protocol/crc.h"
+#include <cstring>
+
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#define CRC_USE_PCLMUL 1
+#endif
+
+namespace {
+
+// tables[k][b]: CRC contribution of byte b followed by k zero bytes
+template <typename T, T Polynomial>
+struct SlicingTables {
+    T tables[8][256];
+
+    constexpr SlicingTables() : tables{} {
+        for (uint32_t byte = 0; byte < 256; ++byte) {
+            T crc = static_cast<T>(byte);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = static_cast<T>((crc & 1) ? (crc >> 1) ^ Polynomial : crc >> 1);
+            }
+            tables[0][byte] = crc;
+        }
+        for (int slice = 1; slice < 8; ++slice) {
+            for (uint32_t byte = 0; byte < 256; ++byte) {
+                T previous = tables[slice - 1][byte];
+                tables[slice][byte] = static_cast<T>((previous >> 8) ^ tables[0][previous & 0xFF]);
+            }
+        }
+    }
+};
+
+constexpr SlicingTables<uint16_t, 0x8408> X25_TABLES{};
+constexpr SlicingTables<uint16_t, 0xA001> MODBUS_TABLES{};
+constexpr SlicingTables<uint32_t, 0xEDB88320> CRC32_TABLES{};
+
+inline uint32_t loadLittleEndian32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+// Reflected CRC of up to 32 bits: the register sits in the low bytes of the
+// next 8-byte block, so the same fold works for 16- and 32-bit CRCs
+template <typename T>
+T updateReflected(const T (&t)[8][256], T state, const uint8_t* data, size_t size) {
+    uint32_t crc = state;
+    while (size >= 8) {
+        uint32_t low = loadLittleEndian32(data) ^ crc;
+        uint32_t high = loadLittleEndian32(data + 4);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+    return static_cast<T>(crc);
+}
+
+#if defined(CRC_USE_PCLMUL)
+// CRC-32 by carry-less multiplication (Intel, "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ"): four 128-bit lanes fold 64 bytes
+// per step, then fold to 128 bits and Barrett-reduce. Constants are
+// x^(k) mod P in the bit-reflected domain. Takes whole 16-byte blocks, at
+// least 64 bytes; state is the inverted CRC register.
+uint32_t foldCrc32(uint32_t state, const uint8_t* data, size_t size) {
+    alignas(16) static const uint64_t k1k2[2] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[2] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[2] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[2] = {0x01db710641, 0x01f7011641};
+    
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(state)));
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    size -= 64;
+    
+    while (size >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+        data += 64;
+        size -= 64;
+    }
+    
+    // Four lanes into one, then any remaining 16-byte blocks
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    auto fold = [&k](__m128i acc, __m128i next) {
+        return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x11), next),
+                             _mm_clmulepi64_si128(acc, k, 0x00));
+    };
+    x1 = fold(fold(fold(x1, x2), x3), x4);
+    while (size >= 16) {
+        x1 = fold(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+        data += 16;
+        size -= 16;
+    }
+    
+    // 128 -> 64 bits
+    const __m128i low32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, low32), k, 0x00), x2);
+    
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, low32), k, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, low32), k, 0x00);
+    return static_cast<uint32_t>(_mm_extract_epi32(_mm_xor_si128(x1, x2), 1));
+}
+#endif
+
+} // namespace
+
+namespace crc {
+
+uint16_t crc16X25(Span<const uint8_t> data, uint16_t previous) {
+    return static_cast<uint16_t>(updateReflected(X25_TABLES.tables, static_cast<uint16_t>(previous ^ 0xFFFF),
+                                                 data.data(), data.size()) ^ 0xFFFF);
+}
+
+uint16_t crc16Modbus(Span<const uint8_t> data, uint16_t previous) {
+    return updateReflected(MODBUS_TABLES.tables, previous, data.data(), data.size());
+}
+
+uint32_t crc32(Span<const uint8_t> data, uint32_t previous) {
+    uint32_t state = previous ^ 0xFFFFFFFFu;
+    const uint8_t* bytes = data.data();
+    size_t size = data.size();
+#if defined(CRC_USE_PCLMUL)
+    if (size >= 64) {
+        size_t folded = size & ~size_t(15);
+        state = foldCrc32(state, bytes, folded);
+        bytes += folded;
+        size -= folded;
+    }
+#endif
+    return updateReflected(CRC32_TABLES.tables, state, bytes, size) ^ 0xFFFFFFFFu;
+}
+
+} // namespace crc
@@ -0,0 +1,361 @@
+#include "protocol/framing.h"
+#include "protocol/crc.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr uint8_t COBS_DELIMITER = 0x00;
+constexpr uint8_t COBS_MAX_CODE = 0xFF;      // 254 data bytes, no implied zero
+
+constexpr uint8_t SLIP_END = 0xC0;
+constexpr uint8_t SLIP_ESC = 0xDB;
+constexpr uint8_t SLIP_ESC_END = 0xDC;
+constexpr uint8_t SLIP_ESC_ESC = 0xDD;
+
+constexpr uint8_t HDLC_FLAG = 0x7E;
+constexpr uint8_t HDLC_ESCAPE = 0x7D;
+constexpr uint8_t HDLC_XOR = 0x20;
+
+// Offset of the first byte equal to a or b, size if none
+size_t findEither(const uint8_t* data, size_t size, uint8_t a, uint8_t b) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i match_a = _mm256_set1_epi8(static_cast<char>(a));
+    const __m256i match_b = _mm256_set1_epi8(static_cast<char>(b));
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, match_a), _mm256_cmpeq_epi8(block, match_b))));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i match_a = _mm_set1_epi8(static_cast<char>(a));
+    const __m128i match_b = _mm_set1_epi8(static_cast<char>(b));
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(block, match_a), _mm_cmpeq_epi8(block, match_b))));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        if (data[i] == a || data[i] == b) {
+            return i;
+        }
+    }
+    return size;
+}
+
+size_t findByte(const uint8_t* data, size_t size, uint8_t value) {
+    const void* hit = std::memchr(data, value, size);
+    return hit ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - data) : size;
+}
+
+// SLIP/HDLC: copy clean runs, escape the delimiter and the escape byte
+uint8_t* stuff(Framer::Scheme scheme, Span<const uint8_t> input, uint8_t* out) {
+    const uint8_t delimiter = scheme == Framer::Scheme::SLIP ? SLIP_END : HDLC_FLAG;
+    const uint8_t escape = scheme == Framer::Scheme::SLIP ? SLIP_ESC : HDLC_ESCAPE;
+    const uint8_t* in = input.data();
+    size_t remaining = input.size();
+    while (remaining > 0) {
+        size_t run = findEither(in, remaining, delimiter, escape);
+        std::memcpy(out, in, run);
+        out += run;
+        in += run;
+        remaining -= run;
+        if (remaining == 0) {
+            break;
+        }
+        uint8_t special = *in++;
+        --remaining;
+        *out++ = escape;
+        if (scheme == Framer::Scheme::SLIP) {
+            *out++ = special == SLIP_END ? SLIP_ESC_END : SLIP_ESC_ESC;
+        } else {
+            *out++ = static_cast<uint8_t>(special ^ HDLC_XOR);
+        }
+    }
+    return out;
+}
+
+bool unstuff(Framer::Scheme scheme, Span<const uint8_t> frame, uint8_t* out, size_t& length) {
+    const uint8_t escape = scheme == Framer::Scheme::SLIP ? SLIP_ESC : HDLC_ESCAPE;
+    const uint8_t* in = frame.data();
+    size_t remaining = frame.size();
+    uint8_t* start = out;
+    while (remaining > 0) {
+        size_t run = findByte(in, remaining, escape);
+        std::memcpy(out, in, run);
+        out += run;
+        in += run;
+        remaining -= run;
+        if (remaining == 0) {
+            break;
+        }
+        if (remaining < 2) {
+            return false;  // Escape with nothing after it
+        }
+        uint8_t code = in[1];
+        if (scheme == Framer::Scheme::SLIP) {
+            if (code != SLIP_ESC_END && code != SLIP_ESC_ESC) {
+                return false;
+            }
+            *out++ = code == SLIP_ESC_END ? SLIP_END : SLIP_ESC;
+        } else {
+            *out++ = static_cast<uint8_t>(code ^ HDLC_XOR);
+        }
+        in += 2;
+        remaining -= 2;
+    }
+    length = static_cast<size_t>(out - start);
+    return true;
+}
+
+// COBS encoder that can be fed the payload and checksum as separate pieces
+class CobsWriter {
+private:
+    uint8_t* out;
+    uint8_t* code_position;
+    uint8_t code;
+
+public:
+    explicit CobsWriter(uint8_t* destination) : out(destination + 1), code_position(destination), code(1) {}
+
+    void append(Span<const uint8_t> input) {
+        const uint8_t* in = input.data();
+        size_t remaining = input.size();
+        while (remaining > 0) {
+            size_t limit = std::min<size_t>(remaining, COBS_MAX_CODE - code);
+            size_t run = findByte(in, limit, COBS_DELIMITER);
+            std::memcpy(out, in, run);
+            out += run;
+            in += run;
+            remaining -= run;
+            code = static_cast<uint8_t>(code + run);
+            if (run < limit) {
+                ++in;  // The zero becomes the block boundary
+                --remaining;
+            } else if (code != COBS_MAX_CODE) {
+                continue;  // Input ended mid-block
+            }
+            *code_position = code;
+            code_position = out++;
+            code = 1;
+        }
+    }
+
+    uint8_t* finish() {
+        *code_position = code;
+        return out;
+    }
+};
+
+bool cobsDecode(Span<const uint8_t> frame, uint8_t* out, size_t& length) {
+    const uint8_t* in = frame.data();
+    size_t remaining = frame.size();
+    uint8_t* start = out;
+    while (remaining > 0) {
+        size_t code = *in++;
+        --remaining;
+        if (code == COBS_DELIMITER || code - 1 > remaining) {
+            return false;
+        }
+        std::memcpy(out, in, code - 1);
+        out += code - 1;
+        in += code - 1;
+        remaining -= code - 1;
+        if (code != COBS_MAX_CODE && remaining > 0) {
+            *out++ = 0;
+        }
+    }
+    length = static_cast<size_t>(out - start);
+    return true;
+}
+
+} // namespace
+
+Framer::Framer(Scheme frame_scheme, Checksum frame_checksum, size_t max_payload_size)
+    : scheme(frame_scheme),
+      checksum(frame_checksum),
+      max_payload(max_payload_size),
+      delimiter(frame_scheme == Scheme::COBS ? COBS_DELIMITER : (frame_scheme == Scheme::SLIP ? SLIP_END : HDLC_FLAG)),
+      discarding(false),
+      stats{} {
+    size_t limit = maxEncodedSize(scheme, checksum, max_payload);
+    pending.reserve(limit);
+    decoded.resize(limit);
+}
+
+size_t Framer::checksumSize(Checksum checksum) {
+    switch (checksum) {
+        case Checksum::CRC16: return 2;
+        case Checksum::CRC32: return 4;
+        default: return 0;
+    }
+}
+
+size_t Framer::maxEncodedSize(Scheme scheme, Checksum checksum, size_t payload_size) {
+    size_t content = payload_size + checksumSize(checksum);
+    if (scheme == Scheme::COBS) {
+        return content + content / (COBS_MAX_CODE - 1) + 2;  // Code bytes + delimiter
+    }
+    return 2 * content + 2;  // Everything escaped + both delimiters
+}
+
+size_t Framer::computeChecksum(Span<const uint8_t> payload, uint8_t* out) const {
+    uint32_t value = 0;
+    switch (checksum) {
+        case Checksum::CRC16: value = crc::crc16X25(payload); break;
+        case Checksum::CRC32: value = crc::crc32(payload); break;
+        default: break;
+    }
+    size_t size = checksumSize(checksum);
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));  // Least significant byte first
+    }
+    return size;
+}
+
+size_t Framer::encode(Span<const uint8_t> payload, uint8_t* out) {
+    if (payload.size() > max_payload) {
+        std::cerr << "Error: Frame payload of " << payload.size() << " bytes exceeds " << max_payload << std::endl;
+        return 0;
+    }
+    uint8_t check[4];
+    Span<const uint8_t> trailer(check, computeChecksum(payload, check));
+
+    uint8_t* end = out;
+    if (scheme == Scheme::COBS) {
+        CobsWriter writer(out);
+        writer.append(payload);
+        writer.append(trailer);
+        end = writer.finish();
+        *end++ = COBS_DELIMITER;
+    } else {
+        *end++ = delimiter;
+        end = stuff(scheme, payload, end);
+        end = stuff(scheme, trailer, end);
+        *end++ = delimiter;
+    }
+    stats.frames_encoded++;
+    return static_cast<size_t>(end - out);
+}
+
+size_t Framer::encode(Span<const uint8_t> payload, std::vector<uint8_t>& out) {
+    size_t offset = out.size();
+    out.resize(offset + maxEncodedSize(scheme, checksum, payload.size()));
+    size_t length = encode(payload, out.data() + offset);
+    out.resize(offset + length);
+    return length;
+}
+
+bool Framer::decode(Span<const uint8_t> frame, uint8_t* out, size_t& payload_size) {
+    size_t length = 0;
+    bool unstuffed = scheme == Scheme::COBS ? cobsDecode(frame, out, length) : unstuff(scheme, frame, out, length);
+    size_t check_size = checksumSize(checksum);
+    if (!unstuffed || length < check_size) {
+        stats.format_errors++;
+        return false;
+    }
+    size_t size = length - check_size;
+    if (size > max_payload) {
+        stats.oversize_errors++;
+        return false;
+    }
+    uint8_t expected[4];
+    computeChecksum(Span<const uint8_t>(out, size), expected);
+    if (std::memcmp(expected, out + size, check_size) != 0) {
+        stats.crc_errors++;
+        return false;
+    }
+    stats.frames_decoded++;
+    payload_size = size;
+    return true;
+}
+
+bool Framer::deliverFrame(Span<const uint8_t> frame, const FrameCallback& callback) {
+    size_t size = 0;
+    if (frame.size() > decoded.size()) {
+        stats.oversize_errors++;
+        return false;
+    }
+    if (!decode(frame, decoded.data(), size)) {
+        return false;
+    }
+    if (callback) {
+        callback(Span<const uint8_t>(decoded.data(), size));
+    }
+    return true;
+}
+
+size_t Framer::feed(Span<const uint8_t> data, const FrameCallback& callback) {
+    size_t delivered = 0;
+    const uint8_t* in = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        size_t run = findByte(in, remaining, delimiter);
+        bool complete = run < remaining;
+        if (!discarding) {
+            if (pending.size() + run > decoded.size()) {
+                // Cannot be a valid frame: drop it up to the next delimiter
+                stats.oversize_errors++;
+                pending.clear();
+                discarding = true;
+            } else if (complete && pending.empty()) {
+                // Whole frame in this chunk: decode in place
+                if (run > 0 && deliverFrame(Span<const uint8_t>(in, run), callback)) {
+                    delivered++;
+                }
+            } else {
+                pending.insert(pending.end(), in, in + run);
+                if (complete) {
+                    if (deliverFrame(Span<const uint8_t>(pending.data(), pending.size()), callback)) {
+                        delivered++;
+                    }
+                    pending.clear();
+                }
+            }
+        }
+        if (!complete) {
+            break;
+        }
+        discarding = false;
+        in += run + 1;
+        remaining -= run + 1;
+    }
+    return delivered;
+}
+
+size_t Framer::feed(const RingSpan<const uint8_t>& data, const FrameCallback& callback) {
+    return feed(data.head, callback) + feed(data.tail, callback);
+}
+
+void Framer::resetDecoder() {
+    pending.clear();
+    discarding = false;
+}
+
+void Framer::resetStatistics() {
+    stats = Statistics{};
+}
+
+const char* Framer::schemeToString(Scheme scheme) {
+    switch (scheme) {
+        case Scheme::COBS: return "COBS";
+        case Scheme::SLIP: return "SLIP";
+        case Scheme::HDLC: return "HDLC";
+    }
+    return "UNKNOWN";
+}
@@ -0,0 +1,963 @@
+#include "protocol/modbus.h"
+#include "protocol/crc.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using modbus::ExceptionCode;
+using modbus::FunctionCode;
+
+constexpr size_t MIN_ADU_SIZE = 4;          // Address, function, CRC
+constexpr uint32_t ADDRESS_SPACE = 0x10000;
+constexpr uint16_t COIL_ON = 0xFF00;
+constexpr uint8_t EXCEPTION_FLAG = 0x80;
+
+uint16_t getWord(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+void putWord(uint8_t* data, uint16_t value) {
+    data[0] = static_cast<uint8_t>(value >> 8);
+    data[1] = static_cast<uint8_t>(value);
+}
+
+// Appends the CRC (low byte first) to an ADU of size bytes; returns the new size
+size_t appendCrc(uint8_t* adu, size_t size) {
+    uint16_t crc = crc::crc16Modbus(Span<const uint8_t>(adu, size));
+    adu[size] = static_cast<uint8_t>(crc);
+    adu[size + 1] = static_cast<uint8_t>(crc >> 8);
+    return size + 2;
+}
+
+// A frame with its CRC appended leaves a zero remainder
+bool crcValid(const uint8_t* adu, size_t size) {
+    return crc::crc16Modbus(Span<const uint8_t>(adu, size)) == 0;
+}
+
+bool isWrite(FunctionCode function) {
+    switch (function) {
+        case FunctionCode::WRITE_SINGLE_COIL:
+        case FunctionCode::WRITE_SINGLE_REGISTER:
+        case FunctionCode::WRITE_MULTIPLE_COILS:
+        case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isKnownFunction(uint8_t function) {
+    return (function >= 0x01 && function <= 0x06) || function == 0x0F || function == 0x10;
+}
+
+bool isBitFunction(FunctionCode function) {
+    return function == FunctionCode::READ_COILS || function == FunctionCode::READ_DISCRETE_INPUTS ||
+           function == FunctionCode::WRITE_SINGLE_COIL || function == FunctionCode::WRITE_MULTIPLE_COILS;
+}
+
+void packBits(const uint16_t* values, uint16_t count, uint8_t* out) {
+    std::memset(out, 0, (count + 7u) / 8u);
+    for (uint16_t i = 0; i < count; ++i) {
+        if (values[i] != 0) {
+            out[i / 8] = static_cast<uint8_t>(out[i / 8] | (1u << (i % 8)));
+        }
+    }
+}
+
+void unpackBits(const uint8_t* data, uint16_t count, uint16_t* values) {
+    for (uint16_t i = 0; i < count; ++i) {
+        values[i] = (data[i / 8] >> (i % 8)) & 1u;
+    }
+}
+
+size_t copyFrame(const RingSpan<const uint8_t>& data, uint8_t* out) {
+    size_t size = 0;
+    data.forEachSegment([&](Span<const uint8_t> segment) {
+        std::memcpy(out + size, segment.data(), segment.size());
+        size += segment.size();
+    });
+    return size;
+}
+
+} // namespace
+
+namespace modbus {
+
+std::chrono::microseconds frameSilence(const UART& uart, std::chrono::microseconds min_silence) {
+    // 3.5 character times, rounded up
+    auto silence = std::chrono::duration_cast<std::chrono::microseconds>(uart.getFrameTime() * 7 / 2 +
+                                                                          std::chrono::nanoseconds(999));
+    return std::max(silence, min_silence);
+}
+
+std::string functionToString(FunctionCode function) {
+    switch (function) {
+        case FunctionCode::READ_COILS: return "Read Coils";
+        case FunctionCode::READ_DISCRETE_INPUTS: return "Read Discrete Inputs";
+        case FunctionCode::READ_HOLDING_REGISTERS: return "Read Holding Registers";
+        case FunctionCode::READ_INPUT_REGISTERS: return "Read Input Registers";
+        case FunctionCode::WRITE_SINGLE_COIL: return "Write Single Coil";
+        case FunctionCode::WRITE_SINGLE_REGISTER: return "Write Single Register";
+        case FunctionCode::WRITE_MULTIPLE_COILS: return "Write Multiple Coils";
+        case FunctionCode::WRITE_MULTIPLE_REGISTERS: return "Write Multiple Registers";
+        default: return "Unknown";
+    }
+}
+
+std::string exceptionToString(ExceptionCode exception) {
+    switch (exception) {
+        case ExceptionCode::NONE: return "None";
+        case ExceptionCode::ILLEGAL_FUNCTION: return "Illegal Function";
+        case ExceptionCode::ILLEGAL_DATA_ADDRESS: return "Illegal Data Address";
+        case ExceptionCode::ILLEGAL_DATA_VALUE: return "Illegal Data Value";
+        case ExceptionCode::SLAVE_DEVICE_FAILURE: return "Slave Device Failure";
+        default: return "Unknown";
+    }
+}
+
+} // namespace modbus
+
+// ModbusRegisterMap
+
+bool ModbusRegisterMap::insertBlock(Table table, Block block) {
+    if (block.count == 0 || block.start + block.count > ADDRESS_SPACE) {
+        std::cerr << "Error: Modbus block " << block.start << "+" << block.count << " outside the address space"
+                  << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(map_mutex);
+    auto& blocks = tables[static_cast<int>(table)];
+    auto next = std::upper_bound(blocks.begin(), blocks.end(), block.start,
+                                 [](uint16_t start, const Block& existing) { return start < existing.start; });
+    bool overlaps_next = next != blocks.end() && block.start + block.count > next->start;
+    bool overlaps_prev = next != blocks.begin() && std::prev(next)->start + std::prev(next)->count > block.start;
+    if (overlaps_next || overlaps_prev) {
+        std::cerr << "Error: Modbus block at " << block.start << " overlaps an existing block" << std::endl;
+        return false;
+    }
+    blocks.insert(next, std::move(block));
+    return true;
+}
+
+bool ModbusRegisterMap::addRegisters(Table table, uint16_t start, uint16_t count) {
+    Block block{};
+    block.start = start;
+    block.count = count;
+    block.owned.reset(new uint16_t[count == 0 ? 1 : count]());
+    block.memory = block.owned.get();
+    return insertBlock(table, std::move(block));
+}
+
+bool ModbusRegisterMap::mapRegisters(Table table, uint16_t start, uint16_t count, volatile uint16_t* memory) {
+    if (!memory) {
+        std::cerr << "Error: Invalid Modbus register memory" << std::endl;
+        return false;
+    }
+    Block block{};
+    block.start = start;
+    block.count = count;
+    block.memory = memory;
+    return insertBlock(table, std::move(block));
+}
+
+bool ModbusRegisterMap::bindRegisters(Table table, uint16_t start, uint16_t count, ReadHandler read,
+                                      WriteHandler write) {
+    if (!read) {
+        std::cerr << "Error: Invalid Modbus read handler" << std::endl;
+        return false;
+    }
+    Block block{};
+    block.start = start;
+    block.count = count;
+    block.memory = nullptr;
+    block.read = std::move(read);
+    block.write = std::move(write);
+    return insertBlock(table, std::move(block));
+}
+
+template <typename Access>
+ExceptionCode ModbusRegisterMap::forEachSegmentLocked(Table table, uint16_t start, uint16_t count,
+                                                      Access access) const {
+    const auto& blocks = tables[static_cast<int>(table)];
+    auto first = std::upper_bound(blocks.begin(), blocks.end(), start,
+                                  [](uint16_t address, const Block& block) { return address < block.start; });
+    if (count == 0 || first == blocks.begin() || start + static_cast<uint32_t>(count) > ADDRESS_SPACE) {
+        return ExceptionCode::ILLEGAL_DATA_ADDRESS;
+    }
+    --first;
+
+    // Check the whole range first so a failed request changes nothing
+    uint32_t address = start;
+    uint32_t end = start + static_cast<uint32_t>(count);
+    for (auto block = first; address < end; ++block) {
+        bool contiguous = block == first || (block != blocks.end() && block->start == address);
+        if (!contiguous || address >= block->start + block->count) {
+            return ExceptionCode::ILLEGAL_DATA_ADDRESS;
+        }
+        address = block->start + block->count;
+    }
+
+    address = start;
+    size_t index = 0;
+    for (auto block = first; address < end; ++block) {
+        uint32_t offset = address - block->start;
+        uint32_t length = std::min(end, block->start + block->count) - address;
+        ExceptionCode result = access(*block, offset, length, index);
+        if (result != ExceptionCode::NONE) {
+            return result;
+        }
+        address += length;
+        index += length;
+    }
+    return ExceptionCode::NONE;
+}
+
+ExceptionCode ModbusRegisterMap::read(Table table, uint16_t start, uint16_t count, uint16_t* values) const {
+    bool bits = table == Table::COILS || table == Table::DISCRETE_INPUTS;
+    std::lock_guard<std::mutex> lock(map_mutex);
+    return forEachSegmentLocked(table, start, count, [&](const Block& block, uint32_t offset, uint32_t length,
+                                                         size_t index) {
+        for (uint32_t i = 0; i < length; ++i) {
+            uint16_t value = block.memory ? block.memory[offset + i]
+                                          : block.read(static_cast<uint16_t>(block.start + offset + i));
+            values[index + i] = bits ? static_cast<uint16_t>(value != 0) : value;
+        }
+        return ExceptionCode::NONE;
+    });
+}
+
+ExceptionCode ModbusRegisterMap::write(Table table, uint16_t start, uint16_t count, const uint16_t* values) {
+    bool bits = table == Table::COILS || table == Table::DISCRETE_INPUTS;
+    std::lock_guard<std::mutex> lock(map_mutex);
+    // Read-only blocks (bound without a write handler) fail the address check up front
+    ExceptionCode check = forEachSegmentLocked(table, start, count, [](const Block& block, uint32_t, uint32_t, size_t) {
+        return block.memory || block.write ? ExceptionCode::NONE : ExceptionCode::ILLEGAL_DATA_ADDRESS;
+    });
+    if (check != ExceptionCode::NONE) {
+        return check;
+    }
+    return forEachSegmentLocked(table, start, count, [&](const Block& block, uint32_t offset, uint32_t length,
+                                                         size_t index) {
+        for (uint32_t i = 0; i < length; ++i) {
+            uint16_t value = bits ? static_cast<uint16_t>(values[index + i] != 0) : values[index + i];
+            if (block.memory) {
+                block.memory[offset + i] = value;
+            } else if (!block.write(static_cast<uint16_t>(block.start + offset + i), value)) {
+                return ExceptionCode::SLAVE_DEVICE_FAILURE;
+            }
+        }
+        return ExceptionCode::NONE;
+    });
+}
+
+bool ModbusRegisterMap::setValue(Table table, uint16_t address, uint16_t value) {
+    return write(table, address, 1, &value) == ExceptionCode::NONE;
+}
+
+bool ModbusRegisterMap::getValue(Table table, uint16_t address, uint16_t& value) const {
+    return read(table, address, 1, &value) == ExceptionCode::NONE;
+}
+
+// ModbusSlave
+
+ModbusSlave::ModbusSlave(UART& uart, uint8_t address, ModbusRegisterMap& registers)
+    : uart(uart),
+      address(address),
+      registers(registers),
+      running(false),
+      requests(0),
+      exceptions(0),
+      crc_errors(0),
+      ignored(0),
+      frame{},
+      reply{},
+      values(modbus::MAX_READ_BITS) {
+}
+
+ModbusSlave::~ModbusSlave() {
+    stop();
+}
+
+bool ModbusSlave::start(std::chrono::microseconds min_silence) {
+    if (address == modbus::BROADCAST_ADDRESS || address > modbus::MAX_SLAVE_ADDRESS) {
+        std::cerr << "Error: Invalid Modbus slave address " << static_cast<int>(address) << std::endl;
+        return false;
+    }
+    UART::UARTConfig config = uart.getConfiguration();
+    if (config.rx_fifo_size < modbus::MAX_ADU_SIZE || config.tx_fifo_size < modbus::MAX_ADU_SIZE) {
+        std::cerr << "Error: UART '" << uart.getName() << "' FIFOs must hold " << modbus::MAX_ADU_SIZE
+                  << " bytes for Modbus" << std::endl;
+        return false;
+    }
+
+    // One delivery per frame: the buffer never fills before the t3.5 silence ends it
+    UART::RxDeliveryConfig delivery = UART::defaultRxDelivery();
+    delivery.threshold = config.rx_fifo_size;
+    delivery.idle_timeout = modbus::frameSilence(uart, min_silence);
+    if (!uart.setRxDelivery([this](const RingSpan<const uint8_t>& data) { onFrame(data); }, delivery)) {
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+bool ModbusSlave::stop() {
+    if (!running.exchange(false)) {
+        return true;
+    }
+    return uart.clearRxDelivery();
+}
+
+ModbusSlave::Statistics ModbusSlave::getStatistics() const {
+    return Statistics{requests.load(), exceptions.load(), crc_errors.load(), ignored.load()};
+}
+
+void ModbusSlave::onFrame(const RingSpan<const uint8_t>& data) {
+    if (data.empty() || !running.load(std::memory_order_relaxed)) {
+        return;
+    }
+    uint8_t target = data[0];
+    if (target != address && target != modbus::BROADCAST_ADDRESS) {
+        ignored.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (data.size() < MIN_ADU_SIZE || data.size() > modbus::MAX_ADU_SIZE) {
+        crc_errors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    size_t size = copyFrame(data, frame);
+    if (!crcValid(frame, size)) {
+        crc_errors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    requests.fetch_add(1, std::memory_order_relaxed);
+    size_t pdu_size = execute(frame + 1, size - 3, reply + 1);
+    if (reply[1] & EXCEPTION_FLAG) {
+        exceptions.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (target == modbus::BROADCAST_ADDRESS) {
+        return;
+    }
+    reply[0] = address;
+    size_t reply_size = appendCrc(reply, pdu_size + 1);
+    if (uart.write(Span<const uint8_t>(reply, reply_size)) != reply_size) {
+        std::cerr << "Error: Modbus slave " << static_cast<int>(address) << " could not queue its response" << std::endl;
+    }
+}
+
+size_t ModbusSlave::exceptionReply(uint8_t function, ExceptionCode exception, uint8_t* out) {
+    out[0] = static_cast<uint8_t>(function | EXCEPTION_FLAG);
+    out[1] = static_cast<uint8_t>(exception);
+    return 2;
+}
+
+size_t ModbusSlave::execute(const uint8_t* pdu, size_t size, uint8_t* out) {
+    using Table = ModbusRegisterMap::Table;
+    uint8_t function = pdu[0];
+    if (!isKnownFunction(function)) {
+        return exceptionReply(function, ExceptionCode::ILLEGAL_FUNCTION, out);
+    }
+    if (size < 5) {
+        return exceptionReply(function, ExceptionCode::ILLEGAL_DATA_VALUE, out);
+    }
+    uint16_t start = getWord(pdu + 1);
+    uint16_t count = getWord(pdu + 3);
+    ExceptionCode result = ExceptionCode::NONE;
+
+    switch (static_cast<FunctionCode>(function)) {
+        case FunctionCode::READ_COILS:
+        case FunctionCode::READ_DISCRETE_INPUTS: {
+            if (size != 5 || count == 0 || count > modbus::MAX_READ_BITS) {
+                return exceptionReply(function, ExceptionCode::ILLEGAL_DATA_VALUE, out);
+            }
+            Table table = function == 0x01 ? Table::COILS : Table::DISCRETE_INPUTS;
+            result = registers.read(table, start, count, values.data());
+            if (result != ExceptionCode::NONE) {
+                break;
+            }
+            out[0] = function;
+            out[1] = static_cast<uint8_t>((count + 7) / 8);
+            packBits(values.data(), count, out + 2);
+            return 2 + out[1];
+        }
+        case FunctionCode::READ_HOLDING_REGISTERS:
+        case FunctionCode::READ_INPUT_REGISTERS: {
+            if (size != 5 || count == 0 || count > modbus::MAX_READ_REGISTERS) {
+                return exceptionReply(function, ExceptionCode::ILLEGAL_DATA_VALUE, out);
+            }
+            Table table = function == 0x03 ? Table::HOLDING_REGISTERS : Table::INPUT_REGISTERS;
+            result = registers.read(table, start, count, values.data());
+            if (result != ExceptionCode::NONE) {
+                break;
+            }
+            out[0] = function;
+            out[1] = static_cast<uint8_t>(count * 2);
+            for (uint16_t i = 0; i < count; ++i) {
+                putWord(out + 2 + i * 2, values[i]);
+            }
+            return 2 + out[1];
+        }
+        case FunctionCode::WRITE_SINGLE_COIL: {
+            // count holds the output value: 0xFF00 on, 0x0000 off
+            if (size != 5 || (count != COIL_ON && count != 0)) {
+                return exceptionReply(function, ExceptionCode::ILLEGAL_DATA_VALUE, out);
+            }
+            uint16_t value = count == COIL_ON;
+            result = registers.write(Table::COILS, start, 1, &value);
+            break;
+        }
+        case FunctionCode::WRITE_SINGLE_REGISTER: {
+            if (size != 5) {
+                return exceptionReply(function, ExceptionCode::ILLEGAL_DATA_VALUE, out);
+            }
+            result = registers.write(Table::HOLDING_REGISTERS, start, 1, &count);
+            break;
+        }
+        case FunctionCode::WRITE_MULTIPLE_COILS: {
+            size_t bytes = (count + 7u) / 8u;
+            if (size < 6 || count == 0 || count > modbus::MAX_WRITE_BITS || pdu[5] != bytes || size != 6 + bytes) {
+                return exceptionReply(function, ExceptionCode::ILLEGAL_DATA_VALUE, out);
+            }
+            unpackBits(pdu + 6, count, values.data());
+            result = registers.write(Table::COILS, start, count, values.data());
+            break;
+        }
+        case FunctionCode::WRITE_MULTIPLE_REGISTERS: {
+            size_t bytes = count * 2u;
+            if (size < 6 || count == 0 || count > modbus::MAX_WRITE_REGISTERS || pdu[5] != bytes || size != 6 + bytes) {
+                return exceptionReply(function, ExceptionCode::ILLEGAL_DATA_VALUE, out);
+            }
+            for (uint16_t i = 0; i < count; ++i) {
+                values[i] = getWord(pdu + 6 + i * 2);
+            }
+            result = registers.write(Table::HOLDING_REGISTERS, start, count, values.data());
+            break;
+        }
+        default:
+            return exceptionReply(function, ExceptionCode::ILLEGAL_FUNCTION, out);
+    }
+
+    if (result != ExceptionCode::NONE) {
+        return exceptionReply(function, result, out);
+    }
+    // Writes echo the function, address and value / quantity
+    std::memcpy(out, pdu, 5);
+    return 5;
+}
+
+// ModbusMaster
+
+ModbusMaster::ModbusMaster(const Config& cfg)
+    : config(cfg),
+      running(false),
+      timer_wake(Clock::time_point::max()) {
+}
+
+ModbusMaster::~ModbusMaster() {
+    stop();
+}
+
+ModbusMaster::Config ModbusMaster::defaultConfig() {
+    Config cfg;
+    cfg.response_timeout = std::chrono::milliseconds(100);
+    cfg.broadcast_delay = std::chrono::microseconds(5000);
+    cfg.min_silence = modbus::SPEC_MIN_SILENCE;
+    cfg.retries = 1;
+    return cfg;
+}
+
+ModbusMaster::LinkId ModbusMaster::addLink(UART& uart) {
+    if (running.load()) {
+        std::cerr << "Error: Cannot add Modbus links while the master is running" << std::endl;
+        return INVALID_LINK;
+    }
+    UART::UARTConfig uart_config = uart.getConfiguration();
+    if (uart_config.rx_fifo_size < modbus::MAX_ADU_SIZE || uart_config.tx_fifo_size < modbus::MAX_ADU_SIZE) {
+        std::cerr << "Error: UART '" << uart.getName() << "' FIFOs must hold " << modbus::MAX_ADU_SIZE
+                  << " bytes for Modbus" << std::endl;
+        return INVALID_LINK;
+    }
+
+    std::lock_guard<std::mutex> lock(master_mutex);
+    for (const auto& link : links) {
+        if (link->uart == &uart) {
+            std::cerr << "Error: UART '" << uart.getName() << "' is already a Modbus link" << std::endl;
+            return INVALID_LINK;
+        }
+    }
+    std::unique_ptr<Link> link(new Link{});
+    link->uart = &uart;
+    link->id = static_cast<LinkId>(links.size() + 1);
+    link->rx_values.resize(modbus::MAX_READ_BITS);
+    links.push_back(std::move(link));
+    return links.back()->id;
+}
+
+bool ModbusMaster::start() {
+    if (running.load()) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(master_mutex);
+        for (auto& link : links) {
+            link->silence = modbus::frameSilence(*link->uart, config.min_silence);
+            link->frame_time = link->uart->getFrameTime();
+            link->in_flight = false;
+            link->retry_pending = false;
+            link->quiet_until = Clock::time_point();
+        }
+        start_time = Clock::now();
+        timer_wake = Clock::time_point::max();
+    }
+    for (auto& link : links) {
+        Link* target = link.get();
+        UART::RxDeliveryConfig delivery = UART::defaultRxDelivery();
+        delivery.threshold = link->uart->getConfiguration().rx_fifo_size;
+        delivery.idle_timeout = link->silence;
+        if (!link->uart->setRxDelivery([this, target](const RingSpan<const uint8_t>& data) { onResponse(*target, data); },
+                                       delivery)) {
+            for (auto& started : links) {
+                started->uart->clearRxDelivery();
+            }
+            return false;
+        }
+    }
+
+    running = true;
+    timer_thread = std::thread(&ModbusMaster::timerLoop, this);
+    return true;
+}
+
+bool ModbusMaster::stop() {
+    if (!running.exchange(false)) {
+        return true;
+    }
+    timer_cv.notify_all();
+    if (timer_thread.joinable()) {
+        timer_thread.join();
+    }
+    for (auto& link : links) {
+        link->uart->clearRxDelivery();
+    }
+
+    std::vector<Finished> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(master_mutex);
+        Clock::time_point now = Clock::now();
+        for (auto& link : links) {
+            if (link->in_flight) {
+                cancelled.emplace_back();
+                finishLocked(*link, Status::CANCELLED, ExceptionCode::NONE, Span<const uint16_t>(), now,
+                             cancelled.back());
+            }
+            while (!link->queue.empty()) {
+                link->current = std::move(link->queue.front());
+                link->queue.pop_front();
+                link->in_flight = true;
+                cancelled.emplace_back();
+                finishLocked(*link, Status::CANCELLED, ExceptionCode::NONE, Span<const uint16_t>(), now,
+                             cancelled.back());
+            }
+        }
+    }
+    for (auto& finished : cancelled) {
+        if (finished.completion) {
+            finished.completion(finished.result);
+        }
+    }
+    return true;
+}
+
+ModbusMaster::Link* ModbusMaster::findLink(LinkId id) const {
+    if (id == INVALID_LINK || id > links.size()) {
+        std::cerr << "Error: Invalid Modbus link " << id << std::endl;
+        return nullptr;
+    }
+    return links[id - 1].get();
+}
+
+size_t ModbusMaster::buildRequest(const Request& request, uint8_t* out) {
+    bool broadcast = request.slave == modbus::BROADCAST_ADDRESS;
+    if (request.slave > modbus::MAX_SLAVE_ADDRESS || (broadcast && !isWrite(request.function))) {
+        return 0;
+    }
+    out[0] = request.slave;
+    out[1] = static_cast<uint8_t>(request.function);
+    putWord(out + 2, request.address);
+    uint32_t end = request.address + static_cast<uint32_t>(request.count);
+
+    switch (request.function) {
+        case FunctionCode::READ_COILS:
+        case FunctionCode::READ_DISCRETE_INPUTS:
+            if (request.count == 0 || request.count > modbus::MAX_READ_BITS || end > ADDRESS_SPACE) {
+                return 0;
+            }
+            putWord(out + 4, request.count);
+            return appendCrc(out, 6);
+        case FunctionCode::READ_HOLDING_REGISTERS:
+        case FunctionCode::READ_INPUT_REGISTERS:
+            if (request.count == 0 || request.count > modbus::MAX_READ_REGISTERS || end > ADDRESS_SPACE) {
+                return 0;
+            }
+            putWord(out + 4, request.count);
+            return appendCrc(out, 6);
+        case FunctionCode::WRITE_SINGLE_COIL:
+        case FunctionCode::WRITE_SINGLE_REGISTER:
+            if (request.values.empty()) {
+                return 0;
+            }
+            putWord(out + 4, request.function == FunctionCode::WRITE_SINGLE_COIL
+                                 ? static_cast<uint16_t>(request.values[0] != 0 ? COIL_ON : 0)
+                                 : request.values[0]);
+            return appendCrc(out, 6);
+        case FunctionCode::WRITE_MULTIPLE_COILS:
+        case FunctionCode::WRITE_MULTIPLE_REGISTERS: {
+            bool bits = request.function == FunctionCode::WRITE_MULTIPLE_COILS;
+            uint16_t limit = bits ? modbus::MAX_WRITE_BITS : modbus::MAX_WRITE_REGISTERS;
+            if (request.count == 0 || request.count > limit || request.values.size() != request.count ||
+                end > ADDRESS_SPACE) {
+                return 0;
+            }
+            putWord(out + 4, request.count);
+            if (bits) {
+                out[6] = static_cast<uint8_t>((request.count + 7) / 8);
+                packBits(request.values.data(), request.count, out + 7);
+            } else {
+                out[6] = static_cast<uint8_t>(request.count * 2);
+                for (uint16_t i = 0; i < request.count; ++i) {
+                    putWord(out + 7 + i * 2, request.values[i]);
+                }
+            }
+            return appendCrc(out, 7 + out[6]);
+        }
+        default:
+            return 0;
+    }
+}
+
+bool ModbusMaster::submit(LinkId id, Request request, Completion completion) {
+    Link* link = findLink(id);
+    if (!link) {
+        return false;
+    }
+    uint8_t scratch[modbus::MAX_ADU_SIZE];
+    if (buildRequest(request, scratch) == 0) {
+        std::cerr << "Error: Invalid Modbus request (" << modbus::functionToString(request.function) << " to slave "
+                  << static_cast<int>(request.slave) << ")" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(master_mutex);
+    if (!running.load()) {
+        std::cerr << "Error: Modbus master not running" << std::endl;
+        return false;
+    }
+    Pending pending{std::move(request), std::move(completion), 0, Clock::time_point()};
+    link->queue.push_back(std::move(pending));
+    pumpLocked(*link, Clock::now());
+    return true;
+}
+
+bool ModbusMaster::readHoldingRegisters(LinkId link, uint8_t slave, uint16_t address, uint16_t count,
+                                        Completion completion) {
+    return submit(link, Request{slave, FunctionCode::READ_HOLDING_REGISTERS, address, count, {}},
+                  std::move(completion));
+}
+
+bool ModbusMaster::readInputRegisters(LinkId link, uint8_t slave, uint16_t address, uint16_t count,
+                                      Completion completion) {
+    return submit(link, Request{slave, FunctionCode::READ_INPUT_REGISTERS, address, count, {}},
+                  std::move(completion));
+}
+
+bool ModbusMaster::writeSingleRegister(LinkId link, uint8_t slave, uint16_t address, uint16_t value,
+                                       Completion completion) {
+    return submit(link, Request{slave, FunctionCode::WRITE_SINGLE_REGISTER, address, 1, {value}},
+                  std::move(completion));
+}
+
+bool ModbusMaster::writeMultipleRegisters(LinkId link, uint8_t slave, uint16_t address,
+                                          const std::vector<uint16_t>& values, Completion completion) {
+    return submit(link, Request{slave, FunctionCode::WRITE_MULTIPLE_REGISTERS, address,
+                                static_cast<uint16_t>(values.size()), values},
+                  std::move(completion));
+}
+
+void ModbusMaster::pumpLocked(Link& link, Clock::time_point now) {
+    if (link.in_flight || link.queue.empty() || !running.load()) {
+        return;
+    }
+    if (now < link.quiet_until) {
+        armTimerLocked(link.quiet_until);   // The timer sends it once the line has been quiet
+        return;
+    }
+    link.current = std::move(link.queue.front());
+    link.queue.pop_front();
+    link.in_flight = true;
+    link.request_size = buildRequest(link.current.request, link.request_frame);
+    sendLocked(link, now);
+}
+
+bool ModbusMaster::sendLocked(Link& link, Clock::time_point now) {
+    const Request& request = link.current.request;
+    if (link.current.attempts++ == 0) {
+        link.current.first_sent = now;
+        if (request.slave != modbus::BROADCAST_ADDRESS) {
+            slaveStatsLocked(link, request.slave).requests++;
+        }
+    }
+
+    // Deadlines start once the request has left the line
+    auto on_line = link.frame_time * static_cast<int64_t>(link.request_size);
+    link.expects_response = request.slave != modbus::BROADCAST_ADDRESS;
+    link.deadline = now + on_line + (link.expects_response
+                                         ? std::chrono::duration_cast<Clock::duration>(config.response_timeout)
+                                         : std::chrono::duration_cast<Clock::duration>(config.broadcast_delay));
+    link.busy_ns += static_cast<uint64_t>(on_line.count());
+    armTimerLocked(link.deadline);
+
+    if (link.uart->write(Span<const uint8_t>(link.request_frame, link.request_size)) != link.request_size) {
+        // Left to the response timeout and its retries
+        std::cerr << "Error: Modbus link " << link.id << " could not queue a request" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+ModbusMaster::SlaveStats& ModbusMaster::slaveStatsLocked(Link& link, uint8_t slave) {
+    auto& stats = link.slaves[slave];
+    if (!stats) {
+        stats.reset(new SlaveStats{});
+    }
+    return *stats;
+}
+
+void ModbusMaster::finishLocked(Link& link, Status status, ExceptionCode exception, Span<const uint16_t> values,
+                                Clock::time_point now, Finished& out) {
+    const Request& request = link.current.request;
+    out.result.status = status;
+    out.result.exception = exception;
+    out.result.slave = request.slave;
+    out.result.function = request.function;
+    out.result.values = values;
+    out.result.latency = link.current.attempts == 0
+                             ? std::chrono::microseconds(0)
+                             : std::chrono::duration_cast<std::chrono::microseconds>(now - link.current.first_sent);
+    out.result.attempts = link.current.attempts;
+    out.completion = std::move(link.current.completion);
+
+    if (status == Status::OK || status == Status::EXCEPTION) {
+        link.transactions++;
+        if (request.slave != modbus::BROADCAST_ADDRESS) {
+            SlaveStats& stats = slaveStatsLocked(link, request.slave);
+            float latency_us = std::chrono::duration<float, std::micro>(now - link.current.first_sent).count();
+            stats.responses++;
+            stats.exceptions += status == Status::EXCEPTION;
+            stats.latency_sum_us += latency_us;
+            stats.latency_us.update(latency_us);
+        }
+    }
+    link.in_flight = false;
+    link.retry_pending = false;   // A late response can complete a request awaiting its retry
+}
+
+void ModbusMaster::armTimerLocked(Clock::time_point when) {
+    if (when < timer_wake) {
+        timer_wake = when;
+        timer_cv.notify_one();
+    }
+}
+
+void ModbusMaster::onResponse(Link& link, const RingSpan<const uint8_t>& data) {
+    Finished finished;
+    {
+        std::lock_guard<std::mutex> lock(master_mutex);
+        if (!running.load()) {
+            return;
+        }
+        Clock::time_point now = Clock::now();
+        if (data.size() < MIN_ADU_SIZE + 1 || data.size() > modbus::MAX_ADU_SIZE || !link.in_flight ||
+            !link.expects_response) {
+            link.bad_frames++;
+            return;
+        }
+        uint8_t* frame = link.rx_frame;
+        size_t size = copyFrame(data, frame);
+        const Request& request = link.current.request;
+        uint8_t function = static_cast<uint8_t>(request.function);
+        if (!crcValid(frame, size) || frame[0] != request.slave || (frame[1] & ~EXCEPTION_FLAG) != function) {
+            // Not ours or damaged: the timeout retries
+            link.bad_frames++;
+            return;
+        }
+
+        size_t pdu_size = size - 3;
+        const uint8_t* pdu = frame + 1;
+        Status status = Status::OK;
+        ExceptionCode exception = ExceptionCode::NONE;
+        Span<const uint16_t> values;
+        if (pdu[0] & EXCEPTION_FLAG) {
+            if (pdu_size != 2) {
+                link.bad_frames++;
+                return;
+            }
+            status = Status::EXCEPTION;
+            exception = static_cast<ExceptionCode>(pdu[1]);
+        } else if (isWrite(request.function)) {
+            if (pdu_size != 5 || std::memcmp(pdu, link.request_frame + 1, 5) != 0) {
+                link.bad_frames++;
+                return;
+            }
+        } else {
+            bool bits = isBitFunction(request.function);
+            size_t expected = bits ? (request.count + 7u) / 8u : request.count * 2u;
+            if (pdu_size != 2 + expected || pdu[1] != expected) {
+                link.bad_frames++;
+                return;
+            }
+            uint16_t* out = link.rx_values.data();
+            if (bits) {
+                unpackBits(pdu + 2, request.count, out);
+            } else {
+                for (uint16_t i = 0; i < request.count; ++i) {
+                    out[i] = getWord(pdu + 2 + i * 2);
+                }
+            }
+            values = Span<const uint16_t>(out, request.count);
+        }
+
+        link.busy_ns += static_cast<uint64_t>((link.frame_time * static_cast<int64_t>(size)).count());
+        finishLocked(link, status, exception, values, now, finished);
+        // The response ended t3.5 ago: the line is free for the next request
+        pumpLocked(link, now);
+    }
+    if (finished.completion) {
+        finished.completion(finished.result);
+    }
+}
+
+void ModbusMaster::timerLoop() {
+    std::vector<Finished> done;
+    std::unique_lock<std::mutex> lock(master_mutex);
+    while (running.load()) {
+        Clock::time_point now = Clock::now();
+        Clock::time_point next = Clock::time_point::max();
+        for (auto& link : links) {
+            if (link->in_flight && now >= link->deadline) {
+                if (link->retry_pending) {
+                    // Quiet for t3.5 since the timeout: resend
+                    link->retry_pending = false;
+                    sendLocked(*link, now);
+                } else if (!link->expects_response) {
+                    // Broadcast turnaround over
+                    done.emplace_back();
+                    finishLocked(*link, Status::OK, ExceptionCode::NONE, Span<const uint16_t>(), now, done.back());
+                } else {
+                    // Timed out: leave t3.5 of silence before anything else goes out
+                    slaveStatsLocked(*link, link->current.request.slave).timeouts++;
+                    if (link->current.attempts <= config.retries) {
+                        link->retry_pending = true;
+                        link->deadline = now + link->silence;
+                    } else {
+                        link->quiet_until = now + link->silence;
+                        done.emplace_back();
+                        finishLocked(*link, Status::TIMEOUT, ExceptionCode::NONE, Span<const uint16_t>(), now,
+                                     done.back());
+                    }
+                }
+            }
+            pumpLocked(*link, now);
+            if (link->in_flight) {
+                next = std::min(next, link->deadline);
+            } else if (!link->queue.empty()) {
+                next = std::min(next, link->quiet_until);
+            }
+        }
+
+        if (!done.empty()) {
+            lock.unlock();
+            for (auto& finished : done) {
+                if (finished.completion) {
+                    finished.completion(finished.result);
+                }
+            }
+            done.clear();
+            lock.lock();
+            continue;
+        }
+
+        timer_wake = next;
+        if (next == Clock::time_point::max()) {
+            timer_cv.wait(lock);
+        } else {
+            timer_cv.wait_until(lock, next);
+        }
+    }
+    timer_wake = Clock::time_point::max();
+}
+
+ModbusMaster::SlaveStatistics ModbusMaster::getSlaveStatistics(LinkId id, uint8_t slave) const {
+    SlaveStatistics result{};
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    result.latency_min_us = result.latency_mean_us = result.latency_p50_us = nan;
+    result.latency_p99_us = result.latency_max_us = nan;
+    Link* link = findLink(id);
+    if (!link || slave > modbus::MAX_SLAVE_ADDRESS) {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(master_mutex);
+    const auto& stats = link->slaves[slave];
+    if (!stats) {
+        return result;
+    }
+    result.requests = stats->requests;
+    result.responses = stats->responses;
+    result.exceptions = stats->exceptions;
+    result.timeouts = stats->timeouts;
+    if (!stats->latency_us.empty()) {
+        result.latency_min_us = stats->latency_us.getMin();
+        result.latency_mean_us = static_cast<float>(stats->latency_sum_us / static_cast<double>(stats->responses));
+        result.latency_p50_us = stats->latency_us.quantile(0.5);
+        result.latency_p99_us = stats->latency_us.quantile(0.99);
+        result.latency_max_us = stats->latency_us.getMax();
+    }
+    return result;
+}
+
+ModbusMaster::LinkStatistics ModbusMaster::getLinkStatistics(LinkId id) const {
+    LinkStatistics result{};
+    Link* link = findLink(id);
+    if (!link) {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(master_mutex);
+    result.transactions = link->transactions;
+    result.bad_frames = link->bad_frames;
+    result.queued = link->queue.size() + (link->in_flight ? 1 : 0);
+    double elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start_time).count();
+    result.utilization = elapsed_ns > 0 ? std::min(1.0, static_cast<double>(link->busy_ns) / elapsed_ns) : 0.0;
+    return result;
+}
+
+void ModbusMaster::resetStatistics() {
+    std::lock_guard<std::mutex> lock(master_mutex);
+    for (auto& link : links) {
+        link->transactions = 0;
+        link->bad_frames = 0;
+        link->busy_ns = 0;
+        for (auto& stats : link->slaves) {
+            stats.reset();
+        }
+    }
+    start_time = Clock::now();
+}
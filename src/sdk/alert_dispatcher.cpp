@@ -0,0 +1,313 @@
+#include "sdk/alert_dispatcher.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+AlertDispatcher::AlertDispatcher(size_t queue_capacity, size_t worker_count)
+    : queue(std::max<size_t>(queue_capacity, 1), INVALID_SOURCE),
+      queue_head(0),
+      queue_count(0),
+      running(true),
+      stats{} {
+
+    worker_count = std::max<size_t>(worker_count, 1);
+    workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(&AlertDispatcher::workerLoop, this);
+    }
+}
+
+AlertDispatcher::~AlertDispatcher() {
+    {
+        std::lock_guard<std::mutex> lock(dispatch_mutex);
+        running = false;
+    }
+    dispatch_cv.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+std::shared_ptr<AlertDispatcher> AlertDispatcher::getDefault() {
+    static std::shared_ptr<AlertDispatcher> instance = std::make_shared<AlertDispatcher>();
+    return instance;
+}
+
+AlertDispatcher::AlertPolicy AlertDispatcher::defaultPolicy() {
+    AlertPolicy policy;
+    policy.hysteresis = 0.0f;
+    policy.debounce_samples = 1;
+    policy.min_interval = std::chrono::milliseconds(100);
+    return policy;
+}
+
+AlertDispatcher::SourceId AlertDispatcher::registerSource(const std::string& description,
+                                                          AlertCallback callback,
+                                                          std::chrono::milliseconds min_interval) {
+    if (!callback) {
+        std::cerr << "Error: Invalid alert callback" << std::endl;
+        return INVALID_SOURCE;
+    }
+
+    std::lock_guard<std::mutex> lock(dispatch_mutex);
+
+    Source source{};
+    source.description = description;
+    source.callback = std::move(callback);
+    source.min_interval = min_interval;
+    source.active = true;
+    source.next_allowed = std::chrono::steady_clock::now();
+
+    if (!free_ids.empty()) {
+        SourceId id = free_ids.back();
+        free_ids.pop_back();
+        sources[id - 1] = std::move(source);
+        return id;
+    }
+
+    sources.push_back(std::move(source));
+    return static_cast<SourceId>(sources.size());
+}
+
+bool AlertDispatcher::unregisterSource(SourceId id) {
+    std::unique_lock<std::mutex> lock(dispatch_mutex);
+    if (id == INVALID_SOURCE || id > sources.size() || !sources[id - 1].active) {
+        return false;
+    }
+
+    // Stable across the wait: registerSource() may grow the deque meanwhile,
+    // which never moves existing sources
+    Source& source = sources[id - 1];
+    source.active = false;
+
+    // Never wait on ourselves when called from inside an alert callback
+    if (!isWorkerThread()) {
+        idle_cv.wait(lock, [&source] { return !source.in_flight; });
+    }
+
+    // Queued/deferred entries are skipped by the workers; recycle the id once they are gone
+    deferred_ids.erase(std::remove(deferred_ids.begin(), deferred_ids.end(), id), deferred_ids.end());
+    source.deferred = false;
+    source.callback = nullptr;
+    if (!source.queued && !source.in_flight) {
+        free_ids.push_back(id);
+    }
+    return true;
+}
+
+bool AlertDispatcher::setMinInterval(SourceId id, std::chrono::milliseconds min_interval) {
+    if (min_interval.count() < 0) {
+        std::cerr << "Error: Alert interval must be non-negative" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(dispatch_mutex);
+    if (id == INVALID_SOURCE || id > sources.size() || !sources[id - 1].active) {
+        return false;
+    }
+    // Re-base the current wait on the new interval, so a deferred alert is
+    // released as if the last callback had been rate limited by it
+    Source& source = sources[id - 1];
+    source.next_allowed += min_interval - source.min_interval;
+    source.min_interval = min_interval;
+    dispatch_cv.notify_all();
+    return true;
+}
+
+bool AlertDispatcher::post(SourceId id, float value) {
+    std::lock_guard<std::mutex> lock(dispatch_mutex);
+    if (id == INVALID_SOURCE || id > sources.size() || !sources[id - 1].active) {
+        return false;
+    }
+
+    Source& source = sources[id - 1];
+    stats.posted++;
+
+    // Already waiting for delivery: fold into the pending callback
+    if (source.queued || source.deferred || source.in_flight) {
+        source.pending_count++;
+        source.latest_value = value;
+        stats.coalesced++;
+        if (source.in_flight && !source.deferred) {
+            source.deferred = true;
+            deferred_ids.push_back(id);
+        }
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < source.next_allowed) {
+        source.pending_count++;
+        source.latest_value = value;
+        source.deferred = true;
+        deferred_ids.push_back(id);
+        dispatch_cv.notify_one(); // Worker recomputes its wake-up time
+        return true;
+    }
+
+    if (!enqueueLocked(id)) {
+        source.dropped++;
+        stats.dropped++;
+        return false;
+    }
+
+    source.pending_count++;
+    source.latest_value = value;
+    dispatch_cv.notify_one();
+    return true;
+}
+
+bool AlertDispatcher::enqueueLocked(SourceId id) {
+    if (queue_count == queue.size()) {
+        return false;
+    }
+
+    queue[(queue_head + queue_count) % queue.size()] = id;
+    queue_count++;
+    sources[id - 1].queued = true;
+    stats.queue_high_water = std::max(stats.queue_high_water, queue_count);
+    return true;
+}
+
+void AlertDispatcher::promoteDeferredLocked(std::chrono::steady_clock::time_point now) {
+    for (size_t i = 0; i < deferred_ids.size();) {
+        Source& source = sources[deferred_ids[i] - 1];
+        if (!source.in_flight && now >= source.next_allowed) {
+            if (!enqueueLocked(deferred_ids[i])) {
+                break; // Queue full; retry on the next wake-up
+            }
+            source.deferred = false;
+            deferred_ids[i] = deferred_ids.back();
+            deferred_ids.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void AlertDispatcher::workerLoop() {
+    std::unique_lock<std::mutex> lock(dispatch_mutex);
+
+    while (running.load()) {
+        auto now = std::chrono::steady_clock::now();
+        promoteDeferredLocked(now);
+
+        if (queue_count == 0) {
+            // Sleep until new work arrives or the earliest deferred source is due
+            auto wake = now + std::chrono::seconds(1);
+            for (SourceId id : deferred_ids) {
+                const Source& source = sources[id - 1];
+                if (!source.in_flight) {
+                    wake = std::min(wake, source.next_allowed);
+                }
+            }
+            dispatch_cv.wait_until(lock, wake);
+            continue;
+        }
+
+        SourceId id = queue[queue_head];
+        queue_head = (queue_head + 1) % queue.size();
+        queue_count--;
+
+        Source& source = sources[id - 1];
+        source.queued = false;
+        if (!source.active) {
+            if (!source.in_flight && !source.deferred) {
+                free_ids.push_back(id);
+            }
+            continue;
+        }
+
+        size_t count = source.pending_count;
+        float value = source.latest_value;
+        source.pending_count = 0;
+        source.in_flight = true;
+        source.next_allowed = now + source.min_interval;
+        AlertCallback callback = source.callback;
+        std::string message = formatMessage(source.description, value, count);
+
+        lock.unlock();
+        bool failed = false;
+        try {
+            callback(value, message);
+        } catch (const std::exception& e) {
+            failed = true;
+            std::cerr << "Error in alert callback: " << e.what() << std::endl;
+        }
+        lock.lock();
+
+        Source& finished = sources[id - 1];
+        finished.in_flight = false;
+        stats.dispatched++;
+        if (failed) {
+            stats.callback_errors++;
+        }
+        if (!finished.active && !finished.queued && !finished.deferred) {
+            free_ids.push_back(id);
+        }
+        idle_cv.notify_all();
+    }
+}
+
+bool AlertDispatcher::isWorkerThread() const {
+    auto self = std::this_thread::get_id();
+    for (const auto& worker : workers) {
+        if (worker.get_id() == self) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string AlertDispatcher::formatMessage(const std::string& description, float value, size_t count) {
+    std::string message = description + ": " + std::to_string(value);
+    if (count > 1) {
+        message += " (" + std::to_string(count) + " occurrences)";
+    }
+    return message;
+}
+
+AlertDispatcher::Statistics AlertDispatcher::getStatistics() const {
+    std::lock_guard<std::mutex> lock(dispatch_mutex);
+    return stats;
+}
+
+size_t AlertDispatcher::getDroppedCount(SourceId id) const {
+    std::lock_guard<std::mutex> lock(dispatch_mutex);
+    if (id == INVALID_SOURCE || id > sources.size()) {
+        return 0;
+    }
+    return sources[id - 1].dropped;
+}
+
+ThresholdMonitor::Transition ThresholdMonitor::update(float value, float low, float high,
+                                                      const AlertDispatcher::AlertPolicy& policy) {
+    bool violating = (value < low) || (value > high);
+
+    if (!active) {
+        if (!violating) {
+            violation_streak = 0;
+            return Transition::NONE;
+        }
+        if (++violation_streak < std::max<uint32_t>(policy.debounce_samples, 1)) {
+            return Transition::NONE;
+        }
+        active = true;
+        return Transition::RAISED;
+    }
+
+    if (violating) {
+        return Transition::REPEATED;
+    }
+
+    // Clear only once the value is back inside the band by the hysteresis margin
+    if (value >= low + policy.hysteresis && value <= high - policy.hysteresis) {
+        active = false;
+        violation_streak = 0;
+        return Transition::CLEARED;
+    }
+    return Transition::HOLDING;
+}
@@ -0,0 +1,598 @@
+#include "sdk/anomaly_detector.h"
+#include "common/simd.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace {
+constexpr float MIN_STD = 1e-6f;          // Floor for constant (quantized) baselines
+constexpr size_t SUM_CHUNK = 256;         // Float lanes are flushed to double this often
+constexpr size_t TIMING_INTERVAL = 16;    // Blocks between cost measurements (clock reads are not free)
+
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+inline __m128 absPs(__m128 v) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+inline float horizontalSum(__m128 v) {
+    __m128 shuffled = _mm_movehl_ps(v, v);
+    __m128 sums = _mm_add_ps(v, shuffled);
+    sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(sums);
+}
+
+inline float horizontalMax(__m128 v) {
+    __m128 m = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(m);
+}
+
+#endif
+
+struct BlockScan {
+    double sum;             // Of x - reference
+    double sum_squares;
+    size_t band_count;      // |x - center| > band
+    size_t band_first;
+    float max_deviation;
+    size_t step_count;      // |x[i] - x[i-1]| > step_limit
+    size_t step_first;
+    float max_step;
+};
+
+inline void flagLanes(int mask, size_t base, size_t& count, size_t& first) {
+    if (mask) {
+        count += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+        first = std::min(first, base + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask))));
+    }
+}
+
+// One pass over the block: baseline sums, band violations and step violations
+// (x[-1] = previous). Pass an infinite band or step_limit to disable a check.
+void scanBlock(const float* x, size_t n, float reference, float previous, float center,
+               float band, float step_limit, BlockScan& out) {
+    out = BlockScan{};
+    out.band_first = n;
+    out.step_first = n;
+    size_t i = 0;
+
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+    const __m128 r = _mm_set1_ps(reference);
+    const __m128 c = _mm_set1_ps(center);
+    const __m128 b = _mm_set1_ps(band);
+    const __m128 limit = _mm_set1_ps(step_limit);
+    __m128 peak = _mm_setzero_ps();
+    __m128 peak_step = _mm_setzero_ps();
+    __m128 acc = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    __m128 last = _mm_set1_ps(previous);   // Lane 3 holds the sample before the vector
+    size_t flush = SUM_CHUNK;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        // [x[i-1], x[i], x[i+1], x[i+2]]
+        __m128 before = _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)),
+                                    _mm_shuffle_ps(last, last, _MM_SHUFFLE(3, 3, 3, 3)));
+        last = v;
+
+        __m128 d = _mm_sub_ps(v, r);
+        acc = _mm_add_ps(acc, d);
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(d, d));
+
+        __m128 deviation = absPs(_mm_sub_ps(v, c));
+        peak = _mm_max_ps(peak, deviation);
+        flagLanes(_mm_movemask_ps(_mm_cmpgt_ps(deviation, b)), i, out.band_count, out.band_first);
+
+        __m128 step = absPs(_mm_sub_ps(v, before));
+        peak_step = _mm_max_ps(peak_step, step);
+        flagLanes(_mm_movemask_ps(_mm_cmpgt_ps(step, limit)), i, out.step_count, out.step_first);
+
+        if (i + 4 >= flush) {
+            out.sum += horizontalSum(acc);
+            out.sum_squares += horizontalSum(acc2);
+            acc = _mm_setzero_ps();
+            acc2 = _mm_setzero_ps();
+            flush += SUM_CHUNK;
+        }
+    }
+    out.sum += horizontalSum(acc);
+    out.sum_squares += horizontalSum(acc2);
+    out.max_deviation = horizontalMax(peak);
+    out.max_step = horizontalMax(peak_step);
+    if (i > 0) {
+        previous = x[i - 1];
+    }
+#endif
+
+    for (; i < n; ++i) {
+        float d = x[i] - reference;
+        out.sum += d;
+        out.sum_squares += static_cast<double>(d) * d;
+
+        float deviation = std::fabs(x[i] - center);
+        out.max_deviation = std::max(out.max_deviation, deviation);
+        if (deviation > band) {
+            out.band_count++;
+            out.band_first = std::min(out.band_first, i);
+        }
+
+        float step = std::fabs(x[i] - previous);
+        out.max_step = std::max(out.max_step, step);
+        if (step > step_limit) {
+            out.step_count++;
+            out.step_first = std::min(out.step_first, i);
+        }
+        previous = x[i];
+    }
+}
+
+// Two-sided CUSUM: high = max(0, high + (x - mean) - slack), low likewise on
+// -(x - mean). Returns the first index where either exceeds threshold (both
+// statistics hold their values there), or n with the statistics at the end.
+//
+// Vector form: with prefix_i the prefix sum of the increments in the vector and
+// minimum_i its running minimum, s_i = (s + prefix_i) - min(0, s + minimum_i).
+// Both scans are independent of the carried s, so the loop-carried chain is
+// an add, a min, a subtract and a broadcast; the two sides interleave.
+size_t cusumScan(const float* x, size_t n, float mean, float slack, float threshold, float& high, float& low) {
+    size_t i = 0;
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+    const __m128 m = _mm_set1_ps(mean);
+    const __m128 k = _mm_set1_ps(slack);
+    const __m128 h = _mm_set1_ps(threshold);
+    const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    const __m128 zero = _mm_setzero_ps();
+
+    auto scan = [&](__m128 d, __m128 carried) {
+        __m128 prefix = _mm_add_ps(d, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(d), 4)));
+        prefix = _mm_add_ps(prefix, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(prefix), 8)));
+        __m128 minimum = _mm_min_ps(prefix, _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(prefix), 4)), inf));
+        minimum = _mm_min_ps(minimum, _mm_movelh_ps(inf, minimum));
+        return _mm_sub_ps(_mm_add_ps(carried, prefix), _mm_min_ps(_mm_add_ps(carried, minimum), zero));
+    };
+
+    __m128 high_carry = _mm_set1_ps(high);
+    __m128 low_carry = _mm_set1_ps(low);
+    for (; i + 4 <= n; i += 4) {
+        __m128 centered = _mm_sub_ps(_mm_loadu_ps(x + i), m);
+        __m128 up = scan(_mm_sub_ps(centered, k), high_carry);
+        __m128 down = scan(_mm_sub_ps(_mm_sub_ps(zero, centered), k), low_carry);
+
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(up, h)) | _mm_movemask_ps(_mm_cmpgt_ps(down, h));
+        if (mask) {
+            int lane = __builtin_ctz(static_cast<unsigned>(mask));
+            alignas(16) float up_lanes[4];
+            alignas(16) float down_lanes[4];
+            _mm_store_ps(up_lanes, up);
+            _mm_store_ps(down_lanes, down);
+            high = up_lanes[lane];
+            low = down_lanes[lane];
+            return i + static_cast<size_t>(lane);
+        }
+        high_carry = _mm_shuffle_ps(up, up, _MM_SHUFFLE(3, 3, 3, 3));
+        low_carry = _mm_shuffle_ps(down, down, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    high = _mm_cvtss_f32(high_carry);
+    low = _mm_cvtss_f32(low_carry);
+#endif
+    for (; i < n; ++i) {
+        float centered = x[i] - mean;
+        high = std::max(0.0f, high + centered - slack);
+        low = std::max(0.0f, low - centered - slack);
+        if (high > threshold || low > threshold) {
+            return i;
+        }
+    }
+    return n;
+}
+}
+
+AnomalyDetector::AnomalyDetector(const std::string& detector_name, const Config& cfg,
+                                 std::shared_ptr<AlertDispatcher> dispatcher)
+    : name(detector_name),
+      config(cfg),
+      block_time{},
+      baseline_pos(0),
+      baseline_filled(0),
+      baseline_sum(0.0),
+      baseline_sum_squares(0.0),
+      reference(0.0f),
+      has_reference(false),
+      previous_value(0.0f),
+      has_previous(false),
+      cusum_high(0.0f),
+      cusum_low(0.0f),
+      sample_rate(0.0f),
+      max_step(0.0f),
+      active{},
+      latest_event{},
+      has_event(false),
+      stats{},
+      total_ns(0.0),
+      timed_samples(0),
+      alert_dispatcher(dispatcher ? std::move(dispatcher) : AlertDispatcher::getDefault()),
+      alert_sources{},
+      sensor(nullptr),
+      subscription(Sensor::SampleStreamType::INVALID_SUBSCRIBER) {
+
+    if (config.block_size == 0 || config.block_size > MAX_BLOCK_SIZE) {
+        std::cerr << "Warning: Anomaly block size must be between 1-" << MAX_BLOCK_SIZE
+                  << ", using 256" << std::endl;
+        config.block_size = 256;
+    }
+    size_t blocks = std::max<size_t>((config.window + config.block_size - 1) / config.block_size, 1);
+    if (blocks * config.block_size != config.window) {
+        std::cerr << "Warning: Anomaly baseline window rounded up to " << blocks * config.block_size
+                  << " samples (whole blocks)" << std::endl;
+        config.window = blocks * config.block_size;
+    }
+    config.z_threshold = std::max(config.z_threshold, 0.0f);
+    config.max_rate = std::max(config.max_rate, 0.0f);
+    config.cusum_slack = std::max(config.cusum_slack, 0.0f);
+    config.cusum_threshold = std::max(config.cusum_threshold, 0.0f);
+
+    block.reserve(config.block_size);
+    baseline_blocks.assign(blocks, BlockSums{0.0, 0.0});
+    configureRateLocked(config.sample_rate_hz);
+}
+
+AnomalyDetector::~AnomalyDetector() {
+    detach();
+    disableAlerts();
+}
+
+AnomalyDetector::Config AnomalyDetector::defaultConfig() {
+    Config cfg;
+    cfg.window = 4096;
+    cfg.block_size = 256;
+    cfg.z_threshold = 5.0f;
+    cfg.max_rate = 0.0f;          // Units depend on the sensor
+    cfg.cusum_slack = 0.5f;
+    cfg.cusum_threshold = 12.0f;  // ~1e6 samples between false alarms on Gaussian noise
+    cfg.sample_rate_hz = 0.0f;
+    return cfg;
+}
+
+bool AnomalyDetector::attach(Sensor& source) {
+    {
+        std::lock_guard<std::mutex> lock(detector_mutex);
+        if (sensor) {
+            std::cerr << "Error: Anomaly detector '" << name << "' already attached to '"
+                      << sensor->getName() << "'" << std::endl;
+            return false;
+        }
+        configureRateLocked(config.sample_rate_hz > 0.0f ? config.sample_rate_hz
+                                                         : static_cast<float>(source.getSamplingRate()));
+        sensor = &source;
+    }
+
+    Sensor::SubscriberId id = source.subscribe(
+        config.block_size, std::chrono::microseconds(100000),
+        [this](const RingSpan<const Sensor::SensorData>& batch, uint64_t) {
+            std::vector<std::pair<AlertDispatcher::SourceId, float>> alerts;
+            std::shared_ptr<AlertDispatcher> dispatcher;
+            {
+                std::lock_guard<std::mutex> lock(detector_mutex);
+                batch.forEachSegment([&](Span<const Sensor::SensorData> segment) {
+                    for (const auto& sample : segment) {
+                        pushLocked(sample.calibrated_value, sample.timestamp, alerts);
+                    }
+                });
+                dispatcher = alert_dispatcher;
+            }
+            for (const auto& alert : alerts) {
+                dispatcher->post(alert.first, alert.second);
+            }
+        });
+
+    std::lock_guard<std::mutex> lock(detector_mutex);
+    if (id == Sensor::SampleStreamType::INVALID_SUBSCRIBER) {
+        sensor = nullptr;
+        return false;
+    }
+    subscription = id;
+    return true;
+}
+
+bool AnomalyDetector::detach() {
+    Sensor* source;
+    Sensor::SubscriberId id;
+    {
+        std::lock_guard<std::mutex> lock(detector_mutex);
+        if (!sensor) {
+            return false;
+        }
+        source = sensor;
+        id = subscription;
+        sensor = nullptr;
+        subscription = Sensor::SampleStreamType::INVALID_SUBSCRIBER;
+    }
+
+    // Unsubscribe unlocked: it waits for an in-flight batch that takes detector_mutex
+    source->unsubscribe(id);
+    return true;
+}
+
+bool AnomalyDetector::isAttached() const {
+    std::lock_guard<std::mutex> lock(detector_mutex);
+    return sensor != nullptr;
+}
+
+bool AnomalyDetector::enableAlerts(AlertCallback callback, std::chrono::milliseconds min_interval) {
+    if (!callback) {
+        std::cerr << "Error: Invalid callback function" << std::endl;
+        return false;
+    }
+
+    AlertDispatcher::SourceId sources[DETECTOR_COUNT] = {};
+    for (size_t d = 0; d < DETECTOR_COUNT; ++d) {
+        sources[d] = alert_dispatcher->registerSource(
+            "Anomaly detector '" + name + "' " + detectorToString(static_cast<Detector>(d)) + " anomaly",
+            callback, min_interval);
+        if (sources[d] == AlertDispatcher::INVALID_SOURCE) {
+            for (size_t r = 0; r < d; ++r) {
+                alert_dispatcher->unregisterSource(sources[r]);
+            }
+            return false;
+        }
+    }
+
+    AlertDispatcher::SourceId previous[DETECTOR_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(detector_mutex);
+        for (size_t d = 0; d < DETECTOR_COUNT; ++d) {
+            previous[d] = alert_sources[d];
+            alert_sources[d] = sources[d];
+        }
+    }
+
+    for (size_t d = 0; d < DETECTOR_COUNT; ++d) {
+        if (previous[d] != AlertDispatcher::INVALID_SOURCE) {
+            alert_dispatcher->unregisterSource(previous[d]);
+        }
+    }
+    return true;
+}
+
+bool AnomalyDetector::disableAlerts() {
+    AlertDispatcher::SourceId previous[DETECTOR_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(detector_mutex);
+        for (size_t d = 0; d < DETECTOR_COUNT; ++d) {
+            previous[d] = alert_sources[d];
+            alert_sources[d] = AlertDispatcher::INVALID_SOURCE;
+        }
+    }
+
+    // Unregister unlocked: it waits for an in-flight callback
+    for (size_t d = 0; d < DETECTOR_COUNT; ++d) {
+        if (previous[d] != AlertDispatcher::INVALID_SOURCE) {
+            alert_dispatcher->unregisterSource(previous[d]);
+        }
+    }
+    return true;
+}
+
+size_t AnomalyDetector::process(const float* values, size_t count, float sample_rate_hz) {
+    if (!values || sample_rate_hz <= 0.0f) {
+        std::cerr << "Error: Invalid anomaly detector input" << std::endl;
+        return 0;
+    }
+
+    std::vector<std::pair<AlertDispatcher::SourceId, float>> alerts;
+    size_t anomalies = 0;
+    {
+        std::lock_guard<std::mutex> lock(detector_mutex);
+        if (sample_rate_hz != sample_rate) {
+            configureRateLocked(sample_rate_hz);
+        }
+
+        // Fill the pending block in bulk; recorded data shares one timestamp
+        auto now = std::chrono::steady_clock::now();
+        size_t i = 0;
+        while (i < count) {
+            size_t take = std::min(count - i, config.block_size - block.size());
+            block.insert(block.end(), values + i, values + i + take);
+            block_time = now;
+            i += take;
+            if (block.size() == config.block_size) {
+                anomalies += evaluateBlockLocked(alerts);
+            }
+        }
+    }
+
+    for (const auto& alert : alerts) {
+        alert_dispatcher->post(alert.first, alert.second);
+    }
+    return anomalies;
+}
+
+bool AnomalyDetector::readLatestEvent(Event& event) const {
+    std::lock_guard<std::mutex> lock(detector_mutex);
+    if (!has_event) {
+        return false;
+    }
+    event = latest_event;
+    return true;
+}
+
+AnomalyDetector::Statistics AnomalyDetector::getStatistics() const {
+    std::lock_guard<std::mutex> lock(detector_mutex);
+    return stats;
+}
+
+void AnomalyDetector::reset() {
+    std::lock_guard<std::mutex> lock(detector_mutex);
+    block.clear();
+    std::fill(baseline_blocks.begin(), baseline_blocks.end(), BlockSums{0.0, 0.0});
+    baseline_pos = 0;
+    baseline_filled = 0;
+    baseline_sum = 0.0;
+    baseline_sum_squares = 0.0;
+    has_reference = false;
+    has_previous = false;
+    cusum_high = 0.0f;
+    cusum_low = 0.0f;
+    std::fill(std::begin(active), std::end(active), false);
+    has_event = false;
+    stats = Statistics{};
+    total_ns = 0.0;
+    timed_samples = 0;
+}
+
+void AnomalyDetector::configureRateLocked(float rate_hz) {
+    sample_rate = rate_hz;
+    max_step = (rate_hz > 0.0f && config.max_rate > 0.0f) ? config.max_rate / rate_hz : 0.0f;
+}
+
+size_t AnomalyDetector::pushLocked(float value, std::chrono::steady_clock::time_point timestamp,
+                                   std::vector<std::pair<AlertDispatcher::SourceId, float>>& alerts) {
+    block.push_back(value);
+    block_time = timestamp;
+    if (block.size() < config.block_size) {
+        return 0;
+    }
+    return evaluateBlockLocked(alerts);
+}
+
+size_t AnomalyDetector::evaluateBlockLocked(std::vector<std::pair<AlertDispatcher::SourceId, float>>& alerts) {
+    bool timed = (stats.blocks_processed % TIMING_INTERVAL) == 0;
+    auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    const float* x = block.data();
+    const size_t n = block.size();
+    bool flagged[DETECTOR_COUNT] = {};
+    size_t anomalies = 0;
+
+    if (!has_reference) {
+        reference = x[0];
+        has_reference = true;
+    }
+
+    // Baseline statistics of the window preceding this block
+    bool baseline_ready = (baseline_filled == baseline_blocks.size());
+    float mean = reference;
+    float std_dev = MIN_STD;
+    if (baseline_ready) {
+        double count = static_cast<double>(config.window);
+        double m = baseline_sum / count;
+        double variance = std::max(baseline_sum_squares / count - m * m, 0.0);
+        mean = reference + static_cast<float>(m);
+        std_dev = std::max(static_cast<float>(std::sqrt(variance)), MIN_STD);
+    }
+
+    const float inf = std::numeric_limits<float>::infinity();
+    bool z_enabled = baseline_ready && config.z_threshold > 0.0f;
+    BlockScan scan;
+    // The first sample ever has no predecessor: compare it with itself
+    scanBlock(x, n, reference, has_previous ? previous_value : x[0], mean,
+              z_enabled ? config.z_threshold * std_dev : inf,
+              max_step > 0.0f ? max_step : inf, scan);
+
+    if (scan.band_count > 0) {
+        raiseLocked(Detector::Z_SCORE, scan.band_first, scan.max_deviation / std_dev, scan.band_count, alerts);
+        flagged[static_cast<size_t>(Detector::Z_SCORE)] = true;
+        anomalies += scan.band_count;
+    }
+
+    if (scan.step_count > 0) {
+        raiseLocked(Detector::RATE_OF_CHANGE, scan.step_first, scan.max_step * sample_rate, scan.step_count, alerts);
+        flagged[static_cast<size_t>(Detector::RATE_OF_CHANGE)] = true;
+        anomalies += scan.step_count;
+    }
+
+    if (baseline_ready && config.cusum_threshold > 0.0f) {
+        float slack = config.cusum_slack * std_dev;
+        float threshold = config.cusum_threshold * std_dev;
+        size_t count = 0;
+        size_t first = n;
+        float peak = 0.0f;
+        size_t i = 0;
+        while (i < n) {
+            size_t hit = cusumScan(x + i, n - i, mean, slack, threshold, cusum_high, cusum_low);
+            if (hit == n - i) {
+                break;
+            }
+            // Alarm: restart the statistic that crossed after the offending sample
+            count++;
+            first = std::min(first, i + hit);
+            peak = std::max({peak, cusum_high, cusum_low});
+            if (cusum_high > threshold) cusum_high = 0.0f;
+            if (cusum_low > threshold) cusum_low = 0.0f;
+            i += hit + 1;
+        }
+        if (count > 0) {
+            raiseLocked(Detector::CUSUM, first, peak / std_dev, count, alerts);
+            flagged[static_cast<size_t>(Detector::CUSUM)] = true;
+            anomalies += count;
+        }
+    }
+
+    for (size_t d = 0; d < DETECTOR_COUNT; ++d) {
+        active[d] = flagged[d];
+    }
+
+    previous_value = x[n - 1];
+    has_previous = true;
+    updateBaselineLocked(BlockSums{scan.sum, scan.sum_squares});
+
+    stats.samples_processed += n;
+    stats.blocks_processed++;
+    if (timed) {
+        total_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        timed_samples += n;
+        stats.ns_per_sample = total_ns / static_cast<double>(timed_samples);
+    }
+
+    block.clear();
+    return anomalies;
+}
+
+void AnomalyDetector::updateBaselineLocked(const BlockSums& sums) {
+    // The block replaces the oldest block of the window (exactly the sums added earlier)
+    BlockSums& slot = baseline_blocks[baseline_pos];
+    if (baseline_filled == baseline_blocks.size()) {
+        baseline_sum -= slot.sum;
+        baseline_sum_squares -= slot.sum_squares;
+    } else {
+        baseline_filled++;
+    }
+    slot = sums;
+    baseline_sum += sums.sum;
+    baseline_sum_squares += sums.sum_squares;
+    baseline_pos = (baseline_pos + 1) % baseline_blocks.size();
+}
+
+void AnomalyDetector::raiseLocked(Detector detector, size_t index, float score, size_t count,
+                                  std::vector<std::pair<AlertDispatcher::SourceId, float>>& alerts) {
+    size_t d = static_cast<size_t>(detector);
+    stats.anomalies[d] += count;
+    if (active[d]) {
+        return; // Still inside the anomaly that was already reported
+    }
+
+    // Samples are evenly spaced back from the newest one in the block
+    latest_event.timestamp = block_time;
+    if (sample_rate > 0.0f) {
+        latest_event.timestamp -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(block.size() - 1 - index) / sample_rate));
+    }
+    latest_event.detector = detector;
+    latest_event.value = block[index];
+    latest_event.score = score;
+    has_event = true;
+    stats.events[d]++;
+
+    if (alert_sources[d] != AlertDispatcher::INVALID_SOURCE) {
+        alerts.emplace_back(alert_sources[d], block[index]);
+    }
+}
+
+std::string AnomalyDetector::detectorToString(Detector detector) {
+    switch (detector) {
+        case Detector::Z_SCORE: return "Z-Score";
+        case Detector::RATE_OF_CHANGE: return "Rate of Change";
+        case Detector::CUSUM: return "CUSUM";
+        default: return "Unknown";
+    }
+}
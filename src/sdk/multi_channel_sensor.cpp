@@ -0,0 +1,641 @@
+#include "sdk/multi_channel_sensor.h"
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MultiChannelSensor::MultiChannelSensor(const std::string& name, SensorType type, size_t channels)
+    : Peripheral(name),
+      sensor_type(type),
+      channel_count(std::clamp<size_t>(channels, 1, MAX_CHANNELS)),
+      sampling_enabled(false),
+      sampling_rate_hz(10),
+      buffer_index(0),
+      frames_stored(0),
+      filter_type(FilterType::NONE),
+      filter_window_size(5),
+      filter_position(0),
+      filter_filled(0),
+      filter_primed(false),
+      sample_count(0),
+      alerts_enabled(false),
+      alert_dispatcher(AlertDispatcher::getDefault()),
+      alert_policy(AlertDispatcher::defaultPolicy()),
+      sampling_running(false) {
+
+    if (channels != channel_count) {
+        std::cerr << "Warning: Channel count for '" << name << "' clamped to " << channel_count << std::endl;
+    }
+
+    for (size_t ch = 0; ch < MAX_CHANNELS; ++ch) {
+        calibration_offset.v[ch] = 0.0f;
+        calibration_scale.v[ch] = 1.0f;
+        low_threshold.v[ch] = std::numeric_limits<float>::lowest();
+        high_threshold.v[ch] = std::numeric_limits<float>::max();
+    }
+    alert_sources.fill(AlertDispatcher::INVALID_SOURCE);
+
+    frame_buffer.resize(1000);
+    frame_stream = std::make_unique<FrameStreamType>(1024);
+    resetFilterLocked();
+    resetStatisticsLocked();
+}
+
+MultiChannelSensor::~MultiChannelSensor() {
+    if (initialized) {
+        cleanup();
+    }
+}
+
+bool MultiChannelSensor::initialize() {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+
+    sampling_enabled = false;
+    buffer_index = 0;
+    frames_stored = 0;
+    resetFilterLocked();
+    resetStatisticsLocked();
+
+    if (!writeToDeviceFile(formatDeviceData())) {
+        std::cerr << "Error: Failed to initialize MultiChannelSensor device file" << std::endl;
+        return false;
+    }
+
+    initialized = true;
+    std::cout << "MultiChannelSensor '" << device_name << "' (" << Sensor::sensorTypeToString(sensor_type)
+              << ", " << channel_count << " channels, " << simd::backendName()
+              << ") initialized successfully" << std::endl;
+    return true;
+}
+
+bool MultiChannelSensor::cleanup() {
+    // Both may wait on other threads, so run them unlocked
+    stopSampling();
+    disableAlerts();
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    buffer_index = 0;
+    frames_stored = 0;
+    writeToDeviceFile(formatDeviceData());
+
+    initialized = false;
+    std::cout << "MultiChannelSensor '" << device_name << "' cleaned up" << std::endl;
+    return true;
+}
+
+std::string MultiChannelSensor::getStatus() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    std::stringstream ss;
+
+    ss << "MultiChannelSensor '" << device_name << "' (" << Sensor::sensorTypeToString(sensor_type)
+       << " x" << channel_count << ") - ";
+    ss << "Sampling: " << (sampling_enabled.load() ? "ON" : "OFF") << ", ";
+    ss << "Rate: " << sampling_rate_hz.load() << "Hz, ";
+    ss << "Filter: " << Sensor::filterTypeToString(filter_type) << ", ";
+    ss << "Frames: " << sample_count << "/" << frame_buffer.size();
+
+    if (sample_count > 0) {
+        ss << ", Avg: [";
+        for (size_t ch = 0; ch < channel_count; ++ch) {
+            ss << (ch ? ", " : "") << stat_mean.v[ch];
+        }
+        ss << "]";
+    }
+
+    if (alerts_enabled.load()) {
+        ss << ", Alerts: ENABLED";
+    }
+
+    return ss.str();
+}
+
+bool MultiChannelSensor::setSamplingRate(int hz) {
+    if (hz < 1 || hz > 10000) {
+        std::cerr << "Error: Sampling rate must be between 1-10000 Hz" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (sampling_enabled.load()) {
+        std::cerr << "Error: Cannot change sampling rate while sampling" << std::endl;
+        return false;
+    }
+    sampling_rate_hz = hz;
+    return true;
+}
+
+bool MultiChannelSensor::setBufferSize(size_t frames) {
+    if (frames < 10 || frames > 100000) {
+        std::cerr << "Error: Buffer size must be between 10-100000 frames" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    frame_buffer.resize(frames);
+    buffer_index = 0;
+    frames_stored = 0;
+    return true;
+}
+
+size_t MultiChannelSensor::getBufferSize() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return frame_buffer.size();
+}
+
+bool MultiChannelSensor::setFilter(FilterType type, int window_size) {
+    if (window_size < 1 || window_size > 100) {
+        std::cerr << "Error: Filter window size must be between 1-100" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    filter_type = type;
+    filter_window_size = window_size;
+    resetFilterLocked();
+    return true;
+}
+
+MultiChannelSensor::FilterType MultiChannelSensor::getFilterType() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return filter_type;
+}
+
+bool MultiChannelSensor::setCalibration(const std::vector<float>& offsets, const std::vector<float>& scales) {
+    if (offsets.size() != channel_count || scales.size() != channel_count) {
+        std::cerr << "Error: Calibration vectors must have " << channel_count << " entries" << std::endl;
+        return false;
+    }
+    if (std::find(scales.begin(), scales.end(), 0.0f) != scales.end()) {
+        std::cerr << "Error: Calibration scale cannot be zero" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    std::copy(offsets.begin(), offsets.end(), calibration_offset.v);
+    std::copy(scales.begin(), scales.end(), calibration_scale.v);
+    return true;
+}
+
+bool MultiChannelSensor::setChannelCalibration(size_t channel, float offset, float scale) {
+    if (channel >= channel_count) {
+        std::cerr << "Error: Invalid channel " << channel << std::endl;
+        return false;
+    }
+    if (scale == 0.0f) {
+        std::cerr << "Error: Calibration scale cannot be zero" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    calibration_offset.v[channel] = offset;
+    calibration_scale.v[channel] = scale;
+    return true;
+}
+
+bool MultiChannelSensor::setThresholds(const std::vector<float>& low, const std::vector<float>& high) {
+    if (low.size() != channel_count || high.size() != channel_count) {
+        std::cerr << "Error: Threshold vectors must have " << channel_count << " entries" << std::endl;
+        return false;
+    }
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        if (low[ch] >= high[ch]) {
+            std::cerr << "Error: Low threshold must be less than high threshold (channel "
+                      << ch << ")" << std::endl;
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    std::copy(low.begin(), low.end(), low_threshold.v);
+    std::copy(high.begin(), high.end(), high_threshold.v);
+    return true;
+}
+
+bool MultiChannelSensor::setChannelThresholds(size_t channel, float low, float high) {
+    if (channel >= channel_count || low >= high) {
+        std::cerr << "Error: Invalid thresholds for channel " << channel << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    low_threshold.v[channel] = low;
+    high_threshold.v[channel] = high;
+    return true;
+}
+
+bool MultiChannelSensor::enableAlerts(AlertCallback callback) {
+    if (!callback) {
+        std::cerr << "Error: Invalid callback function" << std::endl;
+        return false;
+    }
+
+    std::array<AlertDispatcher::SourceId, MAX_CHANNELS> previous;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        if (!initialized) {
+            std::cerr << "Error: MultiChannelSensor not initialized" << std::endl;
+            return false;
+        }
+
+        // One source per channel so each axis is coalesced and rate limited on its own
+        std::array<AlertDispatcher::SourceId, MAX_CHANNELS> sources;
+        sources.fill(AlertDispatcher::INVALID_SOURCE);
+        for (size_t ch = 0; ch < channel_count; ++ch) {
+            sources[ch] = alert_dispatcher->registerSource(
+                "MultiChannelSensor '" + device_name + "' channel " + std::to_string(ch) + " threshold exceeded",
+                [callback, ch](float value, const std::string& message) { callback(ch, value, message); },
+                alert_policy.min_interval);
+            if (sources[ch] == AlertDispatcher::INVALID_SOURCE) {
+                for (size_t i = 0; i < ch; ++i) {
+                    alert_dispatcher->unregisterSource(sources[i]);
+                }
+                return false;
+            }
+        }
+
+        previous = alert_sources;
+        alert_sources = sources;
+        for (auto& monitor : threshold_monitors) {
+            monitor.reset();
+        }
+        alerts_enabled = true;
+    }
+
+    for (AlertDispatcher::SourceId id : previous) {
+        if (id != AlertDispatcher::INVALID_SOURCE) {
+            alert_dispatcher->unregisterSource(id);
+        }
+    }
+
+    std::cout << "MultiChannelSensor '" << device_name << "' alerts enabled" << std::endl;
+    return true;
+}
+
+bool MultiChannelSensor::disableAlerts() {
+    std::array<AlertDispatcher::SourceId, MAX_CHANNELS> previous;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        if (!alerts_enabled.load()) {
+            return true;
+        }
+        alerts_enabled = false;
+        previous = alert_sources;
+        alert_sources.fill(AlertDispatcher::INVALID_SOURCE);
+    }
+
+    // Unregister unlocked: it waits for in-flight callbacks that may call back into us
+    for (AlertDispatcher::SourceId id : previous) {
+        if (id != AlertDispatcher::INVALID_SOURCE) {
+            alert_dispatcher->unregisterSource(id);
+        }
+    }
+    std::cout << "MultiChannelSensor '" << device_name << "' alerts disabled" << std::endl;
+    return true;
+}
+
+bool MultiChannelSensor::setAlertPolicy(const AlertDispatcher::AlertPolicy& policy) {
+    if (policy.hysteresis < 0.0f) {
+        std::cerr << "Error: Alert hysteresis must be non-negative" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    alert_policy = policy;
+    for (AlertDispatcher::SourceId id : alert_sources) {
+        if (id != AlertDispatcher::INVALID_SOURCE) {
+            alert_dispatcher->setMinInterval(id, policy.min_interval);
+        }
+    }
+    return true;
+}
+
+bool MultiChannelSensor::setAlertDispatcher(std::shared_ptr<AlertDispatcher> dispatcher) {
+    if (!dispatcher) {
+        std::cerr << "Error: Invalid alert dispatcher" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (sampling_enabled.load() || alerts_enabled.load()) {
+        std::cerr << "Error: Cannot change alert dispatcher while sampling or alerts are enabled" << std::endl;
+        return false;
+    }
+    alert_dispatcher = std::move(dispatcher);
+    return true;
+}
+
+bool MultiChannelSensor::startSampling() {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!initialized) {
+        std::cerr << "Error: MultiChannelSensor not initialized" << std::endl;
+        return false;
+    }
+
+    if (sampling_enabled.load()) {
+        return true; // Already sampling
+    }
+
+    sampling_enabled = true;
+    sampling_running = true;
+    sampling_thread = std::thread(&MultiChannelSensor::samplingLoop, this);
+
+    std::cout << "MultiChannelSensor '" << device_name << "' started sampling " << channel_count
+              << " channels at " << sampling_rate_hz.load() << "Hz" << std::endl;
+    return true;
+}
+
+bool MultiChannelSensor::stopSampling() {
+    std::thread sampler;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        if (!sampling_enabled.load()) {
+            return true; // Already stopped
+        }
+        sampling_enabled = false;
+        sampling_running = false;
+        sampler = std::move(sampling_thread);
+    }
+
+    // Join outside the lock: the sampling loop takes sensor_mutex per frame
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+
+    std::cout << "MultiChannelSensor '" << device_name << "' stopped sampling" << std::endl;
+    return true;
+}
+
+bool MultiChannelSensor::readLatestFrame(Frame& frame) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!initialized || frames_stored == 0) {
+        return false;
+    }
+
+    frame = frame_buffer[(buffer_index + frame_buffer.size() - 1) % frame_buffer.size()];
+    return true;
+}
+
+std::vector<MultiChannelSensor::Frame> MultiChannelSensor::readFrames(size_t num_frames) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    std::vector<Frame> result;
+    if (!initialized || frames_stored == 0) {
+        return result;
+    }
+
+    size_t count = (num_frames == 0) ? frames_stored : std::min(num_frames, frames_stored);
+    size_t start = (buffer_index + frame_buffer.size() - count) % frame_buffer.size();
+    size_t head_count = std::min(count, frame_buffer.size() - start);
+
+    result.reserve(count);
+    result.insert(result.end(), frame_buffer.begin() + start, frame_buffer.begin() + start + head_count);
+    result.insert(result.end(), frame_buffer.begin(), frame_buffer.begin() + (count - head_count));
+    return result;
+}
+
+bool MultiChannelSensor::readSingle(Frame& frame) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!initialized) {
+        std::cerr << "Error: MultiChannelSensor not initialized" << std::endl;
+        return false;
+    }
+
+    frame = Frame{};
+    frame.timestamp = std::chrono::steady_clock::now();
+    generateRawFrame(frame.raw);
+    simd::calibrate(frame.calibrated, frame.raw, calibration_offset.v, calibration_scale.v);
+    frame.threshold_mask = simd::outsideMask(frame.calibrated, low_threshold.v, high_threshold.v) &
+                           ((1u << channel_count) - 1);
+    return true;
+}
+
+bool MultiChannelSensor::clearBuffer() {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!initialized) {
+        return false;
+    }
+
+    buffer_index = 0;
+    frames_stored = 0;
+    resetStatisticsLocked();
+    return true;
+}
+
+MultiChannelSensor::SubscriberId MultiChannelSensor::subscribe(size_t batch_size,
+                                                               std::chrono::microseconds max_latency,
+                                                               FrameBatchCallback callback) {
+    if (batch_size == 0 || batch_size > frame_stream->getCapacity()) {
+        std::cerr << "Error: Batch size must be between 1-" << frame_stream->getCapacity() << std::endl;
+        return FrameStreamType::INVALID_SUBSCRIBER;
+    }
+    return frame_stream->subscribe(batch_size, max_latency, std::move(callback));
+}
+
+bool MultiChannelSensor::unsubscribe(SubscriberId id) {
+    return frame_stream->unsubscribe(id);
+}
+
+MultiChannelSensor::ChannelStatistics MultiChannelSensor::getChannelStatistics(size_t channel) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    ChannelStatistics stats{};
+    if (channel >= channel_count || sample_count == 0) {
+        return stats;
+    }
+
+    stats.min_val = stat_min.v[channel];
+    stats.max_val = stat_max.v[channel];
+    stats.avg_val = stat_mean.v[channel];
+    stats.count = sample_count;
+    stats.std_deviation = (sample_count > 1) ? std::sqrt(stat_m2.v[channel] / (sample_count - 1)) : 0.0f;
+    return stats;
+}
+
+bool MultiChannelSensor::resetStatistics() {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    resetStatisticsLocked();
+    return true;
+}
+
+void MultiChannelSensor::samplingLoop() {
+    auto next_sample_time = std::chrono::steady_clock::now();
+    auto sample_interval = std::chrono::microseconds(1000000 / sampling_rate_hz.load());
+    const uint32_t channel_mask = (1u << channel_count) - 1;
+
+    while (sampling_running.load()) {
+        Frame frame{};
+        generateRawFrame(frame.raw);
+
+        uint32_t raised_mask = 0;
+        std::array<AlertDispatcher::SourceId, MAX_CHANNELS> sources;
+        {
+            std::lock_guard<std::mutex> lock(sensor_mutex);
+            frame.timestamp = std::chrono::steady_clock::now();
+
+            // All channels at once: filter, calibrate, threshold
+            alignas(simd::ALIGNMENT) float filtered[MAX_CHANNELS];
+            std::copy(frame.raw, frame.raw + MAX_CHANNELS, filtered);
+            applyFilter(filtered);
+            simd::calibrate(frame.calibrated, filtered, calibration_offset.v, calibration_scale.v);
+            frame.threshold_mask = simd::outsideMask(frame.calibrated, low_threshold.v, high_threshold.v) &
+                                   channel_mask;
+
+            // Debounce/hysteresis per channel; only channels with monitors in play
+            if (alerts_enabled.load()) {
+                for (size_t ch = 0; ch < channel_count; ++ch) {
+                    auto transition = threshold_monitors[ch].update(frame.calibrated[ch], low_threshold.v[ch],
+                                                                    high_threshold.v[ch], alert_policy);
+                    if (transition == ThresholdMonitor::Transition::RAISED ||
+                        transition == ThresholdMonitor::Transition::REPEATED) {
+                        raised_mask |= 1u << ch;
+                    }
+                }
+                // Posted after unlocking; enable/disableAlerts() swap the ids under the lock
+                if (raised_mask != 0) {
+                    sources = alert_sources;
+                }
+            }
+
+            frame_buffer[buffer_index] = frame;
+            buffer_index = (buffer_index + 1) % frame_buffer.size();
+            frames_stored = std::min(frames_stored + 1, frame_buffer.size());
+
+            sample_count++;
+            simd::accumulateStats(stat_min.v, stat_max.v, stat_mean.v, stat_m2.v, frame.calibrated,
+                                  1.0f / static_cast<float>(sample_count));
+
+            if (frame.timestamp - last_device_file_update >= DEVICE_FILE_INTERVAL) {
+                writeToDeviceFile(formatDeviceData());
+                last_device_file_update = frame.timestamp;
+            }
+        }
+
+        frame_stream->publish(frame);
+
+        for (size_t ch = 0; raised_mask != 0; ++ch, raised_mask >>= 1) {
+            if (raised_mask & 1u) {
+                alert_dispatcher->post(sources[ch], frame.calibrated[ch]);
+            }
+        }
+
+        next_sample_time += sample_interval;
+        std::this_thread::sleep_until(next_sample_time);
+    }
+}
+
+void MultiChannelSensor::generateRawFrame(float* raw) const {
+    thread_local std::mt19937 gen(std::random_device{}());
+
+    for (size_t ch = 0; ch < MAX_CHANNELS; ++ch) {
+        raw[ch] = 0.0f;
+    }
+
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        switch (sensor_type) {
+            case SensorType::TEMPERATURE: {
+                std::normal_distribution<float> dis(22.0f, 5.0f);
+                raw[ch] = std::clamp(dis(gen), -40.0f, 85.0f);
+                break;
+            }
+            case SensorType::PRESSURE: {
+                std::normal_distribution<float> dis(101.3f, 2.0f);
+                raw[ch] = std::clamp(dis(gen), 0.0f, 1200.0f);
+                break;
+            }
+            case SensorType::HUMIDITY: {
+                std::normal_distribution<float> dis(45.0f, 10.0f);
+                raw[ch] = std::clamp(dis(gen), 0.0f, 100.0f);
+                break;
+            }
+            case SensorType::ACCELEROMETER: {
+                // Device at rest: gravity on Z (channel 2), slight vibration on every axis
+                std::normal_distribution<float> dis(ch == 2 ? 1.0f : 0.0f, 0.1f);
+                raw[ch] = std::clamp(dis(gen), -2.0f, 2.0f);
+                break;
+            }
+            case SensorType::LIGHT: {
+                std::uniform_real_distribution<float> dis(100.0f, 1000.0f);
+                raw[ch] = dis(gen);
+                break;
+            }
+            case SensorType::VOLTAGE: {
+                std::normal_distribution<float> dis(3.3f, 0.05f);
+                raw[ch] = std::clamp(dis(gen), 0.0f, 3.6f);
+                break;
+            }
+        }
+    }
+}
+
+void MultiChannelSensor::applyFilter(float* values) {
+    if (filter_type == FilterType::NONE) {
+        return;
+    }
+
+    // Seed the filter state with the first frame so it starts settled
+    if (!filter_primed) {
+        std::copy(values, values + MAX_CHANNELS, filter_state.v);
+        std::copy(values, values + MAX_CHANNELS, filter_prev_input.v);
+        filter_primed = true;
+        if (filter_type == FilterType::HIGH_PASS) {
+            std::fill(filter_state.v, filter_state.v + MAX_CHANNELS, 0.0f);
+        }
+    }
+
+    switch (filter_type) {
+        case FilterType::MOVING_AVERAGE: {
+            Lanes& oldest = filter_window[filter_position];
+            size_t window = filter_window.size();
+            filter_filled = std::min(filter_filled + 1, window);
+            alignas(simd::ALIGNMENT) float incoming[MAX_CHANNELS];
+            std::copy(values, values + MAX_CHANNELS, incoming);
+            simd::slidingMean(values, filter_sum.v, incoming, oldest.v, 1.0f / static_cast<float>(filter_filled));
+            std::copy(incoming, incoming + MAX_CHANNELS, oldest.v);
+            filter_position = (filter_position + 1) % window;
+            break;
+        }
+        case FilterType::LOW_PASS:
+            simd::lowPass(filter_state.v, values, 0.1f);
+            std::copy(filter_state.v, filter_state.v + MAX_CHANNELS, values);
+            break;
+        case FilterType::HIGH_PASS:
+            simd::highPass(values, filter_prev_input.v, filter_state.v, values, 0.9f);
+            break;
+        default:
+            break;
+    }
+}
+
+void MultiChannelSensor::resetFilterLocked() {
+    Lanes zero{};
+    filter_window.assign(static_cast<size_t>(filter_window_size), zero);
+    filter_position = 0;
+    filter_filled = 0;
+    filter_sum = zero;
+    filter_state = zero;
+    filter_prev_input = zero;
+    filter_primed = false;
+}
+
+void MultiChannelSensor::resetStatisticsLocked() {
+    for (size_t ch = 0; ch < MAX_CHANNELS; ++ch) {
+        stat_min.v[ch] = std::numeric_limits<float>::max();
+        stat_max.v[ch] = std::numeric_limits<float>::lowest();
+        stat_mean.v[ch] = 0.0f;
+        stat_m2.v[ch] = 0.0f;
+    }
+    sample_count = 0;
+}
+
+std::string MultiChannelSensor::formatDeviceData() const {
+    std::stringstream ss;
+    ss << "type:" << static_cast<int>(sensor_type) << ",";
+    ss << "channels:" << channel_count << ",";
+    ss << "sampling:" << (sampling_enabled.load() ? 1 : 0) << ",";
+    ss << "rate:" << sampling_rate_hz.load() << ",";
+    ss << "samples:" << sample_count;
+    for (size_t ch = 0; ch < channel_count; ++ch) {
+        ss << ",avg" << ch << ":" << stat_mean.v[ch];
+    }
+    return ss.str();
+}
@@ -0,0 +1,242 @@
+#include "sdk/rs485_bus.h"
+#include <iostream>
+#include <algorithm>
+
+RS485Bus::RS485Bus(const std::string& name, const BusConfig& cfg)
+    : bus_name(name),
+      config(cfg),
+      stats{} {
+}
+
+RS485Bus::~RS485Bus() {
+    for (NodeId id = 1; id <= static_cast<NodeId>(nodes.size()); ++id) {
+        if (nodes[id - 1]) {
+            detach(id);
+        }
+    }
+}
+
+RS485Bus::BusConfig RS485Bus::defaultConfig() {
+    BusConfig cfg;
+    cfg.wiring = Wiring::TWO_WIRE;
+    cfg.turnaround = std::chrono::microseconds(5);
+    cfg.enable_delay = std::chrono::nanoseconds(0);
+    return cfg;
+}
+
+RS485Bus::NodeId RS485Bus::attach(UART& uart, Role role) {
+    UART::Mode expected = config.wiring == Wiring::TWO_WIRE ? UART::Mode::RS485_HALF_DUPLEX
+                                                            : UART::Mode::RS485_FULL_DUPLEX;
+    if (uart.getConfiguration().mode != expected) {
+        std::cerr << "Error: UART '" << uart.getName() << "' must be in " << UART::modeToString(expected)
+                  << " mode to join bus '" << bus_name << "'" << std::endl;
+        return INVALID_NODE;
+    }
+    if (uart.isLineAttached()) {
+        std::cerr << "Error: UART line already attached to another link" << std::endl;
+        return INVALID_NODE;
+    }
+
+    Node* node;
+    {
+        std::lock_guard<std::mutex> lock(bus_mutex);
+        for (const auto& existing : nodes) {
+            if (existing && existing->uart == &uart) {
+                std::cerr << "Error: UART '" << uart.getName() << "' already on bus '" << bus_name << "'" << std::endl;
+                return INVALID_NODE;
+            }
+        }
+        std::unique_ptr<Node> added(new Node{});
+        added->uart = &uart;
+        added->id = static_cast<NodeId>(nodes.size() + 1);
+        bool master = config.wiring == Wiring::FOUR_WIRE && role == Role::MASTER;
+        bool two_wire = config.wiring == Wiring::TWO_WIRE;
+        added->drive_pair = (two_wire || master) ? MASTER_PAIR : SLAVE_PAIR;
+        added->listen_pair = (two_wire || !master) ? MASTER_PAIR : SLAVE_PAIR;
+        node = added.get();
+        nodes.push_back(std::move(added));
+        rebuildPairsLocked();
+    }
+
+    UART::LineSink sink;
+    sink.receive = [this, node](Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times) {
+        transmit(*node, data, stop_times);
+    };
+    sink.idle = [this, node](std::chrono::steady_clock::time_point last_stop) {
+        release(*node, last_stop);
+    };
+    uart.attachLine(std::move(sink));
+    return node->id;
+}
+
+bool RS485Bus::detach(NodeId id) {
+    UART* uart = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(bus_mutex);
+        if (id == INVALID_NODE || id > nodes.size() || !nodes[id - 1]) {
+            std::cerr << "Error: Invalid node " << id << " on bus '" << bus_name << "'" << std::endl;
+            return false;
+        }
+        uart = nodes[id - 1]->uart;
+    }
+
+    // Outside bus_mutex: the node's TX thread may be waiting for it while holding its line
+    uart->detachLine();
+
+    // No new fan-out reaches the node once it is off the pairs; wait out the
+    // ones already delivering to it before it goes
+    std::unique_lock<std::mutex> lock(bus_mutex);
+    std::unique_ptr<Node> removed = std::move(nodes[id - 1]);
+    rebuildPairsLocked();
+    fanout_cv.wait(lock, [&removed] { return removed->fanouts == 0; });
+    return true;
+}
+
+size_t RS485Bus::getNodeCount() const {
+    std::lock_guard<std::mutex> lock(bus_mutex);
+    return static_cast<size_t>(std::count_if(nodes.begin(), nodes.end(),
+                                              [](const std::unique_ptr<Node>& node) { return node != nullptr; }));
+}
+
+bool RS485Bus::isBusy() const {
+    std::lock_guard<std::mutex> lock(bus_mutex);
+    for (const auto& pair : drivers) {
+        for (const Node* node : pair) {
+            if (node->driving) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool RS485Bus::setCollisionCallback(CollisionCallback callback) {
+    std::lock_guard<std::mutex> lock(bus_mutex);
+    collision_callback = std::move(callback);
+    return true;
+}
+
+RS485Bus::Statistics RS485Bus::getStatistics() const {
+    std::lock_guard<std::mutex> lock(bus_mutex);
+    return stats;
+}
+
+void RS485Bus::resetStatistics() {
+    std::lock_guard<std::mutex> lock(bus_mutex);
+    stats = Statistics{};
+}
+
+void RS485Bus::rebuildPairsLocked() {
+    for (int pair = 0; pair < 2; ++pair) {
+        listeners[pair].clear();
+        drivers[pair].clear();
+    }
+    for (const auto& node : nodes) {
+        if (node) {
+            listeners[node->listen_pair].push_back(node.get());
+            drivers[node->drive_pair].push_back(node.get());
+        }
+    }
+}
+
+bool RS485Bus::overlapsLocked(const Node& other, std::chrono::steady_clock::time_point start,
+                              std::chrono::steady_clock::time_point end) const {
+    if (other.drive_start > end) {
+        return false;
+    }
+    // A driver still enabled holds the pair until it reports the pause
+    return other.driving || start < other.drive_end + config.turnaround;
+}
+
+void RS485Bus::transmit(Node& sender, Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times) {
+    std::chrono::nanoseconds frame = sender.driving ? sender.frame : sender.uart->getFrameTime();
+    std::vector<CollisionEvent> events;
+    CollisionCallback callback;
+    Span<const uint8_t> carried;
+    std::vector<Node*>& receivers = sender.receivers;
+    {
+        std::lock_guard<std::mutex> lock(bus_mutex);
+        std::chrono::steady_clock::time_point start = stop_times[0] - frame;
+        if (!sender.driving) {
+            // Driver enable: a new transmission
+            sender.driving = true;
+            sender.colliding = false;
+            sender.frame = frame;
+            sender.drive_start = start;
+            sender.enabled_at = start + config.enable_delay;
+            stats.transmissions++;
+        }
+        sender.drive_end = stop_times[data.size() - 1];
+
+        bool collided = false;
+        for (Node* other : drivers[sender.drive_pair]) {
+            if (other == &sender || !overlapsLocked(*other, start, sender.drive_end)) {
+                continue;
+            }
+            if (!sender.colliding || !other->colliding) {
+                events.push_back(CollisionEvent{other->id, sender.id, start});
+                stats.collisions++;
+            }
+            sender.colliding = true;
+            other->colliding = true;
+            collided = true;
+        }
+        if (collided) {
+            stats.bytes_lost += data.size();
+        } else {
+            // Start bits before the driver came up are lost
+            size_t skipped = 0;
+            while (skipped < data.size() && stop_times[skipped] - frame < sender.enabled_at) {
+                ++skipped;
+            }
+            stats.bytes_lost += skipped;
+            stats.bytes_carried += data.size() - skipped;
+
+            // Pick the receivers; two-wire drivers do not hear the pair
+            if (skipped < data.size()) {
+                carried = Span<const uint8_t>(data.data() + skipped, data.size() - skipped);
+                stop_times += skipped;
+                for (Node* receiver : listeners[sender.drive_pair]) {
+                    if (receiver != &sender && !(config.wiring == Wiring::TWO_WIRE && receiver->driving)) {
+                        receiver->fanouts++;
+                        receivers.push_back(receiver);
+                    }
+                }
+            }
+        }
+        if (!events.empty()) {
+            callback = collision_callback;
+        }
+    }
+    
+    // Fan out from the sender's buffer without the bus lock. Each receiver
+    // still has one producer at a time: another driver's burst on the pair
+    // either collides (and is dropped) or starts after this sender released
+    if (!receivers.empty()) {
+        for (Node* receiver : receivers) {
+            receiver->uart->receiveFromLine(carried, stop_times);
+        }
+        std::lock_guard<std::mutex> lock(bus_mutex);
+        for (Node* receiver : receivers) {
+            receiver->fanouts--;
+        }
+        receivers.clear();
+        fanout_cv.notify_all();
+    }
+    if (callback) {
+        for (const auto& event : events) {
+            callback(event);
+        }
+    }
+}
+
+void RS485Bus::release(Node& sender, std::chrono::steady_clock::time_point last_stop) {
+    std::lock_guard<std::mutex> lock(bus_mutex);
+    sender.driving = false;
+    sender.drive_end = std::min(sender.drive_end, last_stop);
+    for (Node* receiver : listeners[sender.drive_pair]) {
+        if (receiver != &sender) {
+            receiver->uart->lineIdle(last_stop);
+        }
+    }
+}
@@ -6,6 +6,12 @@
 #include <numeric>
 #include <cmath>
 
+namespace {
+// First-order filter coefficients in Q15
+constexpr int32_t LOW_PASS_ALPHA = 3277;   // 0.1
+constexpr int32_t HIGH_PASS_ALPHA = 29491; // 0.9
+}
+
 Sensor::Sensor(const std::string& name, SensorType type)
     : Peripheral(name),
       sensor_type(type),
@@ -14,21 +20,35 @@ Sensor::Sensor(const std::string& name, SensorType type)
       adc_resolution(12),   // Default 12-bit ADC
       buffer_size(1000),    // Default 1000 samples
       buffer_index(0),
+      write_sequence(0),
+      buffer_generation(0),
+      generation_start(0),
       filter_type(FilterType::NONE),
       filter_window_size(5),
-      calibration_offset(0.0f),
-      calibration_scale(1.0f),
+      filter_state{},
+      adc_min(0.0f),
+      adc_lsb(1.0f),
+      adc_max_code(0),
       high_threshold(1000.0f),
       low_threshold(-1000.0f),
       alerts_enabled(false),
+      alert_dispatcher(AlertDispatcher::getDefault()),
+      alert_source(AlertDispatcher::INVALID_SOURCE),
+      alert_policy(AlertDispatcher::defaultPolicy()),
       sampling_running(false),
       min_value(std::numeric_limits<float>::max()),
       max_value(std::numeric_limits<float>::lowest()),
       avg_value(0.0f),
-      sample_count(0) {
+      sample_count(0),
+      log_clock_offset_ns(0),
+      timestamp_mode(TimestampMode::PER_SAMPLE),
+      timestamp_block_size(1),
+      clock_source(ClockSource::STEADY) {
     
     data_buffer.resize(buffer_size.load());
-    filter_buffer.reserve(filter_window_size.load());
+    resetFilterLocked();
+    rebuildFixedPointLocked();
+    sample_stream = std::make_unique<SampleStreamType>(4096);
 }
 
 Sensor::~Sensor() {
@@ -42,15 +62,18 @@ bool Sensor::initialize() {
     
     // Reset all values
     sampling_enabled = false;
-    buffer_index = 0;
     data_buffer.clear();
     data_buffer.resize(buffer_size.load());
-    filter_buffer.clear();
+    resetBufferLocked();
+    resetFilterLocked();
+    rebuildFixedPointLocked();
     
     // Reset statistics
     min_value = std::numeric_limits<float>::max();
     max_value = std::numeric_limits<float>::lowest();
     avg_value = 0.0f;
+    value_sketch.reset();
+    value_rollup.reset();
     sample_count = 0;
     
     // Create device file with initial state
@@ -66,18 +89,24 @@ bool Sensor::initialize() {
 }
 
 bool Sensor::cleanup() {
+    // Stop sampling (joins the sampling thread, so must run unlocked)
+    stopSampling();
+    
+    // Disable alerts (may wait for an in-flight callback, so also unlocked)
+    disableAlerts();
+    
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
-    // Stop sampling
-    stopSampling();
+    // Flush and close the persistent history
+    if (history_log) {
+        history_log->close();
+        history_log.reset();
+    }
     
     // Clear buffers
     data_buffer.clear();
-    filter_buffer.clear();
-    
-    // Disable alerts
-    alerts_enabled = false;
-    alert_callback = nullptr;
+    resetBufferLocked();
+    resetFilterLocked();
     
     // Update device file
     writeToDeviceFile(formatDeviceData());
@@ -96,6 +125,10 @@ std::string Sensor::getStatus() const {
     ss << "Rate: " << sampling_rate_hz.load() << "Hz, ";
     ss << "ADC: " << adc_resolution.load() << "-bit, ";
     ss << "Filter: " << filterTypeToString(filter_type) << ", ";
+    if (timestamp_mode == TimestampMode::BLOCK) {
+        ss << "Timestamps: " << timestampModeToString(timestamp_mode) << "/" << timestamp_block_size
+           << (clock_source == ClockSource::TSC ? " (TSC)" : "") << ", ";
+    }
     ss << "Samples: " << sample_count.load() << "/" << buffer_size.load();
     
     if (sample_count.load() > 0) {
@@ -126,8 +159,7 @@ bool Sensor::setSensorType(SensorType type) {
     sensor_type = type;
     
     // Reset calibration for new sensor type
-    calibration_offset = 0.0f;
-    calibration_scale = 1.0f;
+    publishCalibrationLocked(Calibration::linear(0.0f, 1.0f));
     
     // Set appropriate thresholds based on sensor type
     switch (type) {
@@ -157,13 +189,16 @@ bool Sensor::setSensorType(SensorType type) {
             break;
     }
     
+    rebuildFixedPointLocked();
+    resetFilterLocked();
+    
     writeToDeviceFile(formatDeviceData());
     return true;
 }
 
 bool Sensor::setSamplingRate(int hz) {
-    if (hz <= 0 || hz > 10000) {
-        std::cerr << "Error: Sampling rate must be between 1-10000 Hz" << std::endl;
+    if (hz <= 0 || hz > 20000) {
+        std::cerr << "Error: Sampling rate must be between 1-20000 Hz" << std::endl;
         return false;
     }
     
@@ -177,7 +212,10 @@ bool Sensor::setADCResolution(int bits) {
         return false;
     }
     
+    std::lock_guard<std::mutex> lock(sensor_mutex);
     adc_resolution = bits;
+    rebuildFixedPointLocked();
+    resetFilterLocked(); // Filter state is in codes of the old resolution
     return true;
 }
 
@@ -195,7 +233,7 @@ bool Sensor::setBufferSize(size_t size) {
     
     buffer_size = size;
     data_buffer.resize(size);
-    buffer_index = 0;
+    resetBufferLocked();
     
     return true;
 }
@@ -210,8 +248,7 @@ bool Sensor::setFilter(FilterType type, int window_size) {
     
     filter_type = type;
     filter_window_size = window_size;
-    filter_buffer.clear();
-    filter_buffer.reserve(window_size);
+    resetFilterLocked();
     
     return true;
 }
@@ -222,8 +259,15 @@ bool Sensor::setCalibration(float offset, float scale) {
         return false;
     }
     
-    calibration_offset = offset;
-    calibration_scale = scale;
+    std::shared_ptr<const Calibration> curve = Calibration::linear(offset, scale);
+    if (!curve) {
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        publishCalibrationLocked(std::move(curve));
+    }
     
     std::cout << "Sensor '" << device_name << "' calibration set: offset=" 
               << offset << ", scale=" << scale << std::endl;
@@ -231,6 +275,27 @@ bool Sensor::setCalibration(float offset, float scale) {
     return true;
 }
 
+bool Sensor::setCalibration(std::shared_ptr<const Calibration> curve) {
+    if (!curve) {
+        std::cerr << "Error: Invalid calibration curve" << std::endl;
+        return false;
+    }
+    
+    Calibration::Kind kind = curve->getKind();
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        publishCalibrationLocked(std::move(curve));
+    }
+    
+    std::cout << "Sensor '" << device_name << "' calibration set: "
+              << Calibration::kindToString(kind) << std::endl;
+    return true;
+}
+
+std::shared_ptr<const Calibration> Sensor::getCalibration() const {
+    return std::atomic_load(&calibration_state)->curve;
+}
+
 bool Sensor::setThresholds(float low, float high) {
     if (low >= high) {
         std::cerr << "Error: Low threshold must be less than high threshold" << std::endl;
@@ -244,35 +309,100 @@ bool Sensor::setThresholds(float low, float high) {
 }
 
 bool Sensor::enableAlerts(AlertCallback callback) {
-    std::lock_guard<std::mutex> lock(sensor_mutex);
-    if (!initialized) {
-        std::cerr << "Error: Sensor not initialized" << std::endl;
-        return false;
+    AlertDispatcher::SourceId previous;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        if (!initialized) {
+            std::cerr << "Error: Sensor not initialized" << std::endl;
+            return false;
+        }
+        
+        if (!callback) {
+            std::cerr << "Error: Invalid callback function" << std::endl;
+            return false;
+        }
+        
+        AlertDispatcher::SourceId source = alert_dispatcher->registerSource(
+            "Sensor '" + device_name + "' threshold exceeded", callback, alert_policy.min_interval);
+        if (source == AlertDispatcher::INVALID_SOURCE) {
+            return false;
+        }
+        
+        previous = alert_source.exchange(source);
+        threshold_monitor.reset();
+        alerts_enabled = true;
     }
     
-    if (!callback) {
-        std::cerr << "Error: Invalid callback function" << std::endl;
-        return false;
+    if (previous != AlertDispatcher::INVALID_SOURCE) {
+        alert_dispatcher->unregisterSource(previous);
     }
     
-    alert_callback = callback;
-    alerts_enabled = true;
-    
     std::cout << "Sensor '" << device_name << "' alerts enabled" << std::endl;
     return true;
 }
 
 bool Sensor::disableAlerts() {
+    AlertDispatcher::SourceId previous;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        alerts_enabled = false;
+        previous = alert_source.exchange(AlertDispatcher::INVALID_SOURCE);
+    }
+    
+    // Unregister unlocked: it waits for an in-flight callback that may call back into us
+    if (previous != AlertDispatcher::INVALID_SOURCE) {
+        alert_dispatcher->unregisterSource(previous);
+        std::cout << "Sensor '" << device_name << "' alerts disabled" << std::endl;
+    }
+    return true;
+}
+
+bool Sensor::setAlertPolicy(const AlertDispatcher::AlertPolicy& policy) {
+    if (policy.hysteresis < 0.0f || policy.min_interval.count() < 0) {
+        std::cerr << "Error: Alert hysteresis and interval must be non-negative" << std::endl;
+        return false;
+    }
+    
     std::lock_guard<std::mutex> lock(sensor_mutex);
+    alert_policy = policy;
+    threshold_monitor.reset();
     
-    alerts_enabled = false;
-    alert_callback = nullptr;
+    // A registered source keeps the rate limit it was created with unless told
+    AlertDispatcher::SourceId source = alert_source.load();
+    if (source != AlertDispatcher::INVALID_SOURCE) {
+        alert_dispatcher->setMinInterval(source, policy.min_interval);
+    }
+    return true;
+}
+
+AlertDispatcher::AlertPolicy Sensor::getAlertPolicy() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return alert_policy;
+}
+
+bool Sensor::setAlertDispatcher(std::shared_ptr<AlertDispatcher> dispatcher) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!dispatcher) {
+        std::cerr << "Error: Invalid alert dispatcher" << std::endl;
+        return false;
+    }
     
-    std::cout << "Sensor '" << device_name << "' alerts disabled" << std::endl;
+    if (sampling_enabled.load() || alerts_enabled.load()) {
+        std::cerr << "Error: Cannot change alert dispatcher while sampling or with alerts enabled" << std::endl;
+        return false;
+    }
+    
+    alert_dispatcher = std::move(dispatcher);
     return true;
 }
 
+size_t Sensor::getDroppedAlerts() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return alert_dispatcher->getDroppedCount(alert_source.load());
+}
+
 bool Sensor::startSampling() {
+    std::lock_guard<std::mutex> feed_lock(feed_mutex);
     std::lock_guard<std::mutex> lock(sensor_mutex);
     if (!initialized) {
         std::cerr << "Error: Sensor not initialized" << std::endl;
@@ -283,6 +413,12 @@ bool Sensor::startSampling() {
         return true; // Already sampling
     }
     
+    // A replay that finished on its own leaves its thread to be joined; it
+    // takes no lock once it has cleared sampling_enabled
+    if (sampling_thread.joinable()) {
+        sampling_thread.join();
+    }
+    
     sampling_enabled = true;
     sampling_running = true;
     
@@ -296,32 +432,189 @@ bool Sensor::startSampling() {
 }
 
 bool Sensor::stopSampling() {
+    std::thread sampler;
+    bool stopped = false;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        
+        if (!sampling_enabled.load()) {
+            // Already stopped, possibly by a replay that finished: reap its thread
+            sampler = std::move(sampling_thread);
+        } else {
+            sampling_enabled = false;
+            sampling_running = false;
+            sampling_cv.notify_all();
+            sampler = std::move(sampling_thread);
+            stopped = true;
+        }
+    }
+    
+    // Join outside the lock: the sampling loop takes sensor_mutex per sample
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+    if (!stopped) {
+        return true;
+    }
+    
+    std::cout << "Sensor '" << device_name << "' stopped sampling" << std::endl;
+    return true;
+}
+
+bool Sensor::enableLogging(const std::string& directory, const TimeSeriesLog::Config& log_config) {
     std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!initialized) {
+        std::cerr << "Error: Sensor not initialized" << std::endl;
+        return false;
+    }
     
-    if (!sampling_enabled.load()) {
-        return true; // Already stopped
+    if (history_log) {
+        return true; // Already logging
     }
     
-    sampling_enabled = false;
-    sampling_running = false;
-    sampling_cv.notify_all();
+    std::string log_directory = directory.empty() ? device_file + ".tslog" : directory;
+    auto log = std::make_shared<TimeSeriesLog>(log_directory, log_config);
+    if (!log->open()) {
+        std::cerr << "Error: Failed to open history log for sensor '" << device_name << "'" << std::endl;
+        return false;
+    }
     
-    if (sampling_thread.joinable()) {
-        sampling_thread.join();
+    // Persist wall-clock time so captures remain meaningful across restarts
+    auto system_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    log_clock_offset_ns = system_ns - steady_ns;
+    history_log = std::move(log);
+    
+    std::cout << "Sensor '" << device_name << "' logging to " << log_directory << std::endl;
+    return true;
+}
+
+bool Sensor::disableLogging() {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (history_log) {
+        history_log->close();
+        history_log.reset();
+    }
+    return true;
+}
+
+bool Sensor::isLogging() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return history_log != nullptr;
+}
+
+size_t Sensor::readHistory(int64_t from_ns, int64_t to_ns, const TimeSeriesLog::ScanCallback& callback) const {
+    // Scan a reference to the log, not under sensor_mutex: a long scan or a
+    // slow callback must not stall sampling (the log holds its own lock only
+    // to snapshot the index). A scan racing disableLogging() either takes its
+    // snapshot first and completes or finds the log closed and visits nothing
+    std::shared_ptr<TimeSeriesLog> log;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        log = history_log;
+    }
+    if (!log) {
+        return 0;
+    }
+    return log->scan(from_ns, to_ns, callback);
+}
+
+bool Sensor::setReplaySource(std::shared_ptr<TraceReplaySource> source) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (sampling_enabled.load()) {
+        std::cerr << "Error: Cannot change replay source while sampling" << std::endl;
+        return false;
     }
     
-    std::cout << "Sensor '" << device_name << "' stopped sampling" << std::endl;
+    if (source && !source->isOpen() && !source->open()) {
+        std::cerr << "Error: Failed to open replay source for sensor '" << device_name << "'" << std::endl;
+        return false;
+    }
+    
+    replay_source = std::move(source);
+    
+    if (replay_source) {
+        std::cout << "Sensor '" << device_name << "' replaying "
+                  << TraceReplaySource::formatToString(replay_source->getFormat()) << " trace ("
+                  << replay_source->getSampleCount() << " samples)" << std::endl;
+    }
     return true;
 }
 
+std::shared_ptr<TraceReplaySource> Sensor::getReplaySource() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return replay_source;
+}
+
+bool Sensor::setTimestampMode(TimestampMode mode, size_t block_size, ClockSource source) {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (sampling_enabled.load()) {
+        std::cerr << "Error: Cannot change timestamp mode while sampling" << std::endl;
+        return false;
+    }
+    
+    if (mode == TimestampMode::BLOCK && (block_size < 1 || block_size > 65536)) {
+        std::cerr << "Error: Timestamp block size must be between 1-65536" << std::endl;
+        return false;
+    }
+    
+    if (source == ClockSource::TSC && !TscClock::instance().isInvariant()) {
+        std::cout << "Sensor '" << device_name << "': no invariant TSC, timestamps use steady_clock" << std::endl;
+    }
+    
+    timestamp_mode = mode;
+    timestamp_block_size = (mode == TimestampMode::BLOCK) ? block_size : 1;
+    clock_source = source;
+    return true;
+}
+
+Sensor::TimestampMode Sensor::getTimestampMode() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return timestamp_mode;
+}
+
+size_t Sensor::getTimestampBlockSize() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return timestamp_block_size;
+}
+
+Sensor::ClockSource Sensor::getClockSource() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return clock_source;
+}
+
+Sensor::SubscriberId Sensor::subscribe(size_t batch_size, std::chrono::microseconds max_latency,
+                                       SampleBatchCallback callback) {
+    if (batch_size == 0 || batch_size > sample_stream->getCapacity()) {
+        std::cerr << "Error: Subscription batch size must be between 1-"
+                  << sample_stream->getCapacity() << std::endl;
+        return SampleStreamType::INVALID_SUBSCRIBER;
+    }
+    
+    return sample_stream->subscribe(batch_size, max_latency, std::move(callback));
+}
+
+bool Sensor::unsubscribe(SubscriberId id) {
+    return sample_stream->unsubscribe(id);
+}
+
+bool Sensor::getSubscriberStats(SubscriberId id, SubscriberStats& stats) const {
+    return sample_stream->getSubscriberStats(id, stats);
+}
+
 bool Sensor::readLatestSample(SensorData& data) const {
     std::lock_guard<std::mutex> lock(sensor_mutex);
-    if (!initialized || sample_count.load() == 0) {
+    if (!initialized) {
         return false;
     }
     
-    size_t latest_index = (buffer_index.load() + buffer_size.load() - 1) % buffer_size.load();
-    data = data_buffer[latest_index];
+    BufferView view = viewBufferLocked(1);
+    if (view.samples.empty()) {
+        return false;
+    }
+    data = view.samples[0];
     return true;
 }
 
@@ -329,24 +622,79 @@ std::vector<Sensor::SensorData> Sensor::readBuffer(size_t num_samples) const {
     std::lock_guard<std::mutex> lock(sensor_mutex);
     std::vector<SensorData> result;
     
-    if (!initialized || sample_count.load() == 0) {
+    if (!initialized) {
         return result;
     }
     
-    size_t samples_to_read = (num_samples == 0) ? 
-        std::min(sample_count.load(), buffer_size.load()) : 
-        std::min(num_samples, sample_count.load());
+    // At most two bulk copies instead of a modulo per element
+    BufferView view = viewBufferLocked(num_samples);
+    result.reserve(view.samples.size());
+    view.samples.forEachSegment([&result](Span<const SensorData> segment) {
+        result.insert(result.end(), segment.begin(), segment.end());
+    });
     
-    result.reserve(samples_to_read);
+    return result;
+}
+
+size_t Sensor::visitBuffer(size_t num_samples, const BufferVisitor& visitor) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!initialized || !visitor) {
+        return 0;
+    }
     
-    size_t start_index = (buffer_index.load() + buffer_size.load() - samples_to_read) % buffer_size.load();
+    BufferView view = viewBufferLocked(num_samples);
+    view.samples.forEachSegment(visitor);
+    return view.samples.size();
+}
+
+Sensor::BufferView Sensor::viewBuffer(size_t num_samples) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (!initialized) {
+        return BufferView{};
+    }
+    return viewBufferLocked(num_samples);
+}
+
+bool Sensor::isViewValid(const BufferView& view) const {
+    // Order the caller's reads of the view before re-reading the sequence
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (buffer_generation.load(std::memory_order_acquire) != view.generation) {
+        return false;
+    }
     
-    for (size_t i = 0; i < samples_to_read; ++i) {
-        size_t idx = (start_index + i) % buffer_size.load();
-        result.push_back(data_buffer[idx]);
+    // The writer claims a sequence before storing its slot, so any write that
+    // has started on the oldest viewed slot already shows up here
+    uint64_t written = write_sequence.load(std::memory_order_acquire);
+    return written - view.first_sequence <= buffer_size.load();
+}
+
+Sensor::BufferView Sensor::viewBufferLocked(size_t num_samples) const {
+    BufferView view{};
+    view.generation = buffer_generation.load(std::memory_order_relaxed);
+    
+    size_t capacity = data_buffer.size();
+    uint64_t written = write_sequence.load(std::memory_order_relaxed);
+    size_t available = static_cast<size_t>(std::min<uint64_t>(written - generation_start, capacity));
+    size_t count = (num_samples == 0) ? available : std::min(num_samples, available);
+    
+    view.first_sequence = written - count;
+    if (count == 0) {
+        return view;
     }
     
-    return result;
+    size_t end_index = buffer_index.load(std::memory_order_relaxed);
+    size_t start_index = (end_index + capacity - count) % capacity;
+    size_t head_count = std::min(count, capacity - start_index);
+    view.samples.head = Span<const SensorData>(data_buffer.data() + start_index, head_count);
+    view.samples.tail = Span<const SensorData>(data_buffer.data(), count - head_count);
+    return view;
+}
+
+void Sensor::resetBufferLocked() {
+    // Outstanding views see the generation change and report themselves invalid
+    buffer_index = 0;
+    generation_start = write_sequence.load(std::memory_order_relaxed);
+    buffer_generation.fetch_add(1, std::memory_order_release);
 }
 
 bool Sensor::clearBuffer() {
@@ -355,13 +703,15 @@ bool Sensor::clearBuffer() {
         return false;
     }
     
-    buffer_index = 0;
+    resetBufferLocked();
     sample_count = 0;
     
     // Reset statistics
     min_value = std::numeric_limits<float>::max();
     max_value = std::numeric_limits<float>::lowest();
     avg_value = 0.0f;
+    value_sketch.reset();
+    value_rollup.reset();
     
     return true;
 }
@@ -373,58 +723,250 @@ bool Sensor::readSingle(float& raw_value, float& calibrated_value) {
         return false;
     }
     
-    raw_value = generateRawValue();
-    calibrated_value = applyCalibration(raw_value);
+    float input;
+    TraceReplaySource::Sample trace_sample;
+    if (replay_source && !sampling_enabled.load() && replay_source->next(trace_sample)) {
+        input = trace_sample.value;
+    } else {
+        input = generateRawValue();
+    }
+    
+    uint16_t code = quantizeLocked(input);
+    raw_value = adc_min + static_cast<float>(code) * adc_lsb;
+    const CalibrationState& state = *calibration_state;
+    calibrated_value = state.code_table.empty() ? fixedpoint::apply(state.code_linear, code)
+                                                : state.code_table[code];
+    
+    return true;
+}
+
+size_t Sensor::readADCCodes(std::vector<uint16_t>& codes, size_t num_samples) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    codes.clear();
+    if (!initialized) {
+        return 0;
+    }
+    
+    // Same window as the sample view; codes are stored in the samples themselves
+    BufferView view = viewBufferLocked(num_samples);
+    codes.reserve(view.samples.size());
+    view.samples.forEachSegment([&codes](Span<const SensorData> segment) {
+        for (const SensorData& sample : segment) {
+            codes.push_back(sample.adc_code);
+        }
+    });
+    return codes.size();
+}
+
+bool Sensor::convertADCCodes(const uint16_t* codes, size_t count, float* values) const {
+    if (!codes || !values) {
+        std::cerr << "Error: Invalid ADC conversion buffers" << std::endl;
+        return false;
+    }
+    
+    // Lock-free: the published state is immutable
+    std::shared_ptr<const CalibrationState> state = std::atomic_load(&calibration_state);
+    if (state->code_table.empty()) {
+        fixedpoint::applyBlock(state->code_linear, codes, count, values);
+        return true;
+    }
     
+    size_t last = state->code_table.size() - 1;
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = state->code_table[std::min<size_t>(codes[i], last)];
+    }
     return true;
 }
 
 void Sensor::samplingLoop() {
-    auto next_sample_time = std::chrono::steady_clock::now();
-    auto sample_interval = std::chrono::microseconds(1000000 / sampling_rate_hz.load());
+    // Timestamping cannot change while sampling; snapshot it for the loop
+    const size_t block_size = timestamp_block_size;
+    const TscClock* tsc = (clock_source == ClockSource::TSC) ? &TscClock::instance() : nullptr;
+    auto readClock = [tsc]() {
+        return tsc ? tsc->now() : std::chrono::steady_clock::now();
+    };
+    
+    // Sample times are base + index * period: no clock read inside a block
+    const auto sample_interval = std::chrono::nanoseconds(1000000000LL / sampling_rate_hz.load());
+    const auto block_span = sample_interval * static_cast<int64_t>(block_size - 1);
+    auto next_sample_time = std::chrono::steady_clock::now() + block_span;
+    std::chrono::steady_clock::time_point block_base;
+    std::chrono::steady_clock::time_point block_now;
+    std::chrono::steady_clock::time_point last_stamp;
+    size_t block_position = 0;
+    bool first_block = true;
     
     while (sampling_running.load()) {
-        // Generate sample
-        float raw_value = generateRawValue();
-        float filtered_value = applyFilter(raw_value);
-        float calibrated_value = applyCalibration(filtered_value);
+        // Pace per block: wait until the block's last sample is due (every sample
+        // in PER_SAMPLE mode). Replayed traces are paced by their own timestamps.
+        // Waits on sampling_cv so stopSampling() does not wait out a long block.
+        if (block_position == 0 && !replay_source) {
+            std::unique_lock<std::mutex> lock(sensor_mutex);
+            if (sampling_cv.wait_until(lock, next_sample_time, [this] { return !sampling_running.load(); })) {
+                break;
+            }
+            next_sample_time += sample_interval * static_cast<int64_t>(block_size);
+        }
+        
+        // Generate sample (recorded trace or synthetic source)
+        float raw_value;
+        if (replay_source) {
+            TraceReplaySource::Sample trace_sample;
+            if (!replay_source->next(trace_sample)) {
+                std::cout << "Sensor '" << device_name << "' replay finished after "
+                          << replay_source->getSamplesReplayed() << " samples" << std::endl;
+                // Stop on our own: isSampling() turns false and stopSampling() or
+                // the next startSampling() joins this thread. No locks after this.
+                std::lock_guard<std::mutex> lock(sensor_mutex);
+                sampling_enabled = false;
+                sampling_running = false;
+                break;
+            }
+            if (replay_source->getRateScale() > 0.0) {
+                // A sparse trace can leave long gaps: wait them out on sampling_cv
+                std::unique_lock<std::mutex> lock(sensor_mutex);
+                if (sampling_cv.wait_until(lock, replay_source->dueTime(trace_sample),
+                                           [this] { return !sampling_running.load(); })) {
+                    break;
+                }
+            }
+            raw_value = trace_sample.value;
+        } else {
+            raw_value = generateRawValue();
+        }
         
-        // Create sensor data
+        // One clock read per block, stamped backwards from it. A block that starts
+        // early (fast replay, pacing against a different clock) continues after the
+        // previous one instead of overlapping it, but no stamp passes the clock
+        // read: samples that would lie in the future share its time instead.
+        if (block_position == 0) {
+            block_now = readClock();
+            block_base = block_now - block_span;
+            if (!first_block && block_base <= last_stamp) {
+                block_base = last_stamp + sample_interval;
+            }
+            first_block = false;
+        }
         SensorData sample;
-        sample.timestamp = std::chrono::steady_clock::now();
-        sample.raw_value = raw_value;
-        sample.calibrated_value = calibrated_value;
-        sample.threshold_exceeded = checkThresholds(calibrated_value);
+        sample.timestamp = std::min(block_base + sample_interval * static_cast<int64_t>(block_position), block_now);
+        last_stamp = sample.timestamp;
+        block_position = (block_position + 1 == block_size) ? 0 : block_position + 1;
         
-        // Store in buffer
+        // Convert, filter and calibrate in fixed point; store in buffer
+        ThresholdMonitor::Transition transition;
         {
             std::lock_guard<std::mutex> lock(sensor_mutex);
-            data_buffer[buffer_index.load()] = sample;
-            buffer_index = (buffer_index.load() + 1) % buffer_size.load();
-            sample_count = sample_count.load() + 1;
-            
-            updateStatistics(calibrated_value);
-            writeToDeviceFile(formatDeviceData());
+            convertSampleLocked(raw_value, sample);
+            transition = commitSampleLocked(sample);
         }
-        
-        // Check for alerts
-        if (sample.threshold_exceeded && alerts_enabled.load() && alert_callback) {
-            std::string message = "Sensor '" + device_name + "' threshold exceeded: " + 
-                                std::to_string(calibrated_value);
-            
-            // Call alert callback in separate thread
-            std::thread([this, calibrated_value, message]() {
-                try {
-                    alert_callback(calibrated_value, message);
-                } catch (const std::exception& e) {
-                    std::cerr << "Error in sensor alert callback: " << e.what() << std::endl;
-                }
-            }).detach();
+        deliverSample(sample, transition);
+    }
+}
+
+bool Sensor::processSample(float raw_value, std::chrono::steady_clock::time_point timestamp) {
+    SensorData sample;
+    sample.timestamp = timestamp;
+    
+    // The sample stream is single-producer: hold feed_mutex through the publish
+    std::lock_guard<std::mutex> feed_lock(feed_mutex);
+    ThresholdMonitor::Transition transition;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        if (!initialized) {
+            std::cerr << "Error: Sensor not initialized" << std::endl;
+            return false;
         }
-        
-        // Sleep until next sample
-        next_sample_time += sample_interval;
-        std::this_thread::sleep_until(next_sample_time);
+        if (sampling_enabled.load()) {
+            std::cerr << "Error: Cannot feed samples while sampling" << std::endl;
+            return false;
+        }
+        convertSampleLocked(raw_value, sample);
+        transition = commitSampleLocked(sample);
+    }
+    deliverSample(sample, transition);
+    return true;
+}
+
+size_t Sensor::commitSamples(SensorData* samples, size_t count) {
+    // One lock for the batch; alerts are rare, so only their positions are kept.
+    // The sample stream is single-producer: hold feed_mutex through the publish
+    std::lock_guard<std::mutex> feed_lock(feed_mutex);
+    std::vector<size_t> alerts;
+    {
+        std::lock_guard<std::mutex> lock(sensor_mutex);
+        if (!initialized) {
+            std::cerr << "Error: Sensor not initialized" << std::endl;
+            return 0;
+        }
+        if (sampling_enabled.load()) {
+            std::cerr << "Error: Cannot feed samples while sampling" << std::endl;
+            return 0;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            ThresholdMonitor::Transition transition = commitSampleLocked(samples[i]);
+            if (transition == ThresholdMonitor::Transition::RAISED ||
+                transition == ThresholdMonitor::Transition::REPEATED) {
+                alerts.push_back(i);
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        sample_stream->publish(samples[i]);
+    }
+    if (alerts_enabled.load()) {
+        for (size_t i : alerts) {
+            alert_dispatcher->post(alert_source.load(), samples[i].calibrated_value);
+        }
+    }
+    return count;
+}
+
+void Sensor::convertSampleLocked(float raw_value, SensorData& sample) {
+    uint16_t code = quantizeLocked(raw_value);
+    sample.adc_code = code;
+    sample.raw_value = adc_min + static_cast<float>(code) * adc_lsb;
+    sample.calibrated_value = calibrateFilteredLocked(applyFilterLocked(code));
+}
+
+ThresholdMonitor::Transition Sensor::commitSampleLocked(SensorData& sample) {
+    float calibrated_value = sample.calibrated_value;
+    sample.threshold_exceeded = checkThresholds(calibrated_value);
+    
+    ThresholdMonitor::Transition transition = threshold_monitor.update(
+        calibrated_value, low_threshold.load(), high_threshold.load(), alert_policy);
+    // Seqlock-style: claim the sequence before overwriting the slot, so
+    // isViewValid() never accepts a view whose oldest slot is being rewritten
+    write_sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    data_buffer[buffer_index.load()] = sample;
+    buffer_index = (buffer_index.load() + 1) % data_buffer.size();
+    sample_count = sample_count.load() + 1;
+    
+    updateStatistics(calibrated_value);
+    value_sketch.update(calibrated_value);
+    value_rollup.update(calibrated_value, sample.timestamp);
+    if (sample.timestamp - last_device_file_update >= DEVICE_FILE_INTERVAL) {
+        writeToDeviceFile(formatDeviceData());
+        last_device_file_update = sample.timestamp;
+    }
+    
+    if (history_log) {
+        int64_t steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            sample.timestamp.time_since_epoch()).count();
+        history_log->append(steady_ns + log_clock_offset_ns, calibrated_value);
+    }
+    return transition;
+}
+
+void Sensor::deliverSample(const SensorData& sample, ThresholdMonitor::Transition transition) {
+    // Fan out to subscribers (lock-free unless a batch becomes due)
+    sample_stream->publish(sample);
+    
+    // Post alerts: debounce/hysteresis here, rate limiting and coalescing in the dispatcher
+    if ((transition == ThresholdMonitor::Transition::RAISED ||
+         transition == ThresholdMonitor::Transition::REPEATED) && alerts_enabled.load()) {
+        alert_dispatcher->post(alert_source.load(), sample.calibrated_value);
     }
 }
 
@@ -463,47 +1005,125 @@ float Sensor::generateRawValue() const {
     }
 }
 
-float Sensor::applyCalibration(float raw_value) const {
-    return (raw_value + calibration_offset.load()) * calibration_scale.load();
+uint16_t Sensor::quantizeLocked(float value) const {
+    return fixedpoint::quantize(value, adc_min, 1.0f / adc_lsb, adc_max_code);
 }
 
-float Sensor::applyFilter(float value) {
-    if (filter_type == FilterType::NONE) {
-        return value;
-    }
-    
-    filter_buffer.push_back(value);
-    if (filter_buffer.size() > static_cast<size_t>(filter_window_size.load())) {
-        filter_buffer.erase(filter_buffer.begin());
-    }
+int32_t Sensor::applyFilterLocked(uint16_t code) {
+    // Filters run on Q4 codes so averaging keeps sub-LSB precision
+    int32_t value = static_cast<int32_t>(code) << fixedpoint::FRACTION_BITS;
+    FilterState& state = filter_state;
     
     switch (filter_type) {
         case FilterType::MOVING_AVERAGE: {
-            float sum = std::accumulate(filter_buffer.begin(), filter_buffer.end(), 0.0f);
-            return sum / filter_buffer.size();
+            size_t window = static_cast<size_t>(filter_window_size.load());
+            if (state.window.size() != window) {
+                state.window.assign(window, 0);
+                state.position = 0;
+                state.filled = 0;
+                state.sum = 0;
+            }
+            state.sum += value - state.window[state.position];
+            state.window[state.position] = value;
+            state.position = (state.position + 1) % window;
+            state.filled = std::min(state.filled + 1, window);
+            int64_t count = static_cast<int64_t>(state.filled);
+            return static_cast<int32_t>((state.sum + count / 2) / count);
         }
         case FilterType::LOW_PASS: {
-            // Simple low-pass filter (exponential moving average)
-            static float alpha = 0.1f;
-            static float previous_output = value;
-            previous_output = alpha * value + (1.0f - alpha) * previous_output;
-            return previous_output;
+            // Exponential moving average, seeded with the first sample
+            state.output = state.primed ? fixedpoint::lowPassQ15(state.output, value, LOW_PASS_ALPHA) : value;
+            state.primed = true;
+            return state.output;
         }
         case FilterType::HIGH_PASS: {
-            // Simple high-pass filter
-            static float previous_input = value;
-            static float previous_output = 0.0f;
-            static float alpha = 0.9f;
-            float output = alpha * (previous_output + value - previous_input);
-            previous_input = value;
-            previous_output = output;
-            return output;
+            if (!state.primed) {
+                state.previous_input = value;
+                state.output = 0;
+                state.primed = true;
+            }
+            state.output = fixedpoint::highPassQ15(state.output, value, state.previous_input, HIGH_PASS_ALPHA);
+            state.previous_input = value;
+            return state.output;
         }
         default:
             return value;
     }
 }
 
+void Sensor::resetFilterLocked() {
+    filter_state.window.clear();
+    filter_state.position = 0;
+    filter_state.filled = 0;
+    filter_state.sum = 0;
+    filter_state.output = 0;
+    filter_state.previous_input = 0;
+    filter_state.primed = false;
+}
+
+void Sensor::rebuildFixedPointLocked() {
+    float maximum;
+    getADCRange(sensor_type, adc_min, maximum);
+    
+    int bits = std::clamp(adc_resolution.load(), 8, 16);
+    adc_max_code = static_cast<uint16_t>((1u << bits) - 1);
+    adc_lsb = (maximum - adc_min) / static_cast<float>(adc_max_code);
+    
+    // Recompile the current curve for the new code range
+    publishCalibrationLocked(calibration_state ? calibration_state->curve : Calibration::linear(0.0f, 1.0f));
+}
+
+void Sensor::publishCalibrationLocked(std::shared_ptr<const Calibration> curve) {
+    auto state = std::make_shared<CalibrationState>();
+    
+    if (curve->getKind() == Calibration::Kind::LINEAR) {
+        // calibrated = (adc_min + code * lsb + offset) * scale
+        double offset = curve->getOffset();
+        double scale = curve->getScale();
+        state->code_linear = fixedpoint::makeLinear(static_cast<double>(adc_lsb) * scale,
+                                                    (static_cast<double>(adc_min) + offset) * scale);
+        state->ac_linear = fixedpoint::makeLinear(static_cast<double>(adc_lsb) * scale, offset * scale);
+    } else {
+        // Evaluate the curve once per code; a sample then costs a table read
+        size_t codes = static_cast<size_t>(adc_max_code) + 1;
+        std::vector<float> inputs(codes);
+        for (size_t code = 0; code < codes; ++code) {
+            inputs[code] = adc_min + static_cast<float>(code) * adc_lsb;
+        }
+        state->code_table.resize(codes);
+        curve->applyBlock(inputs.data(), state->code_table.data(), codes);
+    }
+    
+    state->curve = std::move(curve);
+    std::atomic_store(&calibration_state, std::shared_ptr<const CalibrationState>(std::move(state)));
+}
+
+float Sensor::calibrateFilteredLocked(int32_t filtered_q4) const {
+    const CalibrationState& state = *calibration_state;
+    bool ac = (filter_type == FilterType::HIGH_PASS);
+    
+    if (state.code_table.empty()) {
+        return fixedpoint::apply(ac ? state.ac_linear : state.code_linear, filtered_q4, fixedpoint::FRACTION_BITS);
+    }
+    
+    if (ac) {
+        // High-pass output is a deviation, not a code: evaluate the curve on it directly
+        float deviation = static_cast<float>(filtered_q4) / static_cast<float>(1 << fixedpoint::FRACTION_BITS);
+        return state.curve->apply(deviation * adc_lsb);
+    }
+    
+    // Interpolate between neighbouring table entries with the Q4 fraction
+    int32_t last = static_cast<int32_t>(state.code_table.size()) - 1;
+    int32_t index = std::clamp(filtered_q4 >> fixedpoint::FRACTION_BITS, 0, last);
+    if (index == last) {
+        return state.code_table[last];
+    }
+    int32_t fraction = filtered_q4 & ((1 << fixedpoint::FRACTION_BITS) - 1);
+    float a = state.code_table[index];
+    float b = state.code_table[index + 1];
+    return a + (b - a) * (static_cast<float>(fraction) / static_cast<float>(1 << fixedpoint::FRACTION_BITS));
+}
+
 bool Sensor::checkThresholds(float value) {
     return (value < low_threshold.load()) || (value > high_threshold.load());
 }
@@ -552,6 +1172,18 @@ std::string Sensor::sensorTypeToString(SensorType type) {
     }
 }
 
+void Sensor::getADCRange(SensorType type, float& minimum, float& maximum) {
+    switch (type) {
+        case SensorType::TEMPERATURE: minimum = -40.0f; maximum = 85.0f; break;
+        case SensorType::PRESSURE: minimum = 0.0f; maximum = 1200.0f; break;
+        case SensorType::HUMIDITY: minimum = 0.0f; maximum = 100.0f; break;
+        case SensorType::ACCELEROMETER: minimum = -2.0f; maximum = 2.0f; break;
+        case SensorType::LIGHT: minimum = 0.0f; maximum = 65535.0f; break;
+        case SensorType::VOLTAGE: minimum = 0.0f; maximum = 3.6f; break;
+        default: minimum = 0.0f; maximum = 1.0f; break;
+    }
+}
+
 std::string Sensor::filterTypeToString(FilterType type) {
     switch (type) {
         case FilterType::NONE: return "None";
@@ -562,6 +1194,14 @@ std::string Sensor::filterTypeToString(FilterType type) {
     }
 }
 
+std::string Sensor::timestampModeToString(TimestampMode mode) {
+    switch (mode) {
+        case TimestampMode::PER_SAMPLE: return "Per Sample";
+        case TimestampMode::BLOCK: return "Block";
+        default: return "Unknown";
+    }
+}
+
 Sensor::Statistics Sensor::getStatistics() const {
     std::lock_guard<std::mutex> lock(sensor_mutex);
     Statistics stats;
@@ -571,30 +1211,70 @@ Sensor::Statistics Sensor::getStatistics() const {
     stats.avg_val = avg_value.load();
     stats.count = sample_count.load();
     
-    // Calculate standard deviation
-    if (stats.count > 1) {
-        auto buffer_data = readBuffer();
+    // Calculate standard deviation over the buffered samples (read in place;
+    // readBuffer() would re-lock sensor_mutex)
+    BufferView view = viewBufferLocked(0);
+    if (stats.count > 1 && view.samples.size() > 1) {
         float sum_squared_diff = 0.0f;
         
-        for (const auto& sample : buffer_data) {
-            float diff = sample.calibrated_value - stats.avg_val;
-            sum_squared_diff += diff * diff;
-        }
+        view.samples.forEachSegment([&](Span<const SensorData> segment) {
+            for (const auto& sample : segment) {
+                float diff = sample.calibrated_value - stats.avg_val;
+                sum_squared_diff += diff * diff;
+            }
+        });
         
-        stats.std_deviation = std::sqrt(sum_squared_diff / (stats.count - 1));
+        stats.std_deviation = std::sqrt(sum_squared_diff / (view.samples.size() - 1));
     } else {
         stats.std_deviation = 0.0f;
     }
     
+    // Percentiles from the streaming sketch (no sort of the ring buffer)
+    stats.p50 = value_sketch.quantile(0.50);
+    stats.p95 = value_sketch.quantile(0.95);
+    stats.p99 = value_sketch.quantile(0.99);
+    
     return stats;
 }
 
+float Sensor::getPercentile(double q) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return value_sketch.quantile(q);
+}
+
+QuantileSketch Sensor::getQuantileSketch() const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return value_sketch;
+}
+
+QuantileSketch Sensor::getRecentQuantiles(std::chrono::seconds window) const {
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    return value_rollup.window(window);
+}
+
+bool Sensor::setPercentileRollup(std::chrono::seconds bucket_duration, size_t bucket_count) {
+    if (bucket_duration.count() <= 0 || bucket_count < 1 || bucket_count > 10000) {
+        std::cerr << "Error: Invalid percentile rollup configuration" << std::endl;
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(sensor_mutex);
+    if (sampling_enabled.load()) {
+        std::cerr << "Error: Cannot change percentile rollup while sampling" << std::endl;
+        return false;
+    }
+    value_rollup = QuantileRollup(bucket_duration, bucket_count);
+    return true;
+}
+
 bool Sensor::resetStatistics() {
     std::lock_guard<std::mutex> lock(sensor_mutex);
     
     min_value = std::numeric_limits<float>::max();
     max_value = std::numeric_limits<float>::lowest();
     avg_value = 0.0f;
+    value_sketch.reset();
+    value_rollup.reset();
     sample_count = 0;
     
     return true;
@@ -614,14 +1294,12 @@ Sensor::SensorRegisters Sensor::getRegisters() const {
                   (alerts_enabled.load() ? 0x02 : 0x00) |
                   ((sample_count.load() > 0) ? 0x04 : 0x00);
     
-    // Latest data (simulated 16-bit ADC)
-    if (sample_count.load() > 0) {
-        SensorData latest;
-        if (readLatestSample(latest)) {
-            uint32_t adc_value = static_cast<uint32_t>(latest.raw_value * ((1 << adc_resolution.load()) - 1));
-            regs.data_high = static_cast<uint16_t>(adc_value >> 16);
-            regs.data_low = static_cast<uint16_t>(adc_value & 0xFFFF);
-        }
+    // Latest ADC result (right-aligned, adc_resolution bits)
+    regs.data_high = 0;
+    regs.data_low = 0;
+    BufferView view = viewBufferLocked(1);
+    if (!view.samples.empty()) {
+        regs.data_low = view.samples[0].adc_code;
     }
     
     // Thresholds (scaled to 16-bit)
@@ -633,8 +1311,9 @@ Sensor::SensorRegisters Sensor::getRegisters() const {
                   (static_cast<uint16_t>(adc_resolution.load()) << 8);
     
     // Calibration (scaled)
-    regs.calibration = static_cast<uint16_t>(calibration_scale.load() * 1000) |
-                       (static_cast<uint16_t>(calibration_offset.load() * 10) << 8);
+    const Calibration& curve = *calibration_state->curve;
+    regs.calibration = static_cast<uint16_t>(curve.getScale() * 1000) |
+                       (static_cast<uint16_t>(curve.getOffset() * 10) << 8);
     
     return regs;
 }
@@ -649,15 +1328,24 @@ bool Sensor::setRegisters(const SensorRegisters& regs) {
     sensor_type = static_cast<SensorType>((regs.control >> 1) & 0x07);
     filter_type = static_cast<FilterType>((regs.control >> 4) & 0x03);
     sampling_rate_hz = regs.config & 0xFF;
-    adc_resolution = (regs.config >> 8) & 0xFF;
+    int bits = (regs.config >> 8) & 0xFF;
+    if (bits >= 8 && bits <= 16) {
+        adc_resolution = bits;
+    }
     
     // Update thresholds
     high_threshold = static_cast<float>(regs.threshold_h) / 100.0f;
     low_threshold = static_cast<float>(regs.threshold_l) / 100.0f;
     
-    // Update calibration
-    calibration_scale = static_cast<float>(regs.calibration & 0xFF) / 1000.0f;
-    calibration_offset = static_cast<float>(regs.calibration >> 8) / 10.0f;
+    rebuildFixedPointLocked();
+    resetFilterLocked();
+    
+    // Update calibration (a zero scale field leaves the current curve in place)
+    auto curve = Calibration::linear(static_cast<float>(regs.calibration >> 8) / 10.0f,
+                                     static_cast<float>(regs.calibration & 0xFF) / 1000.0f);
+    if (curve) {
+        publishCalibrationLocked(std::move(curve));
+    }
     
     alerts_enabled = (regs.status & 0x02) != 0;
     
@@ -0,0 +1,968 @@
+#include "sdk/sensor_array.h"
+#include "common/simd.h"
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr size_t BLOCK_SENSORS = 512;     // Sensors advanced through a whole batch of ticks at a time
+constexpr float LOW_PASS_ALPHA = 0.1f;    // Same responses as MultiChannelSensor
+constexpr float HIGH_PASS_ALPHA = 0.9f;
+
+inline uint32_t xorshift32(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+inline __m128i xorshift32(__m128i x) {
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+#endif
+
+} // namespace
+
+SensorArray::SensorArray(const std::string& name, SensorType type, size_t count, const Config& cfg)
+    : Peripheral(name),
+      sensor_type(type),
+      sensor_count(std::clamp<size_t>(count, 1, MAX_SENSORS)),
+      padded_count(0),
+      config(cfg),
+      sampling_enabled(false),
+      sampling_rate_hz(10),
+      adc_min(0.0f),
+      adc_lsb(1.0f),
+      adc_max_code(0),
+      source_uniform(false),
+      source_offset(0.0f),
+      source_spread(0.0f),
+      source_min(0.0f),
+      source_max(0.0f),
+      filter_type(FilterType::NONE),
+      filter_window_size(5),
+      filter_position(0),
+      filter_ticks(0),
+      stat_count(0),
+      history_head(0),
+      history_stored(0),
+      tick_count(0),
+      threshold_crossings(0),
+      alerts_enabled(false),
+      alert_dispatcher(AlertDispatcher::getDefault()),
+      alert_source(AlertDispatcher::INVALID_SOURCE),
+      current_job{},
+      job_id(0),
+      pool_pending(0),
+      pool_stop(false),
+      sampling_running(false) {
+
+    if (count != sensor_count) {
+        std::cerr << "Warning: Sensor count for '" << name << "' clamped to " << sensor_count << std::endl;
+    }
+    config.history = std::clamp<size_t>(config.history, 1, MAX_HISTORY);
+    config.adc_resolution = std::clamp(config.adc_resolution, 8, 16);
+    padded_count = (sensor_count + SLICE_ALIGNMENT - 1) / SLICE_ALIGNMENT * SLICE_ALIGNMENT;
+
+    // Independent, non-zero generator state per sensor
+    std::mt19937_64 seeder(std::random_device{}());
+    rng_state.resize(padded_count);
+    for (uint32_t& state : rng_state) {
+        do {
+            state = static_cast<uint32_t>(seeder());
+        } while (state == 0);
+    }
+
+    calibration_offset.assign(padded_count, 0.0f);
+    calibration_scale.assign(padded_count, 1.0f);
+    low_threshold.assign(padded_count, std::numeric_limits<float>::lowest());
+    high_threshold.assign(padded_count, std::numeric_limits<float>::max());
+
+    history_codes.assign(config.history * padded_count, 0);
+    history_values.assign(config.history * padded_count, 0.0f);
+    history_flags.assign(config.history * (padded_count / 8), 0);
+    history_times.resize(config.history);
+
+    rebuildModelLocked();
+    resetFilterLocked();
+    resetStatisticsLocked();
+}
+
+SensorArray::~SensorArray() {
+    if (initialized) {
+        cleanup();
+    }
+}
+
+SensorArray::Config SensorArray::defaultConfig() {
+    Config cfg;
+    cfg.history = 16;
+    cfg.threads = 0;
+    cfg.adc_resolution = 12;
+    return cfg;
+}
+
+bool SensorArray::initialize() {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    if (initialized) {
+        return true;
+    }
+
+    sampling_enabled = false;
+    resetHistoryLocked();
+    resetFilterLocked();
+    resetStatisticsLocked();
+
+    if (!writeToDeviceFile(formatDeviceData())) {
+        std::cerr << "Error: Failed to initialize SensorArray device file" << std::endl;
+        return false;
+    }
+
+    startWorkersLocked();
+    initialized = true;
+    std::cout << "SensorArray '" << device_name << "' (" << Sensor::sensorTypeToString(sensor_type)
+              << " x" << sensor_count << ", " << slice_bounds.size() - 1 << " threads, "
+              << simd::backendName() << ") initialized successfully" << std::endl;
+    return true;
+}
+
+bool SensorArray::cleanup() {
+    // All of these wait on other threads, so run them unlocked
+    stopSampling();
+    disableAlerts();
+    stopWorkers();
+
+    std::lock_guard<std::mutex> lock(array_mutex);
+    resetHistoryLocked();
+    writeToDeviceFile(formatDeviceData());
+
+    initialized = false;
+    std::cout << "SensorArray '" << device_name << "' cleaned up" << std::endl;
+    return true;
+}
+
+std::string SensorArray::getStatus() const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    std::stringstream ss;
+
+    ss << "SensorArray '" << device_name << "' (" << Sensor::sensorTypeToString(sensor_type)
+       << " x" << sensor_count << ") - ";
+    ss << "Sampling: " << (sampling_enabled.load() ? "ON" : "OFF") << ", ";
+    ss << "Rate: " << sampling_rate_hz.load() << "Hz, ";
+    ss << "ADC: " << config.adc_resolution << "-bit, ";
+    ss << "Filter: " << Sensor::filterTypeToString(filter_type) << ", ";
+    ss << "Threads: " << (slice_bounds.empty() ? 0 : slice_bounds.size() - 1) << ", ";
+    ss << "Ticks: " << tick_count << ", ";
+    ss << "Crossings: " << threshold_crossings;
+
+    if (alerts_enabled.load()) {
+        ss << ", Alerts: ENABLED";
+    }
+
+    return ss.str();
+}
+
+size_t SensorArray::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return slice_bounds.empty() ? 0 : slice_bounds.size() - 1;
+}
+
+bool SensorArray::setSamplingRate(int hz) {
+    if (hz < 1 || hz > 10000) {
+        std::cerr << "Error: Sampling rate must be between 1-10000 Hz" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(array_mutex);
+    if (sampling_enabled.load()) {
+        std::cerr << "Error: Cannot change sampling rate while sampling" << std::endl;
+        return false;
+    }
+    sampling_rate_hz = hz;
+    return true;
+}
+
+bool SensorArray::setFilter(FilterType type, int window_size) {
+    if (window_size < 1 || window_size > 100) {
+        std::cerr << "Error: Filter window size must be between 1-100" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(array_mutex);
+    filter_type = type;
+    filter_window_size = static_cast<size_t>(window_size);
+    resetFilterLocked();
+    return true;
+}
+
+SensorArray::FilterType SensorArray::getFilterType() const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return filter_type;
+}
+
+bool SensorArray::validSensor(size_t sensor) const {
+    if (sensor >= sensor_count) {
+        std::cerr << "Error: Invalid sensor " << sensor << " (array has " << sensor_count << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SensorArray::setCalibration(size_t sensor, float offset, float scale) {
+    if (!validSensor(sensor)) {
+        return false;
+    }
+    if (scale == 0.0f) {
+        std::cerr << "Error: Calibration scale cannot be zero" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(array_mutex);
+    calibration_offset[sensor] = offset;
+    calibration_scale[sensor] = scale;
+    return true;
+}
+
+bool SensorArray::setCalibration(const std::vector<float>& offsets, const std::vector<float>& scales) {
+    if (offsets.size() != sensor_count || scales.size() != sensor_count) {
+        std::cerr << "Error: Calibration vectors must have " << sensor_count << " entries" << std::endl;
+        return false;
+    }
+    if (std::find(scales.begin(), scales.end(), 0.0f) != scales.end()) {
+        std::cerr << "Error: Calibration scale cannot be zero" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(array_mutex);
+    std::copy(offsets.begin(), offsets.end(), calibration_offset.begin());
+    std::copy(scales.begin(), scales.end(), calibration_scale.begin());
+    return true;
+}
+
+float SensorArray::getCalibrationOffset(size_t sensor) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return (sensor < sensor_count) ? calibration_offset[sensor] : 0.0f;
+}
+
+float SensorArray::getCalibrationScale(size_t sensor) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return (sensor < sensor_count) ? calibration_scale[sensor] : 1.0f;
+}
+
+bool SensorArray::setThresholds(size_t sensor, float low, float high) {
+    if (!validSensor(sensor)) {
+        return false;
+    }
+    if (low >= high) {
+        std::cerr << "Error: Low threshold must be less than high threshold" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(array_mutex);
+    low_threshold[sensor] = low;
+    high_threshold[sensor] = high;
+    return true;
+}
+
+bool SensorArray::setThresholds(float low, float high) {
+    if (low >= high) {
+        std::cerr << "Error: Low threshold must be less than high threshold" << std::endl;
+        return false;
+    }
+
+    // Padding lanes keep the open band so they never count as crossings
+    std::lock_guard<std::mutex> lock(array_mutex);
+    std::fill(low_threshold.begin(), low_threshold.begin() + sensor_count, low);
+    std::fill(high_threshold.begin(), high_threshold.begin() + sensor_count, high);
+    return true;
+}
+
+float SensorArray::getLowThreshold(size_t sensor) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return (sensor < sensor_count) ? low_threshold[sensor] : std::numeric_limits<float>::lowest();
+}
+
+float SensorArray::getHighThreshold(size_t sensor) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return (sensor < sensor_count) ? high_threshold[sensor] : std::numeric_limits<float>::max();
+}
+
+bool SensorArray::enableAlerts(AlertCallback callback, std::chrono::milliseconds min_interval) {
+    if (!callback) {
+        std::cerr << "Error: Invalid callback function" << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<AlertDispatcher> dispatcher;
+    {
+        std::lock_guard<std::mutex> lock(array_mutex);
+        if (!initialized) {
+            std::cerr << "Error: SensorArray not initialized" << std::endl;
+            return false;
+        }
+        dispatcher = alert_dispatcher;
+    }
+
+    AlertDispatcher::SourceId source = dispatcher->registerSource(
+        "SensorArray '" + device_name + "' threshold crossings", std::move(callback), min_interval);
+    if (source == AlertDispatcher::INVALID_SOURCE) {
+        return false;
+    }
+
+    AlertDispatcher::SourceId previous;
+    {
+        std::lock_guard<std::mutex> lock(array_mutex);
+        previous = alert_source;
+        alert_source = source;
+        alerts_enabled = true;
+    }
+
+    if (previous != AlertDispatcher::INVALID_SOURCE) {
+        dispatcher->unregisterSource(previous);
+    }
+    std::cout << "SensorArray '" << device_name << "' alerts enabled" << std::endl;
+    return true;
+}
+
+bool SensorArray::disableAlerts() {
+    AlertDispatcher::SourceId previous;
+    {
+        std::lock_guard<std::mutex> lock(array_mutex);
+        if (!alerts_enabled.load()) {
+            return true;
+        }
+        alerts_enabled = false;
+        previous = alert_source;
+        alert_source = AlertDispatcher::INVALID_SOURCE;
+    }
+
+    // Unregister unlocked: it waits for an in-flight callback that may call back into us
+    alert_dispatcher->unregisterSource(previous);
+    std::cout << "SensorArray '" << device_name << "' alerts disabled" << std::endl;
+    return true;
+}
+
+bool SensorArray::setAlertDispatcher(std::shared_ptr<AlertDispatcher> dispatcher) {
+    if (!dispatcher) {
+        std::cerr << "Error: Invalid alert dispatcher" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(array_mutex);
+    if (sampling_enabled.load() || alerts_enabled.load()) {
+        std::cerr << "Error: Cannot change alert dispatcher while sampling or alerts are enabled" << std::endl;
+        return false;
+    }
+    alert_dispatcher = std::move(dispatcher);
+    return true;
+}
+
+bool SensorArray::startSampling() {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    if (!initialized) {
+        std::cerr << "Error: SensorArray not initialized" << std::endl;
+        return false;
+    }
+
+    if (sampling_enabled.load()) {
+        return true; // Already sampling
+    }
+
+    sampling_enabled = true;
+    sampling_running = true;
+    sampling_thread = std::thread(&SensorArray::samplingLoop, this);
+
+    std::cout << "SensorArray '" << device_name << "' started sampling " << sensor_count
+              << " sensors at " << sampling_rate_hz.load() << "Hz" << std::endl;
+    return true;
+}
+
+bool SensorArray::stopSampling() {
+    std::thread sampler;
+    {
+        std::lock_guard<std::mutex> lock(array_mutex);
+        if (!sampling_enabled.load()) {
+            return true; // Already stopped
+        }
+        sampling_enabled = false;
+        sampling_running = false;
+        sampling_cv.notify_all();
+        sampler = std::move(sampling_thread);
+    }
+
+    // Join outside the lock: the ticking thread holds array_mutex while it runs a batch
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+
+    std::cout << "SensorArray '" << device_name << "' stopped sampling" << std::endl;
+    return true;
+}
+
+size_t SensorArray::advance(size_t ticks) {
+    size_t crossings;
+    AlertDispatcher::SourceId source;
+    {
+        std::lock_guard<std::mutex> lock(array_mutex);
+        if (!initialized) {
+            std::cerr << "Error: SensorArray not initialized" << std::endl;
+            return 0;
+        }
+        if (sampling_enabled.load()) {
+            std::cerr << "Error: Cannot advance manually while sampling" << std::endl;
+            return 0;
+        }
+        if (ticks == 0) {
+            return 0;
+        }
+
+        // Stamp the batch as ending now, one sampling period apart
+        auto interval = std::chrono::nanoseconds(1000000000LL / sampling_rate_hz.load());
+        auto first_time = std::chrono::steady_clock::now() - interval * static_cast<int64_t>(ticks - 1);
+        crossings = advanceLocked(ticks, first_time, interval);
+        source = alert_source;
+    }
+
+    if (crossings > 0 && alerts_enabled.load()) {
+        alert_dispatcher->post(source, static_cast<float>(crossings));
+    }
+    return crossings;
+}
+
+bool SensorArray::readLatestSample(size_t sensor, SensorData& data) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    if (!initialized || sensor >= sensor_count || history_stored == 0) {
+        return false;
+    }
+
+    size_t row = (history_head + config.history - 1) % config.history;
+    size_t cell = row * padded_count + sensor;
+    data.timestamp = history_times[row];
+    data.adc_code = history_codes[cell];
+    data.raw_value = adc_min + static_cast<float>(data.adc_code) * adc_lsb;
+    data.calibrated_value = history_values[cell];
+    data.threshold_exceeded = (history_flags[cell / 8] >> (sensor % 8)) & 1u;
+    return true;
+}
+
+std::vector<SensorArray::SensorData> SensorArray::readBuffer(size_t sensor, size_t num_samples) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    std::vector<SensorData> result;
+    if (!initialized || sensor >= sensor_count) {
+        return result;
+    }
+
+    size_t count = (num_samples == 0) ? history_stored : std::min(num_samples, history_stored);
+    result.resize(count);
+    size_t row = (history_head + config.history - count) % config.history;
+    for (size_t i = 0; i < count; ++i) {
+        size_t cell = row * padded_count + sensor;
+        SensorData& data = result[i];
+        data.timestamp = history_times[row];
+        data.adc_code = history_codes[cell];
+        data.raw_value = adc_min + static_cast<float>(data.adc_code) * adc_lsb;
+        data.calibrated_value = history_values[cell];
+        data.threshold_exceeded = (history_flags[cell / 8] >> (sensor % 8)) & 1u;
+        row = (row + 1 == config.history) ? 0 : row + 1;
+    }
+    return result;
+}
+
+SensorArray::Statistics SensorArray::getStatistics(size_t sensor) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    Statistics stats{};
+    float not_tracked = std::numeric_limits<float>::quiet_NaN();
+    stats.p50 = not_tracked;
+    stats.p95 = not_tracked;
+    stats.p99 = not_tracked;
+    if (sensor >= sensor_count || stat_count == 0) {
+        return stats;
+    }
+
+    stats.min_val = stat_min[sensor];
+    stats.max_val = stat_max[sensor];
+    stats.avg_val = stat_mean[sensor];
+    stats.count = stat_count;
+    stats.std_deviation = (stat_count > 1)
+        ? std::sqrt(stat_m2[sensor] / static_cast<float>(stat_count - 1)) : 0.0f;
+    return stats;
+}
+
+size_t SensorArray::readExceeded(std::vector<size_t>& sensors) const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    sensors.clear();
+    if (history_stored == 0) {
+        return 0;
+    }
+
+    // Skip clear bytes; the latest row is mostly zeros in a healthy plant
+    size_t row = (history_head + config.history - 1) % config.history;
+    const uint8_t* flags = history_flags.data() + row * (padded_count / 8);
+    for (size_t byte = 0; byte < padded_count / 8; ++byte) {
+        for (uint32_t bits = flags[byte]; bits != 0; bits &= bits - 1) {
+            sensors.push_back(byte * 8 + static_cast<size_t>(__builtin_ctz(bits)));
+        }
+    }
+    return sensors.size();
+}
+
+uint64_t SensorArray::getTickCount() const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return tick_count;
+}
+
+uint64_t SensorArray::getThresholdCrossings() const {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    return threshold_crossings;
+}
+
+bool SensorArray::resetStatistics() {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    resetStatisticsLocked();
+    return true;
+}
+
+bool SensorArray::clearBuffer() {
+    std::lock_guard<std::mutex> lock(array_mutex);
+    if (!initialized) {
+        return false;
+    }
+    resetHistoryLocked();
+    resetStatisticsLocked();
+    return true;
+}
+
+void SensorArray::samplingLoop() {
+    const auto interval = std::chrono::nanoseconds(1000000000LL / sampling_rate_hz.load());
+    // High rates run several ticks per wake instead of sleeping per tick
+    const int64_t ticks_per_wake = std::max<int64_t>(
+        1, std::chrono::nanoseconds(MIN_WAKE_INTERVAL).count() / interval.count());
+    auto next_tick_time = std::chrono::steady_clock::now();
+
+    while (true) {
+        size_t crossings;
+        AlertDispatcher::SourceId source;
+        {
+            std::unique_lock<std::mutex> lock(array_mutex);
+            auto due = next_tick_time + interval * (ticks_per_wake - 1);
+            if (sampling_cv.wait_until(lock, due, [this] { return !sampling_running.load(); })) {
+                break;
+            }
+
+            crossings = advanceLocked(static_cast<size_t>(ticks_per_wake), next_tick_time, interval);
+            next_tick_time += interval * ticks_per_wake;
+            source = alert_source;
+
+            auto now = history_times[(history_head + config.history - 1) % config.history];
+            if (now - last_device_file_update >= DEVICE_FILE_INTERVAL) {
+                writeToDeviceFile(formatDeviceData());
+                last_device_file_update = now;
+            }
+        }
+
+        if (crossings > 0 && alerts_enabled.load()) {
+            alert_dispatcher->post(source, static_cast<float>(crossings));
+        }
+    }
+}
+
+size_t SensorArray::advanceLocked(size_t ticks, std::chrono::steady_clock::time_point first_time,
+                                  std::chrono::nanoseconds interval) {
+    size_t crossings = 0;
+    size_t done = 0;
+    while (done < ticks) {
+        // A batch never wraps the history ring onto itself
+        size_t batch = std::min(ticks - done, config.history);
+        crossings += runJobLocked(batch);
+
+        for (size_t t = 0; t < batch; ++t) {
+            history_times[(history_head + t) % config.history] =
+                first_time + interval * static_cast<int64_t>(done + t);
+        }
+        history_head = (history_head + batch) % config.history;
+        history_stored = std::min(history_stored + batch, config.history);
+        filter_position = (filter_position + batch) % filter_window_size;
+        filter_ticks += batch;
+        stat_count += batch;
+        tick_count += batch;
+        done += batch;
+    }
+
+    threshold_crossings += crossings;
+    return crossings;
+}
+
+size_t SensorArray::runJobLocked(size_t ticks) {
+    TickJob job;
+    job.stride = padded_count;
+    job.ticks = ticks;
+    job.rng = rng_state.data();
+    job.uniform = source_uniform;
+    job.source_offset = source_offset;
+    job.source_spread = source_spread;
+    job.source_min = source_min;
+    job.source_max = source_max;
+    job.adc_min = adc_min;
+    job.adc_lsb = adc_lsb;
+    job.adc_inv_lsb = 1.0f / adc_lsb;
+    job.adc_max_code = static_cast<float>(adc_max_code);
+    job.filter_type = filter_type;
+    job.filter_state = filter_state.data();
+    job.filter_prev_input = filter_prev_input.data();
+    job.filter_sum = filter_sum.data();
+    job.filter_window = filter_window.data();
+    job.window_size = filter_window_size;
+    job.window_position = filter_position;
+    job.filter_ticks = filter_ticks;
+    job.calibration_offset = calibration_offset.data();
+    job.calibration_scale = calibration_scale.data();
+    job.low_threshold = low_threshold.data();
+    job.high_threshold = high_threshold.data();
+    job.stat_min = stat_min.data();
+    job.stat_max = stat_max.data();
+    job.stat_mean = stat_mean.data();
+    job.stat_m2 = stat_m2.data();
+    job.stat_count = stat_count;
+    job.history_codes = history_codes.data();
+    job.history_values = history_values.data();
+    job.history_flags = history_flags.data();
+    job.history_size = config.history;
+    job.history_head = history_head;
+    job.history_stored = history_stored;
+
+    if (!workers.empty()) {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        current_job = job;
+        job_id++;
+        pool_pending = workers.size();
+        pool_cv.notify_all();
+    }
+
+    size_t crossings = runFiltered(job, slice_bounds[0], slice_bounds[1]);
+
+    if (!workers.empty()) {
+        std::unique_lock<std::mutex> lock(pool_mutex);
+        pool_done_cv.wait(lock, [this] { return pool_pending == 0; });
+        for (size_t slice = 1; slice < slice_crossings.size(); ++slice) {
+            crossings += slice_crossings[slice];
+        }
+    }
+    return crossings;
+}
+
+void SensorArray::workerLoop(size_t slice, uint64_t seen) {
+    while (true) {
+        TickJob job;
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex);
+            pool_cv.wait(lock, [this, seen] { return pool_stop || job_id != seen; });
+            if (pool_stop) {
+                return;
+            }
+            seen = job_id;
+            job = current_job;
+        }
+
+        size_t crossings = runFiltered(job, slice_bounds[slice], slice_bounds[slice + 1]);
+
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        slice_crossings[slice] = crossings;
+        if (--pool_pending == 0) {
+            pool_done_cv.notify_one();
+        }
+    }
+}
+
+void SensorArray::startWorkersLocked() {
+    size_t threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    // Small arrays are not worth the hand-off; keep at least a few blocks per slice
+    size_t blocks = (padded_count + BLOCK_SENSORS - 1) / BLOCK_SENSORS;
+    threads = std::clamp<size_t>(std::min(threads, (blocks + 3) / 4), 1, MAX_THREADS);
+
+    slice_bounds.assign(threads + 1, 0);
+    size_t units = padded_count / SLICE_ALIGNMENT;
+    for (size_t slice = 0; slice <= threads; ++slice) {
+        slice_bounds[slice] = units * slice / threads * SLICE_ALIGNMENT;
+    }
+    slice_crossings.assign(threads, 0);
+
+    pool_stop = false;
+    for (size_t slice = 1; slice < threads; ++slice) {
+        workers.emplace_back(&SensorArray::workerLoop, this, slice, job_id);
+    }
+}
+
+void SensorArray::stopWorkers() {
+    std::vector<std::thread> stopping;
+    {
+        std::lock_guard<std::mutex> lock(array_mutex);
+        std::lock_guard<std::mutex> pool_lock(pool_mutex);
+        pool_stop = true;
+        pool_cv.notify_all();
+        stopping = std::move(workers);
+        workers.clear();
+    }
+
+    for (auto& worker : stopping) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t SensorArray::runFiltered(const TickJob& job, size_t begin, size_t end) {
+    // One instantiation per filter keeps the filter choice out of the inner loop
+    switch (job.filter_type) {
+        case FilterType::MOVING_AVERAGE: return runSlice<FilterType::MOVING_AVERAGE>(job, begin, end);
+        case FilterType::LOW_PASS: return runSlice<FilterType::LOW_PASS>(job, begin, end);
+        case FilterType::HIGH_PASS: return runSlice<FilterType::HIGH_PASS>(job, begin, end);
+        default: return runSlice<FilterType::NONE>(job, begin, end);
+    }
+}
+
+template <SensorArray::FilterType Filter>
+size_t SensorArray::runSlice(const TickJob& job, size_t begin, size_t end) {
+    size_t crossings = 0;
+    const size_t flag_stride = job.stride / 8;
+
+    // Block-outer, tick-inner: a block's state stays in L1 for the whole batch
+    for (size_t block = begin; block < end; block += BLOCK_SENSORS) {
+        const size_t block_end = std::min(block + BLOCK_SENSORS, end);
+
+        for (size_t t = 0; t < job.ticks; ++t) {
+            const size_t row = (job.history_head + t) % job.history_size;
+            const size_t previous_row = (row + job.history_size - 1) % job.history_size;
+            const bool has_previous = job.history_stored + t > 0;
+            const bool prime = job.filter_ticks + t == 0;
+            const size_t filled = std::min(job.filter_ticks + t + 1, job.window_size);
+            const float inv_filled = 1.0f / static_cast<float>(filled);
+            const float inv_count = 1.0f / static_cast<float>(job.stat_count + t + 1);
+            float* window_row = job.filter_window + ((job.window_position + t) % job.window_size) * job.stride;
+            uint16_t* codes = job.history_codes + row * job.stride;
+            float* values = job.history_values + row * job.stride;
+            uint8_t* flags = job.history_flags + row * flag_stride;
+            const uint8_t* previous_flags = job.history_flags + previous_row * flag_stride;
+
+#if defined(SIMD_USE_AVX) || defined(SIMD_USE_SSE2)
+            const __m128 src_offset = _mm_set1_ps(job.source_offset);
+            const __m128 src_spread = _mm_set1_ps(job.source_spread);
+            const __m128 src_min = _mm_set1_ps(job.source_min);
+            const __m128 src_max = _mm_set1_ps(job.source_max);
+            const __m128 code_min = _mm_set1_ps(job.adc_min);
+            const __m128 lsb = _mm_set1_ps(job.adc_lsb);
+            const __m128 inv_lsb = _mm_set1_ps(job.adc_inv_lsb);
+            const __m128 max_code = _mm_set1_ps(job.adc_max_code);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128i low16 = _mm_set1_epi32(0xFFFF);
+
+            const __m128i bias32 = _mm_set1_epi32(32768);
+            const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+            for (size_t i = block; i < block_end; i += 8) {
+                // Two groups of four sensors through the whole pipeline
+                __m128i group_codes[2];
+                uint32_t mask = 0;
+                for (size_t group = 0; group < 2; ++group) {
+                    const size_t j = i + group * 4;
+                    __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(job.rng + j));
+                    __m128 noise;
+                    if (job.uniform) {
+                        state = xorshift32(state);
+                        noise = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(state, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+                    } else {
+                        // Irwin-Hall: four 16-bit uniforms from two draws, centred
+                        __m128i first = xorshift32(state);
+                        state = xorshift32(first);
+                        __m128i sum = _mm_add_epi32(
+                            _mm_add_epi32(_mm_and_si128(first, low16), _mm_srli_epi32(first, 16)),
+                            _mm_add_epi32(_mm_and_si128(state, low16), _mm_srli_epi32(state, 16)));
+                        noise = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(1.0f / 65536.0f)),
+                                           _mm_set1_ps(2.0f));
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(job.rng + j), state);
+
+                    __m128 x = _mm_add_ps(src_offset, _mm_mul_ps(src_spread, noise));
+                    x = _mm_min_ps(_mm_max_ps(x, src_min), src_max);
+
+                    // Quantize and dequantize (raw_value is what the ADC reports)
+                    __m128 level = _mm_mul_ps(_mm_sub_ps(x, code_min), inv_lsb);
+                    __m128i code = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(level, zero), max_code));
+                    __m128 input = _mm_add_ps(code_min, _mm_mul_ps(_mm_cvtepi32_ps(code), lsb));
+
+                    __m128 filtered = input;
+                    if constexpr (Filter == FilterType::LOW_PASS) {
+                        __m128 s = _mm_loadu_ps(job.filter_state + j);
+                        s = prime ? input : _mm_add_ps(s, _mm_mul_ps(_mm_sub_ps(input, s), _mm_set1_ps(LOW_PASS_ALPHA)));
+                        _mm_storeu_ps(job.filter_state + j, s);
+                        filtered = s;
+                    } else if constexpr (Filter == FilterType::HIGH_PASS) {
+                        __m128 y = zero;
+                        if (!prime) {
+                            __m128 delta = _mm_sub_ps(input, _mm_loadu_ps(job.filter_prev_input + j));
+                            y = _mm_mul_ps(_mm_set1_ps(HIGH_PASS_ALPHA), _mm_add_ps(_mm_loadu_ps(job.filter_state + j), delta));
+                        }
+                        _mm_storeu_ps(job.filter_prev_input + j, input);
+                        _mm_storeu_ps(job.filter_state + j, y);
+                        filtered = y;
+                    } else if constexpr (Filter == FilterType::MOVING_AVERAGE) {
+                        __m128 sum = _mm_add_ps(_mm_loadu_ps(job.filter_sum + j),
+                                                _mm_sub_ps(input, _mm_loadu_ps(window_row + j)));
+                        _mm_storeu_ps(window_row + j, input);
+                        _mm_storeu_ps(job.filter_sum + j, sum);
+                        filtered = _mm_mul_ps(sum, _mm_set1_ps(inv_filled));
+                    }
+
+                    __m128 value = _mm_mul_ps(_mm_add_ps(filtered, _mm_loadu_ps(job.calibration_offset + j)),
+                                              _mm_loadu_ps(job.calibration_scale + j));
+                    _mm_storeu_ps(values + j, value);
+
+                    __m128 outside = _mm_or_ps(_mm_cmplt_ps(value, _mm_loadu_ps(job.low_threshold + j)),
+                                               _mm_cmpgt_ps(value, _mm_loadu_ps(job.high_threshold + j)));
+
+                    _mm_storeu_ps(job.stat_min + j, _mm_min_ps(_mm_loadu_ps(job.stat_min + j), value));
+                    _mm_storeu_ps(job.stat_max + j, _mm_max_ps(_mm_loadu_ps(job.stat_max + j), value));
+                    __m128 mean = _mm_loadu_ps(job.stat_mean + j);
+                    __m128 delta = _mm_sub_ps(value, mean);
+                    mean = _mm_add_ps(mean, _mm_mul_ps(delta, _mm_set1_ps(inv_count)));
+                    _mm_storeu_ps(job.stat_mean + j, mean);
+                    _mm_storeu_ps(job.stat_m2 + j, _mm_add_ps(_mm_loadu_ps(job.stat_m2 + j),
+                                                              _mm_mul_ps(delta, _mm_sub_ps(value, mean))));
+                    group_codes[group] = code;
+                    mask |= static_cast<uint32_t>(_mm_movemask_ps(outside)) << (group * 4);
+                }
+
+                // Unsigned 16-bit pack via the signed pack of biased values
+                __m128i packed = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(group_codes[0], bias32),
+                                                               _mm_sub_epi32(group_codes[1], bias32)), bias16);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(codes + i), packed);
+
+                flags[i / 8] = static_cast<uint8_t>(mask);
+                uint32_t rising = has_previous ? (mask & ~static_cast<uint32_t>(previous_flags[i / 8])) : mask;
+                crossings += static_cast<size_t>(__builtin_popcount(rising));
+            }
+#else
+            for (size_t i = block; i < block_end; i += 8) {
+                uint32_t mask = 0;
+                for (size_t j = i; j < i + 8; ++j) {
+                    float noise;
+                    if (job.uniform) {
+                        job.rng[j] = xorshift32(job.rng[j]);
+                        noise = static_cast<float>(job.rng[j] >> 8) * (1.0f / 16777216.0f);
+                    } else {
+                        uint32_t first = xorshift32(job.rng[j]);
+                        job.rng[j] = xorshift32(first);
+                        uint32_t sum = (first & 0xFFFF) + (first >> 16) + (job.rng[j] & 0xFFFF) + (job.rng[j] >> 16);
+                        noise = static_cast<float>(sum) * (1.0f / 65536.0f) - 2.0f;
+                    }
+
+                    float x = std::clamp(job.source_offset + job.source_spread * noise, job.source_min, job.source_max);
+                    float level = std::clamp((x - job.adc_min) * job.adc_inv_lsb, 0.0f, job.adc_max_code);
+                    uint16_t code = static_cast<uint16_t>(std::nearbyint(level));
+                    float input = job.adc_min + static_cast<float>(code) * job.adc_lsb;
+
+                    float filtered = input;
+                    if constexpr (Filter == FilterType::LOW_PASS) {
+                        float& s = job.filter_state[j];
+                        s = prime ? input : s + (input - s) * LOW_PASS_ALPHA;
+                        filtered = s;
+                    } else if constexpr (Filter == FilterType::HIGH_PASS) {
+                        float y = prime ? 0.0f : HIGH_PASS_ALPHA * (job.filter_state[j] + input - job.filter_prev_input[j]);
+                        job.filter_prev_input[j] = input;
+                        job.filter_state[j] = y;
+                        filtered = y;
+                    } else if constexpr (Filter == FilterType::MOVING_AVERAGE) {
+                        job.filter_sum[j] += input - window_row[j];
+                        window_row[j] = input;
+                        filtered = job.filter_sum[j] * inv_filled;
+                    }
+
+                    float value = (filtered + job.calibration_offset[j]) * job.calibration_scale[j];
+                    codes[j] = code;
+                    values[j] = value;
+                    if (value < job.low_threshold[j] || value > job.high_threshold[j]) {
+                        mask |= 1u << (j - i);
+                    }
+
+                    job.stat_min[j] = std::min(job.stat_min[j], value);
+                    job.stat_max[j] = std::max(job.stat_max[j], value);
+                    float delta = value - job.stat_mean[j];
+                    job.stat_mean[j] += delta * inv_count;
+                    job.stat_m2[j] += delta * (value - job.stat_mean[j]);
+                }
+
+                flags[i / 8] = static_cast<uint8_t>(mask);
+                uint32_t rising = has_previous ? (mask & ~static_cast<uint32_t>(previous_flags[i / 8])) : mask;
+                crossings += static_cast<size_t>(__builtin_popcount(rising));
+            }
+#endif
+        }
+    }
+    return crossings;
+}
+
+void SensorArray::rebuildModelLocked() {
+    float maximum;
+    Sensor::getADCRange(sensor_type, adc_min, maximum);
+    adc_max_code = static_cast<uint16_t>((1u << config.adc_resolution) - 1);
+    adc_lsb = (maximum - adc_min) / static_cast<float>(adc_max_code);
+
+    // Same distributions as Sensor::generateRawValue(); normal sigma scaled for Irwin-Hall
+    const float sqrt3 = std::sqrt(3.0f);
+    float mean = 0.0f, sigma = 0.0f;
+    source_uniform = false;
+    switch (sensor_type) {
+        case SensorType::TEMPERATURE: mean = 22.0f; sigma = 5.0f; source_min = -40.0f; source_max = 85.0f; break;
+        case SensorType::PRESSURE: mean = 101.3f; sigma = 2.0f; source_min = 0.0f; source_max = 1200.0f; break;
+        case SensorType::HUMIDITY: mean = 45.0f; sigma = 10.0f; source_min = 0.0f; source_max = 100.0f; break;
+        case SensorType::ACCELEROMETER: mean = 0.0f; sigma = 0.1f; source_min = -2.0f; source_max = 2.0f; break;
+        case SensorType::LIGHT:
+            source_uniform = true;
+            source_offset = 100.0f;
+            source_spread = 900.0f;
+            source_min = 100.0f;
+            source_max = 1000.0f;
+            return;
+        case SensorType::VOLTAGE: mean = 3.3f; sigma = 0.05f; source_min = 0.0f; source_max = 3.6f; break;
+    }
+    source_offset = mean;
+    source_spread = sigma * sqrt3;
+}
+
+void SensorArray::resetFilterLocked() {
+    filter_state.assign(padded_count, 0.0f);
+    filter_prev_input.assign(padded_count, 0.0f);
+    filter_sum.assign(padded_count, 0.0f);
+    filter_window.assign(filter_window_size * padded_count, 0.0f);
+    filter_position = 0;
+    filter_ticks = 0;
+}
+
+void SensorArray::resetStatisticsLocked() {
+    stat_min.assign(padded_count, std::numeric_limits<float>::max());
+    stat_max.assign(padded_count, std::numeric_limits<float>::lowest());
+    stat_mean.assign(padded_count, 0.0f);
+    stat_m2.assign(padded_count, 0.0f);
+    stat_count = 0;
+}
+
+void SensorArray::resetHistoryLocked() {
+    history_head = 0;
+    history_stored = 0;
+}
+
+std::string SensorArray::formatDeviceData() const {
+    std::stringstream ss;
+    ss << "type:" << static_cast<int>(sensor_type) << ",";
+    ss << "sensors:" << sensor_count << ",";
+    ss << "sampling:" << (sampling_enabled.load() ? 1 : 0) << ",";
+    ss << "rate:" << sampling_rate_hz.load() << ",";
+    ss << "ticks:" << tick_count << ",";
+    ss << "crossings:" << threshold_crossings;
+    return ss.str();
+}
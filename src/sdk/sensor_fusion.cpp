@@ -0,0 +1,531 @@
+#include "sdk/sensor_fusion.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+SensorFusion::SensorFusion(const std::string& name, size_t capacity)
+    : Peripheral(name),
+      running(false),
+      history_capacity(1),
+      reference_input(0),
+      reference_cursor(0),
+      interpolation(Interpolation::LINEAR),
+      max_skew_ns(50000000), // 50 ms
+      last_frame_ns(0),
+      latest_frame{},
+      has_frame(false),
+      stats{} {
+
+    while (history_capacity < std::max<size_t>(capacity, 16)) {
+        history_capacity <<= 1;
+    }
+    inputs.reserve(MAX_INPUTS);
+    filters.reserve(MAX_OUTPUTS);
+    frame_stream = std::make_unique<FrameStreamType>(1024);
+}
+
+SensorFusion::~SensorFusion() {
+    if (initialized) {
+        cleanup();
+    }
+}
+
+bool SensorFusion::initialize() {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+
+    if (!writeToDeviceFile("inputs:" + std::to_string(inputs.size()) + ",frames:0")) {
+        std::cerr << "Error: Failed to initialize SensorFusion device file" << std::endl;
+        return false;
+    }
+
+    initialized = true;
+    std::cout << "SensorFusion '" << device_name << "' initialized successfully" << std::endl;
+    return true;
+}
+
+bool SensorFusion::cleanup() {
+    // Unsubscribing waits for in-flight input callbacks, so run it unlocked
+    stop();
+
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    writeToDeviceFile("inputs:" + std::to_string(inputs.size()) + ",frames:" +
+                      std::to_string(stats.frames_fused));
+    initialized = false;
+    std::cout << "SensorFusion '" << device_name << "' cleaned up" << std::endl;
+    return true;
+}
+
+std::string SensorFusion::getStatus() const {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    std::stringstream ss;
+
+    ss << "SensorFusion '" << device_name << "' - ";
+    ss << "Running: " << (running.load() ? "ON" : "OFF") << ", ";
+    ss << "Inputs: " << inputs.size() << ", ";
+    ss << "Outputs: " << filters.size() << ", ";
+    ss << "Interpolation: " << interpolationToString(interpolation) << ", ";
+    ss << "Frames: " << stats.frames_fused;
+    if (stats.extrapolated > 0 || stats.overruns > 0) {
+        ss << ", Extrapolated: " << stats.extrapolated << ", Overruns: " << stats.overruns;
+    }
+    return ss.str();
+}
+
+int SensorFusion::addInput(Sensor& sensor) {
+    int index = addInput(sensor.getName());
+    if (index >= 0) {
+        std::lock_guard<std::mutex> lock(fusion_mutex);
+        inputs[index].sensor = &sensor;
+    }
+    return index;
+}
+
+int SensorFusion::addInput(const std::string& label) {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    if (running.load()) {
+        std::cerr << "Error: Cannot add fusion inputs while running" << std::endl;
+        return -1;
+    }
+    if (inputs.size() >= MAX_INPUTS) {
+        std::cerr << "Error: SensorFusion supports at most " << MAX_INPUTS << " inputs" << std::endl;
+        return -1;
+    }
+
+    Input input;
+    input.label = label;
+    input.sensor = nullptr;
+    input.subscription = Sensor::SampleStreamType::INVALID_SUBSCRIBER;
+    input.history.resize(history_capacity);
+    input.mask = history_capacity - 1;
+    input.written = 0;
+    input.seek = 0;
+    inputs.push_back(std::move(input));
+    return static_cast<int>(inputs.size() - 1);
+}
+
+bool SensorFusion::pushSample(size_t input, std::chrono::steady_clock::time_point timestamp, float value) {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    if (input >= inputs.size()) {
+        std::cerr << "Error: Invalid fusion input " << input << std::endl;
+        return false;
+    }
+
+    storeLocked(input, toNanoseconds(timestamp), value);
+    fuseLocked();
+    return true;
+}
+
+bool SensorFusion::setReferenceInput(size_t input) {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    if (running.load() || input >= inputs.size()) {
+        std::cerr << "Error: Invalid reference input (or fusion running)" << std::endl;
+        return false;
+    }
+    reference_input = input;
+    reference_cursor = inputs[input].written;
+    return true;
+}
+
+bool SensorFusion::setInterpolation(Interpolation mode) {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    interpolation = mode;
+    return true;
+}
+
+bool SensorFusion::setMaxSkew(std::chrono::microseconds skew) {
+    if (skew.count() < 0) {
+        std::cerr << "Error: Max skew must be non-negative" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    max_skew_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(skew).count();
+    return true;
+}
+
+int SensorFusion::addComplementaryFilter(size_t rate_input, size_t absolute_input, float alpha,
+                                         bool integrate_rate) {
+    if (alpha < 0.0f || alpha > 1.0f) {
+        std::cerr << "Error: Complementary filter alpha must be between 0-1" << std::endl;
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    if (rate_input >= inputs.size() || absolute_input >= inputs.size()) {
+        std::cerr << "Error: Invalid complementary filter inputs" << std::endl;
+        return -1;
+    }
+
+    Filter filter{};
+    filter.kind = FilterKind::COMPLEMENTARY;
+    filter.rate_input = rate_input;
+    filter.absolute_input = absolute_input;
+    filter.alpha = alpha;
+    filter.integrate_rate = integrate_rate;
+    return addFilterLocked(filter);
+}
+
+int SensorFusion::addKalmanFilter(const std::vector<size_t>& measured_inputs, float process_noise,
+                                  const std::vector<float>& measurement_noise) {
+    if (measured_inputs.empty() || measured_inputs.size() != measurement_noise.size() || process_noise < 0.0f) {
+        std::cerr << "Error: Kalman filter needs one positive noise variance per measured input" << std::endl;
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    Filter filter{};
+    filter.kind = FilterKind::KALMAN;
+    filter.process_noise = process_noise;
+    for (size_t i = 0; i < measured_inputs.size(); ++i) {
+        if (measured_inputs[i] >= inputs.size() || measurement_noise[i] <= 0.0f) {
+            std::cerr << "Error: Invalid Kalman measurement input " << measured_inputs[i] << std::endl;
+            return -1;
+        }
+        filter.measurement_mask |= 1u << measured_inputs[i];
+        filter.measurement_noise[measured_inputs[i]] = measurement_noise[i];
+    }
+    return addFilterLocked(filter);
+}
+
+int SensorFusion::addFilterLocked(const Filter& filter) {
+    if (running.load()) {
+        std::cerr << "Error: Cannot add fusion filters while running" << std::endl;
+        return -1;
+    }
+    if (filters.size() >= MAX_OUTPUTS) {
+        std::cerr << "Error: SensorFusion supports at most " << MAX_OUTPUTS << " outputs" << std::endl;
+        return -1;
+    }
+
+    filters.push_back(filter);
+    output_streams.push_back(std::make_unique<Sensor::SampleStreamType>(1024));
+    return static_cast<int>(filters.size() - 1);
+}
+
+bool SensorFusion::start() {
+    std::vector<std::pair<size_t, Sensor*>> sources;
+    {
+        std::lock_guard<std::mutex> lock(fusion_mutex);
+        if (!initialized) {
+            std::cerr << "Error: SensorFusion not initialized" << std::endl;
+            return false;
+        }
+        if (running.load()) {
+            return true;
+        }
+        if (inputs.empty()) {
+            std::cerr << "Error: SensorFusion has no inputs" << std::endl;
+            return false;
+        }
+
+        for (auto& filter : filters) {
+            filter.primed = false;
+        }
+        reference_cursor = inputs[reference_input].written;
+        running = true;
+
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (inputs[i].sensor) {
+                sources.emplace_back(i, inputs[i].sensor);
+            }
+        }
+    }
+
+    // Subscribe unlocked: the callbacks take fusion_mutex on the sensors' delivery threads
+    for (const auto& source : sources) {
+        size_t index = source.first;
+        Sensor::SubscriberId id = source.second->subscribe(
+            64, std::chrono::microseconds(2000),
+            [this, index](const RingSpan<const Sensor::SensorData>& batch, uint64_t) {
+                std::lock_guard<std::mutex> lock(fusion_mutex);
+                batch.forEachSegment([this, index](Span<const Sensor::SensorData> segment) {
+                    for (const auto& sample : segment) {
+                        storeLocked(index, toNanoseconds(sample.timestamp), sample.calibrated_value);
+                    }
+                });
+                fuseLocked();
+            });
+
+        std::lock_guard<std::mutex> lock(fusion_mutex);
+        inputs[index].subscription = id;
+    }
+
+    std::cout << "SensorFusion '" << device_name << "' started with " << sources.size()
+              << " sensor inputs" << std::endl;
+    return true;
+}
+
+bool SensorFusion::stop() {
+    std::vector<std::pair<Sensor*, Sensor::SubscriberId>> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(fusion_mutex);
+        if (!running.load()) {
+            return true;
+        }
+        running = false;
+        for (auto& input : inputs) {
+            if (input.sensor && input.subscription != Sensor::SampleStreamType::INVALID_SUBSCRIBER) {
+                subscriptions.emplace_back(input.sensor, input.subscription);
+                input.subscription = Sensor::SampleStreamType::INVALID_SUBSCRIBER;
+            }
+        }
+    }
+
+    for (const auto& subscription : subscriptions) {
+        subscription.first->unsubscribe(subscription.second);
+    }
+
+    std::cout << "SensorFusion '" << device_name << "' stopped" << std::endl;
+    return true;
+}
+
+SensorFusion::SubscriberId SensorFusion::subscribe(size_t batch_size, std::chrono::microseconds max_latency,
+                                                   FrameBatchCallback callback) {
+    return frame_stream->subscribe(batch_size, max_latency, std::move(callback));
+}
+
+Sensor::SubscriberId SensorFusion::subscribeOutput(size_t output, size_t batch_size,
+                                                   std::chrono::microseconds max_latency,
+                                                   Sensor::SampleBatchCallback callback) {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    if (output >= output_streams.size()) {
+        std::cerr << "Error: Invalid fusion output " << output << std::endl;
+        return Sensor::SampleStreamType::INVALID_SUBSCRIBER;
+    }
+    return output_streams[output]->subscribe(batch_size, max_latency, std::move(callback));
+}
+
+bool SensorFusion::unsubscribe(SubscriberId id) {
+    return frame_stream->unsubscribe(id);
+}
+
+bool SensorFusion::unsubscribeOutput(size_t output, Sensor::SubscriberId id) {
+    Sensor::SampleStreamType* stream;
+    {
+        std::lock_guard<std::mutex> lock(fusion_mutex);
+        if (output >= output_streams.size()) {
+            return false;
+        }
+        stream = output_streams[output].get();
+    }
+    return stream->unsubscribe(id);
+}
+
+bool SensorFusion::readLatest(FusedFrame& frame) const {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    if (!has_frame) {
+        return false;
+    }
+    frame = latest_frame;
+    return true;
+}
+
+size_t SensorFusion::getInputCount() const {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    return inputs.size();
+}
+
+size_t SensorFusion::getOutputCount() const {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    return filters.size();
+}
+
+SensorFusion::Statistics SensorFusion::getStatistics() const {
+    std::lock_guard<std::mutex> lock(fusion_mutex);
+    return stats;
+}
+
+void SensorFusion::storeLocked(size_t index, int64_t timestamp_ns, float value) {
+    Input& input = inputs[index];
+
+    // Drop samples that go back in time (e.g. a replay source restarting)
+    if (input.written > 0 && timestamp_ns < input.history[(input.written - 1) & input.mask].timestamp_ns) {
+        return;
+    }
+
+    input.history[input.written & input.mask] = TimedValue{timestamp_ns, value};
+    input.written++;
+    stats.samples_received++;
+}
+
+void SensorFusion::fuseLocked() {
+    if (inputs.empty()) {
+        return;
+    }
+
+    Input& reference = inputs[reference_input];
+    if (reference.written == 0) {
+        return;
+    }
+
+    // Reference samples overwritten before they were fused are lost
+    uint64_t oldest = reference.written > history_capacity ? reference.written - history_capacity : 0;
+    if (reference_cursor < oldest) {
+        stats.overruns += oldest - reference_cursor;
+        reference_cursor = oldest;
+    }
+
+    int64_t reference_newest = reference.history[(reference.written - 1) & reference.mask].timestamp_ns;
+
+    while (reference_cursor < reference.written) {
+        const TimedValue& ref = reference.history[reference_cursor & reference.mask];
+        int64_t t = ref.timestamp_ns;
+
+        // Wait until every input has data past t, unless it is more than max_skew late
+        bool ready = true;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (i == reference_input) continue;
+            const Input& input = inputs[i];
+            bool covered = input.written > 0 &&
+                           input.history[(input.written - 1) & input.mask].timestamp_ns >= t;
+            if (!covered && reference_newest - t <= max_skew_ns) {
+                ready = false;
+                break;
+            }
+        }
+        if (!ready) {
+            break;
+        }
+
+        FusedFrame frame{};
+        frame.timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(t));
+        frame.inputs[reference_input] = ref.value;
+        frame.valid_mask = 1u << reference_input;
+
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (i == reference_input) continue;
+            if (alignLocked(inputs[i], t, reference_newest, frame.inputs[i])) {
+                frame.valid_mask |= 1u << i;
+            }
+        }
+
+        float dt = (last_frame_ns > 0 && t > last_frame_ns) ? static_cast<float>(t - last_frame_ns) * 1e-9f : 0.0f;
+        last_frame_ns = t;
+        runFiltersLocked(frame, dt);
+
+        latest_frame = frame;
+        has_frame = true;
+        stats.frames_fused++;
+        reference_cursor++;
+
+        frame_stream->publish(frame);
+        for (size_t o = 0; o < filters.size(); ++o) {
+            Sensor::SensorData derived;
+            derived.timestamp = frame.timestamp;
+            derived.raw_value = frame.outputs[o];
+            derived.calibrated_value = frame.outputs[o];
+            derived.threshold_exceeded = false;
+            derived.adc_code = 0; // Derived, not converted
+            output_streams[o]->publish(derived);
+        }
+    }
+}
+
+bool SensorFusion::alignLocked(Input& input, int64_t t, int64_t reference_newest, float& value) {
+    if (input.written == 0) {
+        value = 0.0f;
+        return false;
+    }
+
+    uint64_t oldest = input.written > history_capacity ? input.written - history_capacity : 0;
+    if (input.seek < oldest) {
+        input.seek = oldest;
+    }
+
+    // seek only moves forward: amortized O(1) per reference sample
+    while (input.seek + 1 < input.written &&
+           input.history[(input.seek + 1) & input.mask].timestamp_ns <= t) {
+        input.seek++;
+    }
+
+    const TimedValue& before = input.history[input.seek & input.mask];
+    bool has_after = input.seek + 1 < input.written;
+
+    if (before.timestamp_ns > t) {
+        // Reference is older than anything retained for this input
+        value = before.value;
+        return true;
+    }
+
+    if (!has_after) {
+        // Newest sample is at or before t: hold it
+        if (before.timestamp_ns < t && reference_newest - t > max_skew_ns) {
+            stats.extrapolated++;
+        }
+        value = before.value;
+        return true;
+    }
+
+    const TimedValue& after = input.history[(input.seek + 1) & input.mask];
+    switch (interpolation) {
+        case Interpolation::ZERO_ORDER_HOLD:
+            value = before.value;
+            break;
+        case Interpolation::NEAREST:
+            value = (t - before.timestamp_ns <= after.timestamp_ns - t) ? before.value : after.value;
+            break;
+        case Interpolation::LINEAR: {
+            int64_t span = after.timestamp_ns - before.timestamp_ns;
+            float fraction = span > 0 ? static_cast<float>(t - before.timestamp_ns) / static_cast<float>(span) : 0.0f;
+            value = before.value + (after.value - before.value) * fraction;
+            break;
+        }
+    }
+    return true;
+}
+
+void SensorFusion::runFiltersLocked(FusedFrame& frame, float dt) {
+    for (size_t o = 0; o < filters.size(); ++o) {
+        Filter& filter = filters[o];
+
+        if (filter.kind == FilterKind::COMPLEMENTARY) {
+            float fast = frame.inputs[filter.rate_input];
+            float absolute = frame.inputs[filter.absolute_input];
+            if (!filter.primed) {
+                filter.state = absolute;
+                filter.previous_fast = fast;
+                filter.primed = true;
+            } else {
+                float predicted = filter.integrate_rate ? filter.state + fast * dt
+                                                        : filter.state + (fast - filter.previous_fast);
+                filter.state = filter.alpha * predicted + (1.0f - filter.alpha) * absolute;
+                filter.previous_fast = fast;
+            }
+        } else {
+            // Predict (random walk), then one sequential update per available measurement
+            if (filter.primed) {
+                filter.covariance += filter.process_noise * dt;
+            }
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                if (!(filter.measurement_mask & frame.valid_mask & (1u << i))) continue;
+                float z = frame.inputs[i];
+                float r = filter.measurement_noise[i];
+                if (!filter.primed) {
+                    filter.state = z;
+                    filter.covariance = r;
+                    filter.primed = true;
+                    continue;
+                }
+                float gain = filter.covariance / (filter.covariance + r);
+                filter.state += gain * (z - filter.state);
+                filter.covariance *= (1.0f - gain);
+            }
+        }
+
+        frame.outputs[o] = filter.state;
+    }
+}
+
+int64_t SensorFusion::toNanoseconds(std::chrono::steady_clock::time_point tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+std::string SensorFusion::interpolationToString(Interpolation mode) {
+    switch (mode) {
+        case Interpolation::ZERO_ORDER_HOLD: return "Zero-Order Hold";
+        case Interpolation::LINEAR: return "Linear";
+        case Interpolation::NEAREST: return "Nearest";
+        default: return "Unknown";
+    }
+}
@@ -0,0 +1,344 @@
+#include "sdk/spectral_analyzer.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+}
+
+SpectralAnalyzer::SpectralAnalyzer(const Config& cfg)
+    : config(cfg),
+      fft(cfg.fft_size),
+      history_pos(0),
+      history_filled(0),
+      since_last_block(0),
+      power_scale(1.0f),
+      band_scale(1.0f),
+      sample_rate(0.0f),
+      latest{},
+      has_features(false),
+      tracking(false),
+      stats{},
+      sensor(nullptr),
+      subscription(Sensor::SampleStreamType::INVALID_SUBSCRIBER) {
+
+    size_t n = fft.size(); // Rounded up if cfg.fft_size was not a power of two
+    config.fft_size = n;
+    if (config.hop_size == 0 || config.hop_size > n) {
+        std::cerr << "Warning: Spectral hop size must be between 1-" << n << ", using " << n / 2 << std::endl;
+        config.hop_size = n / 2;
+    }
+    if (config.bands.size() > MAX_BANDS) {
+        std::cerr << "Warning: Only the first " << MAX_BANDS << " spectral bands are used" << std::endl;
+        config.bands.resize(MAX_BANDS);
+    }
+    config.peak_smoothing = std::clamp(config.peak_smoothing, 0.0f, 1.0f);
+
+    history.assign(n, 0.0f);
+    work_re.assign(n, 0.0f);
+    work_im.assign(n, 0.0f);
+    power_spectrum.assign(n / 2 + 1, 0.0f);
+
+    window_coefficients.resize(n);
+    double window_sum = 0.0;
+    double window_sum_squares = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double phase = 2.0 * PI * static_cast<double>(i) / static_cast<double>(n);
+        double w = 1.0;
+        switch (config.window) {
+            case Window::HANN: w = 0.5 - 0.5 * std::cos(phase); break;
+            case Window::HAMMING: w = 0.54 - 0.46 * std::cos(phase); break;
+            case Window::RECTANGULAR: break;
+        }
+        window_coefficients[i] = static_cast<float>(w);
+        window_sum += w;
+        window_sum_squares += w * w;
+    }
+
+    // One-sided amplitude-squared scaling: a sine of amplitude A shows up as A^2 / 2 in its bin
+    power_scale = static_cast<float>(2.0 / (window_sum * window_sum));
+    // Summing bins over-counts by the window's equivalent noise bandwidth
+    band_scale = static_cast<float>((window_sum * window_sum) / (static_cast<double>(n) * window_sum_squares));
+
+    configureRateLocked(config.sample_rate_hz);
+}
+
+SpectralAnalyzer::~SpectralAnalyzer() {
+    detach();
+}
+
+SpectralAnalyzer::Config SpectralAnalyzer::defaultConfig() {
+    Config cfg;
+    cfg.fft_size = 1024;
+    cfg.hop_size = 512;
+    cfg.sample_rate_hz = 0.0f;
+    cfg.window = Window::HANN;
+    cfg.peak_smoothing = 0.2f;
+    return cfg;
+}
+
+bool SpectralAnalyzer::attach(Sensor& source) {
+    {
+        std::lock_guard<std::mutex> lock(analyzer_mutex);
+        if (sensor) {
+            std::cerr << "Error: Spectral analyzer already attached to '" << sensor->getName() << "'" << std::endl;
+            return false;
+        }
+        configureRateLocked(config.sample_rate_hz > 0.0f ? config.sample_rate_hz
+                                                         : static_cast<float>(source.getSamplingRate()));
+        sensor = &source;
+    }
+
+    // One batch per hop; the latency bound only matters for slow sensors
+    Sensor::SubscriberId id = source.subscribe(
+        config.hop_size, std::chrono::microseconds(100000),
+        [this](const RingSpan<const Sensor::SensorData>& batch, uint64_t) {
+            std::vector<Features> ready;
+            FeatureCallback cb;
+            {
+                std::lock_guard<std::mutex> lock(analyzer_mutex);
+                batch.forEachSegment([&](Span<const Sensor::SensorData> segment) {
+                    for (const auto& sample : segment) {
+                        if (pushLocked(sample.calibrated_value, sample.timestamp) && callback) {
+                            ready.push_back(latest);
+                        }
+                    }
+                });
+                cb = callback;
+            }
+            for (const auto& features : ready) {
+                cb(features);
+            }
+        });
+
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    if (id == Sensor::SampleStreamType::INVALID_SUBSCRIBER) {
+        sensor = nullptr;
+        return false;
+    }
+    subscription = id;
+    return true;
+}
+
+bool SpectralAnalyzer::detach() {
+    Sensor* source;
+    Sensor::SubscriberId id;
+    {
+        std::lock_guard<std::mutex> lock(analyzer_mutex);
+        if (!sensor) {
+            return false;
+        }
+        source = sensor;
+        id = subscription;
+        sensor = nullptr;
+        subscription = Sensor::SampleStreamType::INVALID_SUBSCRIBER;
+    }
+
+    // Unsubscribe unlocked: it waits for an in-flight batch that takes analyzer_mutex
+    source->unsubscribe(id);
+    return true;
+}
+
+bool SpectralAnalyzer::isAttached() const {
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    return sensor != nullptr;
+}
+
+void SpectralAnalyzer::setCallback(FeatureCallback cb) {
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    callback = std::move(cb);
+}
+
+size_t SpectralAnalyzer::process(const float* samples, size_t count, float sample_rate_hz) {
+    if (!samples || sample_rate_hz <= 0.0f) {
+        std::cerr << "Error: Invalid spectral input" << std::endl;
+        return 0;
+    }
+
+    std::vector<Features> ready;
+    FeatureCallback cb;
+    size_t blocks = 0;
+    {
+        std::lock_guard<std::mutex> lock(analyzer_mutex);
+        if (sample_rate_hz != sample_rate) {
+            configureRateLocked(sample_rate_hz);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            if (pushLocked(samples[i], now)) {
+                blocks++;
+                if (callback) {
+                    ready.push_back(latest);
+                }
+            }
+        }
+        cb = callback;
+    }
+
+    for (const auto& features : ready) {
+        cb(features);
+    }
+    return blocks;
+}
+
+bool SpectralAnalyzer::readLatest(Features& features) const {
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    if (!has_features) {
+        return false;
+    }
+    features = latest;
+    return true;
+}
+
+bool SpectralAnalyzer::getSpectrum(std::vector<float>& power) const {
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    if (!has_features) {
+        return false;
+    }
+    power = power_spectrum;
+    return true;
+}
+
+float SpectralAnalyzer::binFrequency(size_t bin) const {
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    return static_cast<float>(bin) * sample_rate / static_cast<float>(config.fft_size);
+}
+
+SpectralAnalyzer::Statistics SpectralAnalyzer::getStatistics() const {
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    return stats;
+}
+
+void SpectralAnalyzer::reset() {
+    std::lock_guard<std::mutex> lock(analyzer_mutex);
+    std::fill(history.begin(), history.end(), 0.0f);
+    history_pos = 0;
+    history_filled = 0;
+    since_last_block = 0;
+    has_features = false;
+    tracking = false;
+    stats = Statistics{};
+}
+
+void SpectralAnalyzer::configureRateLocked(float rate_hz) {
+    sample_rate = rate_hz;
+    band_bins.clear();
+    if (rate_hz <= 0.0f) {
+        return;
+    }
+
+    // Precompute the bin range of every band: [first, last)
+    float bin_width = rate_hz / static_cast<float>(config.fft_size);
+    size_t max_bin = config.fft_size / 2 + 1;
+    for (const auto& band : config.bands) {
+        size_t first = static_cast<size_t>(std::ceil(std::max(band.low_hz, 0.0f) / bin_width));
+        size_t last = static_cast<size_t>(std::ceil(std::max(band.high_hz, 0.0f) / bin_width));
+        band_bins.emplace_back(std::min(first, max_bin), std::min(last, max_bin));
+    }
+}
+
+bool SpectralAnalyzer::pushLocked(float value, std::chrono::steady_clock::time_point timestamp) {
+    history[history_pos] = value;
+    history_pos = (history_pos + 1) % history.size();
+    history_filled = std::min(history_filled + 1, history.size());
+    since_last_block++;
+    stats.samples_processed++;
+
+    if (history_filled < history.size() || since_last_block < config.hop_size) {
+        return false;
+    }
+
+    since_last_block = 0;
+    analyseLocked(timestamp);
+    return true;
+}
+
+void SpectralAnalyzer::analyseLocked(std::chrono::steady_clock::time_point timestamp) {
+    auto start = std::chrono::steady_clock::now();
+    const size_t n = config.fft_size;
+
+    // Unwrap the history (oldest sample at history_pos) while applying the window
+    double sum_squares = 0.0;
+    size_t head = n - history_pos;
+    for (size_t i = 0; i < head; ++i) {
+        float x = history[history_pos + i];
+        sum_squares += static_cast<double>(x) * x;
+        work_re[i] = x * window_coefficients[i];
+    }
+    for (size_t i = 0; i < history_pos; ++i) {
+        float x = history[i];
+        sum_squares += static_cast<double>(x) * x;
+        work_re[head + i] = x * window_coefficients[head + i];
+    }
+    std::fill(work_im.begin(), work_im.end(), 0.0f);
+
+    fft.forward(work_re.data(), work_im.data());
+
+    size_t bins = n / 2 + 1;
+    for (size_t k = 0; k < bins; ++k) {
+        power_spectrum[k] = (work_re[k] * work_re[k] + work_im[k] * work_im[k]) * power_scale;
+    }
+    power_spectrum[0] *= 0.5f;     // DC and Nyquist are not mirrored
+    power_spectrum[n / 2] *= 0.5f;
+
+    Features features{};
+    features.timestamp = timestamp;
+    features.block = stats.blocks_analysed;
+    features.rms = static_cast<float>(std::sqrt(sum_squares / static_cast<double>(n)));
+
+    // Peak search skips DC; parabolic interpolation on log power between neighbours
+    size_t peak = 1;
+    for (size_t k = 2; k < n / 2; ++k) {
+        if (power_spectrum[k] > power_spectrum[peak]) {
+            peak = k;
+        }
+    }
+    float delta = 0.0f;
+    if (peak + 1 < bins) {
+        const float floor = 1e-30f;
+        float a = std::log(power_spectrum[peak - 1] + floor);
+        float b = std::log(power_spectrum[peak] + floor);
+        float c = std::log(power_spectrum[peak + 1] + floor);
+        float denominator = a - 2.0f * b + c;
+        if (denominator < 0.0f) {
+            delta = std::clamp(0.5f * (a - c) / denominator, -0.5f, 0.5f);
+        }
+    }
+    float bin_width = sample_rate / static_cast<float>(n);
+    features.peak_frequency_hz = (static_cast<float>(peak) + delta) * bin_width;
+    features.peak_amplitude = std::sqrt(2.0f * power_spectrum[peak]);
+
+    if (!tracking) {
+        features.tracked_frequency_hz = features.peak_frequency_hz;
+        tracking = true;
+    } else {
+        features.tracked_frequency_hz = latest.tracked_frequency_hz +
+            config.peak_smoothing * (features.peak_frequency_hz - latest.tracked_frequency_hz);
+    }
+
+    features.band_count = band_bins.size();
+    for (size_t b = 0; b < band_bins.size(); ++b) {
+        float power = 0.0f;
+        for (size_t k = band_bins[b].first; k < band_bins[b].second; ++k) {
+            power += power_spectrum[k];
+        }
+        features.band_power[b] = power * band_scale;
+    }
+
+    latest = features;
+    has_features = true;
+    stats.blocks_analysed++;
+    stats.last_block_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    stats.max_block_us = std::max(stats.max_block_us, stats.last_block_us);
+}
+
+std::string SpectralAnalyzer::windowToString(Window window) {
+    switch (window) {
+        case Window::RECTANGULAR: return "Rectangular";
+        case Window::HANN: return "Hann";
+        case Window::HAMMING: return "Hamming";
+        default: return "Unknown";
+    }
+}
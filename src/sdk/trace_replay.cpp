@@ -0,0 +1,376 @@
+#include "sdk/trace_replay.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr char TRACE_MAGIC[4] = {'E', 'S', 'T', 'R'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+inline const char* nextLine(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) + 1 : end;
+}
+
+} // namespace
+
+TraceReplaySource::TraceReplaySource(const std::string& path, Format fmt)
+    : file_path(path),
+      format(fmt),
+      fd(-1),
+      mapping(nullptr),
+      mapping_size(0),
+      records(nullptr),
+      record_count(0),
+      csv_begin(nullptr),
+      csv_cursor(nullptr),
+      csv_end(nullptr),
+      binary_cursor(0),
+      rate_scale(1.0),
+      looping(false),
+      first_timestamp(0),
+      loop_period_ns(0),
+      loop_offset_ns(0),
+      loops_completed(0),
+      samples_replayed(0),
+      anchor_timestamp(0),
+      playback_anchored(false) {
+}
+
+TraceReplaySource::~TraceReplaySource() {
+    close();
+}
+
+bool TraceReplaySource::open() {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    if (mapping) {
+        return true;
+    }
+
+    fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open trace " << file_path << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::cerr << "Error: Trace " << file_path << " is empty or unreadable" << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    mapping_size = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Error: Cannot map trace " << file_path << " - " << strerror(errno) << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    mapping = static_cast<const uint8_t*>(addr);
+    madvise(addr, mapping_size, MADV_SEQUENTIAL);
+
+    if (format == Format::AUTO) {
+        format = detectFormat();
+    }
+
+    bool prepared = (format == Format::BINARY) ? prepareBinary() : prepareCsv();
+    if (!prepared) {
+        munmap(const_cast<uint8_t*>(mapping), mapping_size);
+        ::close(fd);
+        mapping = nullptr;
+        fd = -1;
+        return false;
+    }
+
+    if (looping && loop_period_ns <= 0) {
+        std::cerr << "Warning: Trace " << file_path << " spans no time and plays once" << std::endl;
+    }
+    restart();
+    loops_completed = 0;
+    samples_replayed = 0;
+    return true;
+}
+
+void TraceReplaySource::close() {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    if (mapping) {
+        munmap(const_cast<uint8_t*>(mapping), mapping_size);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    records = nullptr;
+    record_count = 0;
+    csv_begin = csv_cursor = csv_end = nullptr;
+}
+
+TraceReplaySource::Format TraceReplaySource::detectFormat() const {
+    if (mapping_size >= sizeof(TraceHeader) &&
+        std::memcmp(mapping, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0) {
+        return Format::BINARY;
+    }
+    return Format::CSV;
+}
+
+bool TraceReplaySource::prepareBinary() {
+    if (mapping_size < sizeof(TraceHeader)) {
+        std::cerr << "Error: Trace " << file_path << " is too small for a binary header" << std::endl;
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const TraceHeader*>(mapping);
+    if (std::memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        header->version != TRACE_VERSION) {
+        std::cerr << "Error: Trace " << file_path << " has an unsupported binary header" << std::endl;
+        return false;
+    }
+
+    size_t available = (mapping_size - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    record_count = std::min<size_t>(header->sample_count, available);
+    records = reinterpret_cast<const TraceRecord*>(mapping + sizeof(TraceHeader));
+
+    if (record_count == 0) {
+        std::cerr << "Error: Trace " << file_path << " contains no samples" << std::endl;
+        return false;
+    }
+
+    first_timestamp = records[0].timestamp_ns;
+    int64_t span = records[record_count - 1].timestamp_ns - first_timestamp;
+    int64_t period = record_count > 1 ? span / static_cast<int64_t>(record_count - 1) : 0;
+    loop_period_ns = span + period;
+    return true;
+}
+
+bool TraceReplaySource::prepareCsv() {
+    csv_begin = reinterpret_cast<const char*>(mapping);
+    csv_end = csv_begin + mapping_size;
+
+    // Count samples and find the first/last timestamps for loop bookkeeping
+    record_count = 0;
+    Sample sample;
+    Sample first{};
+    Sample last{};
+    for (const char* p = csv_begin; p < csv_end; p = nextLine(p, csv_end)) {
+        const char* cursor = p;
+        if (parseCsvLine(cursor, sample)) {
+            if (record_count == 0) first = sample;
+            last = sample;
+            record_count++;
+        }
+    }
+
+    if (record_count == 0) {
+        std::cerr << "Error: Trace " << file_path << " contains no parsable samples" << std::endl;
+        return false;
+    }
+
+    first_timestamp = first.timestamp_ns;
+    int64_t span = last.timestamp_ns - first.timestamp_ns;
+    int64_t period = record_count > 1 ? span / static_cast<int64_t>(record_count - 1) : 0;
+    loop_period_ns = span + period;
+    return true;
+}
+
+bool TraceReplaySource::parseCsvLine(const char*& cursor, Sample& sample) const {
+    const char* line_end = static_cast<const char*>(
+        std::memchr(cursor, '\n', static_cast<size_t>(csv_end - cursor)));
+    if (!line_end) line_end = csv_end;
+
+    const char* p = skipBlanks(cursor, line_end);
+    double time_s = 0.0;
+    auto time_result = std::from_chars(p, line_end, time_s);
+    bool ok = time_result.ec == std::errc();
+
+    if (ok) {
+        p = skipBlanks(time_result.ptr, line_end);
+        if (p < line_end && (*p == ',' || *p == ';')) ++p;
+        p = skipBlanks(p, line_end);
+
+        float value = 0.0f;
+        auto value_result = std::from_chars(p, line_end, value);
+        ok = value_result.ec == std::errc();
+        if (ok) {
+            sample.timestamp_ns = static_cast<int64_t>(std::llround(time_s * 1e9));
+            sample.value = value;
+        }
+    }
+
+    cursor = (line_end < csv_end) ? line_end + 1 : csv_end;
+    return ok; // Header and malformed lines are skipped by the caller
+}
+
+bool TraceReplaySource::readRaw(Sample& sample) {
+    if (format == Format::BINARY) {
+        if (binary_cursor >= record_count) {
+            return false;
+        }
+        const TraceRecord& record = records[binary_cursor++];
+        sample.timestamp_ns = record.timestamp_ns;
+        sample.value = record.value;
+        return true;
+    }
+
+    while (csv_cursor < csv_end) {
+        if (parseCsvLine(csv_cursor, sample)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TraceReplaySource::restart() {
+    binary_cursor = 0;
+    csv_cursor = csv_begin;
+}
+
+bool TraceReplaySource::next(Sample& sample) {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    if (!mapping) {
+        return false;
+    }
+
+    if (!readRaw(sample)) {
+        // A trace spanning no time (one sample, or all at one timestamp) would
+        // replay the same instant forever: it plays once even when looping
+        if (!looping || loop_period_ns <= 0) {
+            return false;
+        }
+        restart();
+        loop_offset_ns += loop_period_ns;
+        loops_completed++;
+        if (!readRaw(sample)) {
+            return false;
+        }
+    }
+
+    sample.timestamp_ns += loop_offset_ns;
+
+    if (!playback_anchored) {
+        playback_start = std::chrono::steady_clock::now();
+        anchor_timestamp = sample.timestamp_ns;
+        playback_anchored = true;
+    }
+
+    samples_replayed++;
+    return true;
+}
+
+void TraceReplaySource::rewind() {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    restart();
+    loop_offset_ns = 0;
+    loops_completed = 0;
+    samples_replayed = 0;
+    playback_anchored = false;
+}
+
+std::chrono::steady_clock::time_point TraceReplaySource::dueTime(const Sample& sample) const {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    if (rate_scale <= 0.0 || !playback_anchored) {
+        return std::chrono::steady_clock::now();
+    }
+
+    double elapsed_ns = static_cast<double>(sample.timestamp_ns - anchor_timestamp) / rate_scale;
+    return playback_start + std::chrono::nanoseconds(static_cast<int64_t>(elapsed_ns));
+}
+
+bool TraceReplaySource::setRateScale(double scale) {
+    if (scale < 0.0 || !std::isfinite(scale)) {
+        std::cerr << "Error: Replay rate scale must be >= 0 (0 = as fast as possible)" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    rate_scale = scale;
+    playback_anchored = false; // Re-anchor so the new rate applies from now on
+    return true;
+}
+
+double TraceReplaySource::getRateScale() const {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    return rate_scale;
+}
+
+bool TraceReplaySource::setLooping(bool enable) {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    if (enable && mapping && loop_period_ns <= 0) {
+        std::cerr << "Error: Trace " << file_path << " spans no time and cannot loop" << std::endl;
+        return false;
+    }
+    looping = enable;
+    return true;
+}
+
+bool TraceReplaySource::isLooping() const {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    return looping;
+}
+
+size_t TraceReplaySource::getSampleCount() const {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    return record_count;
+}
+
+size_t TraceReplaySource::getSamplesReplayed() const {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    return samples_replayed;
+}
+
+size_t TraceReplaySource::getLoopsCompleted() const {
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    return loops_completed;
+}
+
+bool TraceReplaySource::writeBinaryTrace(const std::string& path, const std::vector<Sample>& samples) {
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create trace " << path << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    TraceHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.sample_count = samples.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<TraceRecord> chunk;
+    chunk.reserve(4096);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        chunk.push_back({samples[i].timestamp_ns, samples[i].value, 0});
+        if (chunk.size() == chunk.capacity() || i + 1 == samples.size()) {
+            file.write(reinterpret_cast<const char*>(chunk.data()),
+                       static_cast<std::streamsize>(chunk.size() * sizeof(TraceRecord)));
+            chunk.clear();
+        }
+    }
+
+    return !file.fail();
+}
+
+std::string TraceReplaySource::formatToString(Format format) {
+    switch (format) {
+        case Format::AUTO: return "Auto";
+        case Format::BINARY: return "Binary";
+        case Format::CSV: return "CSV";
+        default: return "Unknown";
+    }
+}
@@ -2,14 +2,112 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
-#include <random>
+#include <functional>
+#include <cstring>
+
+/**
+ * @brief Process-wide idle-line timer
+ *
+ * When a stream pauses, every receiver on the line gets an idle deadline,
+ * and on a multidrop bus they all get the same one. Waking each RX thread
+ * to arm its own timed wait and then again when it expires costs two
+ * wakeups per receiver. Instead, this one thread sleeps until the earliest
+ * deadline and wakes only the RX threads that are due. Entries hold raw
+ * UART pointers: schedule() ignores a UART whose RX thread is stopping, and
+ * cancel() drops its entries. Firing happens under timer_mutex, so after
+ * cancel() returns no wakeup of that UART is in progress.
+ */
+class UART::IdleTimer {
+    struct Entry {
+        int64_t deadline_ns;
+        UART* uart;
+        bool operator>(const Entry& other) const { return deadline_ns > other.deadline_ns; }
+    };
+    
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    std::vector<Entry> heap;  // Min-heap on deadline
+    std::thread thread;
+    
+    IdleTimer() : thread(&IdleTimer::run, this) {}
+    
+    void run() {
+        std::unique_lock<std::mutex> lock(timer_mutex);
+        for (;;) {
+            if (heap.empty()) {
+                timer_cv.wait(lock);
+                continue;
+            }
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            int64_t deadline = heap.front().deadline_ns;
+            if (deadline > now) {
+                timer_cv.wait_until(lock, std::chrono::steady_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(deadline))));
+                continue;
+            }
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            UART& uart = *heap.back().uart;
+            heap.pop_back();
+            
+            // A deadline cancelled by new traffic, or replaced, wakes nobody
+            if (uart.rx_idle_deadline_ns.load() == deadline) {
+                std::lock_guard<std::mutex> wait_lock(uart.wait_mutex);
+                uart.rx_cv.notify_one();
+            }
+        }
+    }
+    
+public:
+    // Never destroyed: UARTs with static storage may be cleaned up after it
+    static IdleTimer& instance() {
+        static IdleTimer* timer = new IdleTimer();
+        return *timer;
+    }
+    
+    void schedule(UART* uart, int64_t deadline_ns) {
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            if (!uart->rx_running.load()) {
+                return;
+            }
+            earliest = heap.empty() || deadline_ns < heap.front().deadline_ns;
+            heap.push_back(Entry{deadline_ns, uart});
+            std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        }
+        if (earliest) {
+            timer_cv.notify_one();
+        }
+    }
+    
+    void cancel(UART* uart) {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        heap.erase(std::remove_if(heap.begin(), heap.end(), [uart](const Entry& entry) { return entry.uart == uart; }),
+                   heap.end());
+        std::make_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+};
 
 UART::UART(const std::string& name)
     : Peripheral(name),
+      rx_times_mask(0),
       tx_fifo_size(64),
       rx_fifo_size(64),
       tx_running(false),
       rx_running(false),
+      tx_idle(false),
+      tx_space_waiters(0),
+      line_timing(LineTiming::BAUD_RATE),
+      rx_wait_delimiter(-1),
+      rx_wait_bytes(0),
+      rx_line_ready(false),
+      rx_delivering(false),
+      rx_delivery_waiters(0),
+      rx_threshold(0),
+      rx_idle_timeout_ns(0),
+      rx_delimiter(-1),
+      rx_batch_ready(false),
       rts_state(false),
       cts_state(true), // Default CTS active
       tx_enabled(true),
@@ -18,7 +116,13 @@ UART::UART(const std::string& name)
       transmission_errors(0),
       reception_errors(0),
       dma_tx_active(false),
-      dma_rx_active(false) {
+      dma_rx_active(false),
+      dma_tx_buffer(nullptr),
+      dma_rx_buffer(nullptr),
+      dma_tx{},
+      dma_rx{},
+      rx_idle_deadline_ns(0),
+      rx_idle_late_ns(0) {
     
     // Default configuration
     config.baud_rate = BaudRate::BAUD_115200;
@@ -30,6 +134,7 @@ UART::UART(const std::string& name)
     config.tx_fifo_size = 64;
     config.rx_fifo_size = 64;
     config.enable_dma = false;
+    config.tx_error_interval = 0;
     
     // Initialize status
     status = {};
@@ -45,11 +150,15 @@ UART::~UART() {
 }
 
 bool UART::initialize() {
+    stopLineThreads();
     std::lock_guard<std::mutex> lock(uart_mutex);
     
-    // Clear FIFOs
-    while (!tx_fifo.empty()) tx_fifo.pop();
-    while (!rx_fifo.empty()) rx_fifo.pop();
+    // Allocate empty FIFOs
+    tx_fifo.reset(config.tx_fifo_size);
+    rx_fifo.reset(config.rx_fifo_size);
+    resizeRxTimes(config.rx_fifo_size);
+    tx_fifo_size = config.tx_fifo_size;
+    rx_fifo_size = config.rx_fifo_size;
     
     // Reset statistics
     bytes_transmitted = 0;
@@ -57,11 +166,7 @@ bool UART::initialize() {
     transmission_errors = 0;
     reception_errors = 0;
     
-    // Start threads
-    tx_running = true;
-    rx_running = true;
-    tx_thread = std::thread(&UART::transmissionLoop, this);
-    rx_thread = std::thread(&UART::receptionLoop, this);
+    startLineThreads();
     
     updateStatus();
     
@@ -77,25 +182,19 @@ bool UART::initialize() {
 }
 
 bool UART::cleanup() {
+    // Join outside uart_mutex: the line threads take it to report status and errors
+    stopLineThreads();
+    abortDMA(true, true);
     std::lock_guard<std::mutex> lock(uart_mutex);
     
-    // Stop threads
-    tx_running = false;
-    rx_running = false;
-    tx_cv.notify_all();
-    rx_cv.notify_all();
-    
-    if (tx_thread.joinable()) tx_thread.join();
-    if (rx_thread.joinable()) rx_thread.join();
-    
     // Clear callbacks
-    data_received_callback = nullptr;
+    std::atomic_store(&rx_delivery, std::shared_ptr<const DataSpanCallback>());
     error_callback = nullptr;
     status_change_callback = nullptr;
     
     // Clear FIFOs
-    while (!tx_fifo.empty()) tx_fifo.pop();
-    while (!rx_fifo.empty()) rx_fifo.pop();
+    tx_fifo.clear();
+    rx_fifo.clear();
     
     writeToDeviceFile(formatDeviceData());
     
@@ -124,21 +223,39 @@ std::string UART::getStatus() const {
 }
 
 bool UART::configure(const UARTConfig& new_config) {
-    std::lock_guard<std::mutex> lock(uart_mutex);
-    if (!initialized) {
-        std::cerr << "Error: UART not initialized" << std::endl;
+    if (new_config.tx_fifo_size < 1 || new_config.tx_fifo_size > MAX_FIFO_SIZE ||
+        new_config.rx_fifo_size < 1 || new_config.rx_fifo_size > MAX_FIFO_SIZE) {
+        std::cerr << "Error: UART FIFO sizes must be between 1-" << MAX_FIFO_SIZE << " bytes" << std::endl;
         return false;
     }
     
-    config = new_config;
+    bool resize;
+    {
+        std::lock_guard<std::mutex> lock(uart_mutex);
+        if (!initialized) {
+            std::cerr << "Error: UART not initialized" << std::endl;
+            return false;
+        }
+        resize = (new_config.tx_fifo_size != config.tx_fifo_size ||
+                  new_config.rx_fifo_size != config.rx_fifo_size);
+        config = new_config;
+    }
     
-    // Resize FIFOs if needed
-    if (tx_fifo.size() > config.tx_fifo_size) {
-        while (tx_fifo.size() > config.tx_fifo_size) {
-            tx_fifo.pop();
+    // The rings are reallocated with both line threads parked; the newest bytes are kept
+    if (resize) {
+        stopLineThreads();
+        {
+            std::lock_guard<std::mutex> lock(uart_mutex);
+            tx_fifo.resize(config.tx_fifo_size);
+            resizeRxTimes(config.rx_fifo_size);
+            rx_fifo.resize(config.rx_fifo_size);
+            tx_fifo_size = config.tx_fifo_size;
+            rx_fifo_size = config.rx_fifo_size;
         }
+        startLineThreads();
     }
     
+    std::lock_guard<std::mutex> lock(uart_mutex);
     updateStatus();
     writeToDeviceFile(formatDeviceData());
     
@@ -146,164 +263,1003 @@ bool UART::configure(const UARTConfig& new_config) {
     return true;
 }
 
-bool UART::transmit(uint8_t byte) {
-    std::lock_guard<std::mutex> lock(uart_mutex);
-    if (!initialized || !tx_enabled.load()) {
-        return false;
+size_t UART::write(Span<const uint8_t> data, std::chrono::milliseconds timeout) {
+    if (!tx_running.load() || !tx_enabled.load()) {
+        return 0;
     }
     
-    if (tx_fifo.size() >= config.tx_fifo_size) {
-        // FIFO full
-        status.tx_full = true;
-        return false;
+    size_t queued = tx_fifo.push(data.data(), data.size());
+    if (queued > 0) {
+        wakeTransmitter();
+    }
+    if (queued == data.size() || timeout <= std::chrono::milliseconds(0)) {
+        return queued;
     }
     
-    tx_fifo.push(byte);
-    status.tx_empty = false;
-    status.tx_full = (tx_fifo.size() >= config.tx_fifo_size);
-    
-    // Notify transmission thread
-    tx_cv.notify_one();
-    
-    return true;
-}
-
-bool UART::transmit(const std::vector<uint8_t>& data) {
-    bool success = true;
-    for (uint8_t byte : data) {
-        if (!transmit(byte)) {
-            success = false;
+    // Backpressure: sleep until the TX thread frees space, then top up
+    auto deadline = std::chrono::steady_clock::now() + std::min(timeout, std::chrono::milliseconds(std::chrono::hours(24 * 365)));
+    auto space_or_stop = [this] {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return !tx_running.load() || !tx_fifo.full();
+    };
+    std::unique_lock<std::mutex> lock(wait_mutex);
+    tx_space_waiters.fetch_add(1);
+    while (queued < data.size()) {
+        bool ready = true;
+        if (timeout == WAIT_FOREVER) {
+            tx_space_cv.wait(lock, space_or_stop);
+        } else {
+            ready = tx_space_cv.wait_until(lock, deadline, space_or_stop);
+        }
+        if (!ready || !tx_running.load()) {
             break;
         }
+        size_t stored = tx_fifo.push(data.data() + queued, data.size() - queued);
+        queued += stored;
+        if (stored > 0) {
+            lock.unlock();
+            wakeTransmitter();
+            lock.lock();
+        }
     }
-    return success;
+    tx_space_waiters.fetch_sub(1);
+    return queued;
 }
 
-bool UART::transmit(const std::string& text) {
-    std::vector<uint8_t> data(text.begin(), text.end());
-    return transmit(data);
+size_t UART::write(std::string_view text, std::chrono::milliseconds timeout) {
+    return write(Span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()), timeout);
 }
 
-bool UART::receive(uint8_t& byte) {
-    std::lock_guard<std::mutex> lock(uart_mutex);
-    if (!initialized || rx_fifo.empty()) {
+bool UART::transmit(uint8_t byte) {
+    if (!tx_running.load() || !tx_enabled.load()) {
         return false;
     }
     
-    byte = rx_fifo.front();
-    rx_fifo.pop();
-    
-    status.rx_empty = rx_fifo.empty();
-    status.rx_full = false;
-    
-    bytes_received = bytes_received.load() + 1;
+    if (!tx_fifo.push(byte)) {
+        return false;  // FIFO full
+    }
+    wakeTransmitter();
     return true;
 }
 
+bool UART::transmit(const std::vector<uint8_t>& data) {
+    // Stores what fits; the rest is dropped as before
+    return write(Span<const uint8_t>(data.data(), data.size())) == data.size();
+}
+
+bool UART::transmit(const std::string& text) {
+    return write(std::string_view(text)) == text.size();
+}
+
+bool UART::receive(uint8_t& byte) {
+    return rx_running.load() && popReceived(&byte, 1, nullptr) == 1;
+}
+
 std::vector<uint8_t> UART::receive(size_t max_bytes) {
-    std::lock_guard<std::mutex> lock(uart_mutex);
     std::vector<uint8_t> data;
+    if (!rx_running.load()) {
+        return data;
+    }
     
-    size_t bytes_to_read = (max_bytes == 0) ? rx_fifo.size() : 
-                          std::min(max_bytes, rx_fifo.size());
+    size_t available = rx_fifo.size();
+    data.resize((max_bytes == 0) ? available : std::min(max_bytes, available));
+    data.resize(popReceived(data.data(), data.size(), nullptr));
+    return data;
+}
+
+size_t UART::read(Span<uint8_t> data, std::chrono::steady_clock::time_point* arrival_times) {
+    if (!rx_running.load()) {
+        return 0;
+    }
+    return popReceived(data.data(), data.size(), arrival_times);
+}
+
+std::string UART::receiveString(size_t max_chars) {
+    std::string text;
+    if (!rx_running.load()) {
+        return text;
+    }
     
-    data.reserve(bytes_to_read);
+    size_t available = rx_fifo.size();
+    text.resize((max_chars == 0) ? available : std::min(max_chars, available));
+    text.resize(popReceived(reinterpret_cast<uint8_t*>(&text[0]), text.size(), nullptr));
+    return text;
+}
+
+RingSpan<const uint8_t> UART::readUntil(uint8_t delimiter, size_t max_bytes, std::chrono::milliseconds timeout) {
+    if (!rx_running.load()) {
+        return RingSpan<const uint8_t>();
+    }
+    size_t limit = std::min(max_bytes == 0 ? rx_fifo.capacity() : max_bytes, rx_fifo.capacity());
+    auto deadline = std::chrono::steady_clock::now() + std::min(timeout, std::chrono::milliseconds(std::chrono::hours(24 * 365)));
+    size_t scanned = 0;   // Bytes already searched: each byte is scanned once
+    uint64_t scan_position = 0;   // FIFO read position the scanned bytes start at
+    bool waiting = false;
     
-    for (size_t i = 0; i < bytes_to_read; ++i) {
-        data.push_back(rx_fifo.front());
-        rx_fifo.pop();
-        bytes_received = bytes_received.load() + 1;
+    for (;;) {
+        RingSpan<const uint8_t> data = rx_fifo.readable();
+        size_t end = std::min(data.size(), limit);
+        if (rx_fifo.readablePosition() != scan_position) {
+            // Flushed meanwhile: the searched bytes are gone even if as many
+            // new ones have arrived since
+            scan_position = rx_fifo.readablePosition();
+            scanned = 0;
+        }
+        
+        // memchr over the new part of each segment
+        const void* found = nullptr;
+        size_t base = 0;
+        if (scanned < std::min(end, data.head.size())) {
+            found = std::memchr(data.head.data() + scanned, delimiter, std::min(end, data.head.size()) - scanned);
+        }
+        if (!found && end > data.head.size()) {
+            size_t from = std::max(scanned, data.head.size()) - data.head.size();
+            found = std::memchr(data.tail.data() + from, delimiter, end - data.head.size() - from);
+            base = data.head.size();
+        }
+        scanned = end;
+        
+        size_t length = 0;
+        if (found) {
+            const uint8_t* segment = base == 0 ? data.head.data() : data.tail.data();
+            length = base + static_cast<size_t>(static_cast<const uint8_t*>(found) - segment) + 1;
+        } else if (end == limit) {
+            length = limit;   // No delimiter within max_bytes
+        }
+        if (length > 0 || !rx_running.load() || std::chrono::steady_clock::now() >= deadline) {
+            if (waiting) {
+                rx_wait_delimiter.store(-1);
+            }
+            return data.first(length);
+        }
+        
+        // Publish what would complete the line, then rescan once before
+        // sleeping: pairs with the fence in signalLineReader
+        if (!waiting) {
+            rx_wait_bytes.store(limit);
+            rx_line_ready.store(false);
+            rx_wait_delimiter.store(delimiter);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            waiting = true;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        rx_line_cv.wait_until(lock, deadline, [this] { return !rx_running.load() || rx_line_ready.load(); });
+        rx_line_ready.store(false);
+    }
+}
+
+bool UART::consumeReceived(size_t count) {
+    // Releases bytes seen through the last readUntil()
+    if (!rx_fifo.consume(count)) {
+        return false;
+    }
+    bytes_received.fetch_add(count);
+    return true;
+}
+
+size_t UART::readLine(Span<uint8_t> line, std::chrono::milliseconds timeout, uint8_t delimiter) {
+    if (line.empty()) {
+        return 0;
+    }
+    RingSpan<const uint8_t> data = readUntil(delimiter, line.size(), timeout);
+    size_t length = 0;
+    data.forEachSegment([&](Span<const uint8_t> segment) {
+        std::memcpy(line.data() + length, segment.data(), segment.size());
+        length += segment.size();
+    });
+    if (length > 0 && !consumeReceived(length)) {
+        return 0;
+    }
+    return length;
+}
+
+size_t UART::popReceived(uint8_t* data, size_t count, std::chrono::steady_clock::time_point* arrival_times) {
+    if (!arrival_times) {
+        count = rx_fifo.pop(data, count);
+        bytes_received.fetch_add(count);
+        return count;
     }
     
-    status.rx_empty = rx_fifo.empty();
-    status.rx_full = false;
+    // Copy bytes and their times from one view, then release it; retry if a
+    // flush got there first (the copy may be stale)
+    for (;;) {
+        RingSpan<const uint8_t> view = rx_fifo.readable();
+        uint64_t position = rx_fifo.readablePosition();
+        size_t n = std::min(count, view.size());
+        if (n == 0) {
+            return 0;
+        }
+        size_t copied = 0;
+        view.first(n).forEachSegment([&](Span<const uint8_t> segment) {
+            std::memcpy(data + copied, segment.data(), segment.size());
+            copied += segment.size();
+        });
+        for (size_t i = 0; i < n; ++i) {
+            arrival_times[i] = rx_times[(position + i) & rx_times_mask];
+        }
+        if (rx_fifo.consume(n)) {
+            bytes_received.fetch_add(n);
+            return n;
+        }
+    }
+}
+
+void UART::resizeRxTimes(size_t capacity) {
+    // RX FIFO resizing keeps its newest bytes and renumbers them from 0: do the same to their times
+    capacity = std::min(capacity, SpscByteRing::MAX_CAPACITY);
+    RingSpan<const uint8_t> buffered = rx_fifo.readable();
+    uint64_t position = rx_fifo.readablePosition();
+    size_t count = buffered.size();
+    size_t kept = std::min(count, capacity);
+    size_t allocation = 1;
+    while (allocation < capacity) {
+        allocation <<= 1;
+    }
+    std::unique_ptr<std::chrono::steady_clock::time_point[]> times(new std::chrono::steady_clock::time_point[allocation]);
+    for (size_t i = 0; i < kept; ++i) {
+        times[i] = rx_times[(position + count - kept + i) & rx_times_mask];
+    }
+    rx_times = std::move(times);
+    rx_times_mask = allocation - 1;
+}
+
+void UART::startLineThreads() {
+    tx_running = true;
+    rx_running = true;
+    tx_thread = std::thread(&UART::transmissionLoop, this);
+    rx_thread = std::thread(&UART::receptionLoop, this);
+}
+
+void UART::stopLineThreads() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        tx_running = false;
+        rx_running = false;
+    }
+    tx_cv.notify_all();
+    tx_space_cv.notify_all();
+    rx_cv.notify_all();
+    rx_line_cv.notify_all();
+    IdleTimer::instance().cancel(this);
     
-    return data;
+    if (tx_thread.joinable()) tx_thread.join();
+    if (rx_thread.joinable()) rx_thread.join();
+}
+
+void UART::wakeTransmitter() {
+    // Pairs with the fence in transmissionLoop: either the TX thread sees the
+    // new bytes before sleeping or we see it idle and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tx_idle.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        tx_cv.notify_one();
+    }
+}
+
+void UART::wakeWriters() {
+    // Same pairing as wakeTransmitter, with the writers' space check
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tx_space_waiters.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        tx_space_cv.notify_all();
+    }
 }
 
 void UART::transmissionLoop() {
+    uint8_t burst[MAX_TX_BURST];
+    std::chrono::steady_clock::time_point burst_times[MAX_TX_BURST];
+    LineClock clock{0, 0, 1, 1};
+    bool line_idle = true;
+    bool pause_pending = false;  // Bytes went out since the far end was last told the stream paused
+    Mode paused_mode = Mode::RS232;
+    std::chrono::steady_clock::time_point last_stop;
+    uint64_t error_countdown = 0;  // Bytes until the next simulated error
+    bool batch_waited = false;     // Slept for the current batch: send whatever has accrued
+    
     while (tx_running.load()) {
-        std::unique_lock<std::mutex> lock(uart_mutex);
+        if ((tx_fifo.empty() && !dma_tx_active.load()) || !tx_enabled.load()) {
+            if (pause_pending) {
+                driveLineIdle(paused_mode, last_stop);
+                pause_pending = false;
+            }
+            
+            // Wait for data or stop signal
+            std::unique_lock<std::mutex> lock(wait_mutex);
+            tx_idle.store(true);
+            tx_cv.wait(lock, [this] {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return !tx_running.load() || ((!tx_fifo.empty() || dma_tx_active.load()) && tx_enabled.load());
+            });
+            tx_idle.store(false);
+            line_idle = true;
+            batch_waited = false;
+            continue;
+        }
         
-        // Wait for data or stop signal
-        tx_cv.wait(lock, [this] { return !tx_fifo.empty() || !tx_running.load(); });
+        UARTConfig line;
+        {
+            std::lock_guard<std::mutex> lock(uart_mutex);
+            line = config;
+        }
+        uint64_t half_bit_rate = 2 * static_cast<uint64_t>(line.baud_rate);
+        uint32_t frame_half_bits = frameHalfBits(line);
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
         
-        if (!tx_running.load()) break;
+        // Restart the line clock after an idle period (the next start bit cannot
+        // begin before the previous stop bit ended) or when the frame format changes
+        if (line_idle || half_bit_rate != clock.half_bit_rate || frame_half_bits != clock.frame_half_bits) {
+            int64_t line_free = clock.timeAt(clock.position);
+            clock = LineClock{line_idle ? std::max(now, line_free) : line_free, 0, half_bit_rate, frame_half_bits};
+            line_idle = false;
+        }
         
-        if (!tx_fifo.empty() && tx_enabled.load()) {
-            uint8_t byte = tx_fifo.front();
-            tx_fifo.pop();
-            
-            // Simulate transmission time based on baud rate
-            lock.unlock();
-            
-            uint32_t bit_time_us = 1000000 / static_cast<uint32_t>(config.baud_rate);
-            uint32_t frame_bits = static_cast<uint32_t>(config.data_bits) + 1; // +1 for start bit
-            
-            if (config.parity != Parity::NONE) frame_bits++;
-            frame_bits += static_cast<uint32_t>(config.stop_bits);
+        // Credit: whole frames the line has had time for since the last burst
+        size_t wanted = MAX_TX_BURST;
+        if (line_timing.load() == LineTiming::BAUD_RATE) {
+            uint64_t accrued = clock.positionAt(now);
+            uint64_t frames = accrued > clock.position ? (accrued - clock.position) / frame_half_bits : 0;
             
-            std::this_thread::sleep_for(std::chrono::microseconds(bit_time_us * frame_bits));
-            
-            lock.lock();
-            
-            // Simulate potential transmission errors
-            static int error_counter = 0;
-            if (++error_counter % 10000 == 0) { // Very rare errors
-                transmission_errors = transmission_errors.load() + 1;
-                if (error_callback) {
-                    std::thread([this]() {
-                        error_callback("TRANSMISSION", "Simulated transmission error");
-                    }).detach();
+            // Sleep until a whole batch has accrued (everything pending, or
+            // MIN_WAKE_INTERVAL of line time) instead of waking per character.
+            // Stop times are retroactive, so the far end still sees each
+            // byte's own timing; it just learns of it up to one interval late.
+            uint64_t per_wake = std::chrono::duration_cast<std::chrono::nanoseconds>(MIN_WAKE_INTERVAL).count() *
+                                half_bit_rate / 1000000000 / frame_half_bits;
+            uint64_t batch = std::min<uint64_t>(std::max<uint64_t>(per_wake, 1), MAX_TX_BURST);
+            bool ready = frames >= batch || (frames > 0 && batch_waited);
+            if (!ready) {
+                size_t pending = tx_fifo.size();
+                if (dma_tx_active.load()) {
+                    std::lock_guard<std::mutex> lock(dma_mutex);
+                    pending += dma_tx_active.load() ? dma_tx.length - dma_tx.position : 0;
                 }
-            } else {
-                bytes_transmitted = bytes_transmitted.load() + 1;
-                
-                // Loopback mode
-                if (config.mode == Mode::LOOPBACK) {
-                    if (rx_fifo.size() < config.rx_fifo_size) {
-                        rx_fifo.push(byte);
-                        if (data_received_callback) {
-                            std::vector<uint8_t> data = {byte};
-                            std::thread([this, data]() {
-                                data_received_callback(data);
-                            }).detach();
-                        }
-                    }
+                batch = std::min<uint64_t>(batch, std::max<size_t>(pending, 1));
+                ready = frames >= batch;
+            }
+            if (!ready) {
+                int64_t batch_end = clock.timeAt(clock.position + batch * frame_half_bits);
+                std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(batch_end))));
+                batch_waited = true;
+                continue;
+            }
+            batch_waited = false;
+            wanted = static_cast<size_t>(std::min<uint64_t>(frames, MAX_TX_BURST));
+        }
+        
+        // The FIFO goes first; a TX DMA transfer feeds the line once it is empty
+        size_t count = tx_fifo.pop(burst, wanted);
+        if (count > 0) {
+            wakeWriters();
+        }
+        if (count < wanted && dma_tx_active.load()) {
+            count += pullTxDMA(burst + count, wanted - count);
+        }
+        if (count == 0) {
+            continue;  // Flushed or aborted meanwhile
+        }
+        if (count < wanted) {
+            line_idle = true;  // FIFO ran dry: the line idles until the next write
+        }
+        
+        // Each byte is stamped with the end of its stop bit
+        for (size_t i = 0; i < count; ++i) {
+            burst_times[i] = std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::nanoseconds(clock.timeAt(clock.position + (i + 1) * frame_half_bits))));
+        }
+        clock.position += count * frame_half_bits;
+        
+        // Simulated transmission errors (opt-in): every Nth byte is lost on the line
+        size_t delivered = count;
+        if (line.tx_error_interval > 0) {
+            delivered = 0;
+            size_t errors = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (error_countdown == 0 || error_countdown > line.tx_error_interval) {
+                    error_countdown = line.tx_error_interval;
                 }
+                if (--error_countdown == 0) {
+                    ++errors;
+                    continue;
+                }
+                burst_times[delivered] = burst_times[i];
+                burst[delivered++] = burst[i];
             }
-            
-            updateStatus();
+            if (errors > 0) {
+                transmission_errors.fetch_add(errors);
+                triggerErrorCallback("TRANSMISSION", "Simulated transmission error (" + std::to_string(errors) +
+                                                     (errors == 1 ? " byte lost)" : " bytes lost)"));
+            }
+        }
+        bytes_transmitted.fetch_add(delivered);
+        
+        if (delivered == 0) {
+            continue;
+        }
+        
+        // The far end sees the line idle only once the stream pauses: bursts are
+        // stamped retroactively, so gaps between wakeups are not idle time. The
+        // pause is dated by the last stop bit, or wall time when unthrottled.
+        if (!pause_pending && (line.mode == Mode::RS485_HALF_DUPLEX || line.mode == Mode::RS485_FULL_DUPLEX)) {
+            simulateRS485Direction(true);
+        }
+        driveLine(line.mode, Span<const uint8_t>(burst, delivered), burst_times);
+        last_stop = std::min(burst_times[delivered - 1], std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(now))));
+        paused_mode = line.mode;
+        pause_pending = !line_idle;
+        if (line_idle) {
+            driveLineIdle(line.mode, last_stop);
+        }
+    }
+}
+
+void UART::driveLine(Mode mode, Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times) {
+    if (mode == Mode::LOOPBACK) {
+        receiveFromLine(data, stop_times);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(line_mutex);
+    if (line_sink.receive) {
+        line_sink.receive(data, stop_times);
+    }
+}
+
+void UART::driveLineIdle(Mode mode, std::chrono::steady_clock::time_point last_stop) {
+    if (mode == Mode::LOOPBACK) {
+        lineIdle(last_stop);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(line_mutex);
+        if (line_sink.idle) {
+            line_sink.idle(last_stop);
         }
     }
+    if (mode == Mode::RS485_HALF_DUPLEX || mode == Mode::RS485_FULL_DUPLEX) {
+        simulateRS485Direction(false);
+    }
+}
+
+void UART::simulateRS485Direction(bool transmit) {
+    // RTS drives the transceiver's driver-enable (DE) pin: raised for the
+    // first frame of a transmission, dropped once the stream pauses
+    rts_state = transmit;
 }
 
 void UART::receptionLoop() {
-    // Simulate incoming data for demo purposes
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1000, 5000); // Random intervals
-    
+    // RX dispatcher: delivers batches when the producer signals a threshold or
+    // delimiter, and handles the idle-line event (IDLE_LINE, idle flush) for
+    // the deadline posted when the stream pauses. The shared IdleTimer wakes it
+    // at that deadline; once awake for other reasons it waits for it itself.
     while (rx_running.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(dis(gen)));
-        
+        int64_t deadline;
+        bool timed_out = false;
+        {
+            std::unique_lock<std::mutex> lock(wait_mutex);
+            deadline = rx_idle_deadline_ns.load();
+            auto woken = [this, deadline] {
+                return !rx_running.load() || rx_batch_ready.load() || rx_idle_deadline_ns.load() != deadline ||
+                       rx_idle_late_ns.load() != 0;
+            };
+            if (deadline == 0) {
+                rx_cv.wait(lock, woken);
+            } else {
+                timed_out = !rx_cv.wait_until(lock, std::chrono::steady_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(deadline))), woken);
+            }
+        }
         if (!rx_running.load()) break;
         
-        // Simulate occasional incoming data (optional for demo)
-        if (config.mode != Mode::LOOPBACK) {
-            std::lock_guard<std::mutex> lock(uart_mutex);
+        // An idle period this thread woke too late for still ends the message
+        // received before it, whatever arrived since
+        int64_t late = rx_idle_late_ns.exchange(0);
+        if (late != 0) {
+            dispatchReceived(true, late);
+        }
+        if (rx_batch_ready.exchange(false)) {
+            dispatchReceived(false);
+        }
+        if (late == 0 && (!timed_out || !rx_idle_deadline_ns.compare_exchange_strong(deadline, 0))) {
+            continue;
+        }
+        
+        // Line idle: flush partial messages, then report to RX DMA
+        if (late == 0) {
+            dispatchReceived(true, deadline);
+        }
+        if (!dma_rx_active.load()) {
+            continue;
+        }
+        DMACallback callback;
+        size_t position = 0;
+        {
+            std::lock_guard<std::mutex> dma_lock(dma_mutex);
+            if (!dma_rx_active.load()) {
+                continue;
+            }
+            callback = dma_rx.callback;
+            position = dma_rx.position;
+        }
+        if (callback) {
+            callback(DMAEvent::IDLE_LINE, position);
+        }
+    }
+}
+
+void UART::signalRxBatch(const uint8_t* data, size_t count) {
+    // Producer side: wake the dispatcher once a batch is due (at most once per batch)
+    size_t threshold = rx_threshold.load();
+    int delimiter = rx_delimiter.load();
+    bool due = rx_fifo.size() >= threshold ||
+               (delimiter >= 0 && std::memchr(data, delimiter, count) != nullptr);
+    if (due && !rx_batch_ready.exchange(true)) {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        rx_cv.notify_one();
+    }
+}
+
+void UART::signalLineReader(const uint8_t* data, size_t count) {
+    // Pairs with the fence in readUntil: either the reader's rescan sees these
+    // bytes or this sees the reader; it is woken only once its line is complete
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int delimiter = rx_wait_delimiter.load(std::memory_order_relaxed);
+    if (delimiter < 0) {
+        return;
+    }
+    bool due = std::memchr(data, delimiter, count) != nullptr || rx_fifo.size() >= rx_wait_bytes.load();
+    if (due && !rx_line_ready.exchange(true)) {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        rx_line_cv.notify_one();
+    }
+}
+
+void UART::dispatchReceived(bool flush, int64_t idle_at_ns) {
+    // Marked before the callback is loaded: a clear that stores after this
+    // load sees the mark and waits (pairs with waitForDelivery)
+    rx_delivering.store(true);
+    std::shared_ptr<const DataSpanCallback> callback = std::atomic_load(&rx_delivery);
+    if (!callback) {
+        finishDispatch();
+        return;  // Bytes stay in the FIFO for receive()
+    }
+    
+    int delimiter = rx_delimiter.load();
+    size_t threshold = rx_threshold.load();
+    RingSpan<const uint8_t> data = rx_fifo.readable();
+    
+    // One call per complete message
+    while (delimiter >= 0 && !data.empty()) {
+        size_t length = 0;
+        const void* end = std::memchr(data.head.data(), delimiter, data.head.size());
+        if (end) {
+            length = static_cast<size_t>(static_cast<const uint8_t*>(end) - data.head.data()) + 1;
+        } else if ((end = std::memchr(data.tail.data(), delimiter, data.tail.size())) != nullptr) {
+            length = data.head.size() + static_cast<size_t>(static_cast<const uint8_t*>(end) - data.tail.data()) + 1;
+        } else {
+            break;
+        }
+        (*callback)(data.first(length));
+        if (!rx_fifo.consume(length)) {
+            finishDispatch();
+            return;  // Flushed during the callback
+        }
+        bytes_received.fetch_add(length);
+        data = rx_fifo.readable();
+    }
+    
+    // An idle flush ends at the idle point: bytes stamped after it belong to
+    // the next message
+    if (flush && idle_at_ns != 0) {
+        uint64_t position = rx_fifo.readablePosition();
+        std::chrono::steady_clock::time_point idle_at(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(idle_at_ns)));
+        size_t length = data.size();
+        while (length > 0 && rx_times[(position + length - 1) & rx_times_mask] >= idle_at) {
+            --length;
+        }
+        data = data.first(length);
+    }
+    
+    // The rest once enough has piled up or the line went idle
+    if (!data.empty() && (flush || data.size() >= threshold)) {
+        (*callback)(data);
+        if (rx_fifo.consume(data.size())) {
+            bytes_received.fetch_add(data.size());
+        }
+    }
+    finishDispatch();
+}
+
+void UART::finishDispatch() {
+    // Same pairing as wakeWriters, with the waiters' delivery check
+    rx_delivering.store(false);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (rx_delivery_waiters.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        rx_delivery_cv.notify_all();
+    }
+}
+
+void UART::waitForDelivery() {
+    // The RX thread cannot wait for its own delivery: a callback may clear itself
+    if (std::this_thread::get_id() == rx_thread.get_id()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(wait_mutex);
+    rx_delivery_waiters.fetch_add(1);
+    rx_delivery_cv.wait(lock, [this] {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return !rx_delivering.load();
+    });
+    rx_delivery_waiters.fetch_sub(1);
+}
+
+UART::RxDeliveryConfig UART::defaultRxDelivery() {
+    RxDeliveryConfig delivery;
+    delivery.threshold = 0;
+    delivery.idle_timeout = std::chrono::microseconds(0);
+    delivery.delimiter = -1;
+    return delivery;
+}
+
+bool UART::setRxDelivery(DataSpanCallback callback, const RxDeliveryConfig& delivery) {
+    if (!callback) {
+        std::cerr << "Error: Invalid RX delivery callback" << std::endl;
+        return false;
+    }
+    if (delivery.delimiter < -1 || delivery.delimiter > 255) {
+        std::cerr << "Error: RX delimiter must be a byte value or -1" << std::endl;
+        return false;
+    }
+    
+    size_t capacity = rx_fifo_size.load();
+    rx_threshold = std::clamp<size_t>(delivery.threshold == 0 ? capacity / 2 : delivery.threshold, 1, capacity);
+    rx_idle_timeout_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delivery.idle_timeout).count();
+    rx_delimiter = delivery.delimiter;
+    std::atomic_store(&rx_delivery, std::make_shared<const DataSpanCallback>(std::move(callback)));
+    waitForDelivery();
+    return true;
+}
+
+bool UART::clearRxDelivery() {
+    std::atomic_store(&rx_delivery, std::shared_ptr<const DataSpanCallback>());
+    waitForDelivery();
+    return true;
+}
+
+bool UART::setDataReceivedCallback(DataReceivedCallback callback) {
+    if (!callback) {
+        return clearRxDelivery();
+    }
+    return setRxDelivery([callback](const RingSpan<const uint8_t>& data) {
+        std::vector<uint8_t> bytes;
+        bytes.reserve(data.size());
+        data.forEachSegment([&bytes](Span<const uint8_t> segment) {
+            bytes.insert(bytes.end(), segment.begin(), segment.end());
+        });
+        callback(bytes);
+    });
+}
+
+bool UART::setErrorCallback(ErrorCallback callback) {
+    std::lock_guard<std::mutex> lock(uart_mutex);
+    error_callback = std::move(callback);
+    return true;
+}
+
+void UART::triggerErrorCallback(const std::string& error_type, const std::string& description) {
+    // Called inline on the reporting thread, outside uart_mutex
+    ErrorCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(uart_mutex);
+        callback = error_callback;
+    }
+    if (callback) {
+        callback(error_type, description);
+    }
+}
+
+size_t UART::pullTxDMA(uint8_t* out, size_t count) {
+    DMACallback callback;
+    std::pair<DMAEvent, size_t> events[2];
+    size_t event_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(dma_mutex);
+        if (!dma_tx_active.load()) {
+            return 0;
+        }
+        count = std::min(count, dma_tx.length - dma_tx.position);
+        std::memcpy(out, dma_tx_buffer + dma_tx.position, count);
+        dma_tx.position += count;
+        
+        if (!dma_tx.half_reported && dma_tx.position >= dma_tx.length / 2) {
+            dma_tx.half_reported = true;
+            events[event_count++] = {DMAEvent::HALF_TRANSFER, dma_tx.position};
+        }
+        if (dma_tx.position == dma_tx.length) {
+            dma_tx_active = false;
+            dma_tx_buffer = nullptr;
+            events[event_count++] = {DMAEvent::TRANSFER_COMPLETE, dma_tx.position};
+        }
+        if (event_count > 0) {
+            callback = dma_tx.callback;
+        }
+    }
+    
+    // Outside the lock: the callback may queue the next buffer
+    for (size_t i = 0; i < event_count && callback; ++i) {
+        callback(events[i].first, events[i].second);
+    }
+    return count;
+}
+
+bool UART::attachLine(LineSink sink) {
+    if (!sink.receive) {
+        std::cerr << "Error: Line sink needs a receive function" << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(line_mutex);
+    line_sink = std::move(sink);
+    return true;
+}
+
+bool UART::detachLine() {
+    std::lock_guard<std::mutex> lock(line_mutex);
+    line_sink = LineSink{};
+    return true;
+}
+
+bool UART::isLineAttached() const {
+    std::lock_guard<std::mutex> lock(line_mutex);
+    return static_cast<bool>(line_sink.receive);
+}
+
+size_t UART::receiveFromLine(Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times) {
+    if (data.empty() || !rx_running.load()) {
+        return 0;
+    }
+    // Traffic cancels a pending idle-line event, unless the line had already
+    // been idle that long when this byte's start bit began and the RX thread
+    // is merely late: then the event still ends the bytes before it. An RX
+    // thread sleeping toward a cancelled deadline finds it gone when it wakes.
+    int64_t deadline = rx_idle_deadline_ns.load();
+    if (deadline != 0) {
+        int64_t first_start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (stop_times[0] - getFrameTime()).time_since_epoch()).count();
+        if (rx_idle_deadline_ns.compare_exchange_strong(deadline, 0) && deadline <= first_start) {
+            std::lock_guard<std::mutex> lock(wait_mutex);
+            rx_idle_late_ns = deadline;
+            rx_cv.notify_one();
+        }
+    }
+    return deliverReceived(data.data(), stop_times, data.size());
+}
+
+void UART::lineIdle(std::chrono::steady_clock::time_point last_stop) {
+    int64_t idle_after = std::max<int64_t>(getFrameTime().count(), rx_idle_timeout_ns.load());
+    int64_t deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(last_stop.time_since_epoch()).count() + idle_after;
+    rx_idle_deadline_ns = deadline;
+    
+    // Already expired (the sender ran late): wake the RX thread now
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (deadline <= now) {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        rx_cv.notify_one();
+        return;
+    }
+    IdleTimer::instance().schedule(this, deadline);
+}
+
+std::chrono::nanoseconds UART::getFrameTime() const {
+    std::lock_guard<std::mutex> lock(uart_mutex);
+    return std::chrono::nanoseconds(static_cast<uint64_t>(frameHalfBits(config)) * 500000000 /
+                                    static_cast<uint64_t>(config.baud_rate));
+}
+
+size_t UART::deliverReceived(const uint8_t* data, const std::chrono::steady_clock::time_point* times, size_t count) {
+    size_t offset = 0;
+    DMACallback callback;
+    dma_rx_events.clear();
+    
+    // RX DMA takes the bytes first
+    if (dma_rx_active.load()) {
+        std::lock_guard<std::mutex> lock(dma_mutex);
+        while (offset < count && dma_rx_active.load()) {
+            size_t n = std::min(count - offset, dma_rx.length - dma_rx.position);
+            std::memcpy(dma_rx_buffer + dma_rx.position, data + offset, n);
+            dma_rx.position += n;
+            offset += n;
             
-            // Only in specific demo scenarios
-            // This would normally be driven by external hardware
+            if (!dma_rx.half_reported && dma_rx.position >= dma_rx.length / 2) {
+                dma_rx.half_reported = true;
+                dma_rx_events.emplace_back(DMAEvent::HALF_TRANSFER, dma_rx.position);
+            }
+            if (dma_rx.position == dma_rx.length) {
+                dma_rx_events.emplace_back(DMAEvent::TRANSFER_COMPLETE, dma_rx.position);
+                if (dma_rx.circular) {
+                    dma_rx.position = 0;
+                    dma_rx.half_reported = false;
+                } else {
+                    dma_rx_active = false;
+                    dma_rx_buffer = nullptr;
+                }
+            }
+        }
+        if (!dma_rx_events.empty()) {
+            callback = dma_rx.callback;
+        }
+    }
+    
+    // The rest goes to the FIFO
+    size_t stored = 0;
+    if (offset < count) {
+        // Times first, at the bytes' positions: a published byte has its time
+        RingSpan<uint8_t> room = rx_fifo.writable();
+        uint64_t position = rx_fifo.writablePosition();
+        stored = std::min(room.size(), count - offset);
+        size_t copied = 0;
+        room.first(stored).forEachSegment([&](Span<uint8_t> segment) {
+            std::memcpy(segment.data(), data + offset + copied, segment.size());
+            copied += segment.size();
+        });
+        for (size_t i = 0; i < stored; ++i) {
+            rx_times[(position + i) & rx_times_mask] = times[offset + i];
+        }
+        rx_fifo.commit(stored);
+        if (stored > 0) {
+            if (std::atomic_load(&rx_delivery)) {
+                signalRxBatch(data + offset, stored);
+            } else {
+                signalLineReader(data + offset, stored);
+            }
+        }
+        if (offset + stored < count) {
+            std::lock_guard<std::mutex> lock(uart_mutex);
+            status.overrun_error = true;
+            reception_errors.fetch_add(count - offset - stored);
+        }
+    }
+    
+    for (const auto& event : dma_rx_events) {
+        if (callback) {
+            callback(event.first, event.second);
+        }
+    }
+    return offset + stored;
+}
+
+bool UART::enableDMA(bool enable) {
+    {
+        std::lock_guard<std::mutex> lock(uart_mutex);
+        config.enable_dma = enable;
+    }
+    if (!enable) {
+        abortDMA(true, true);
+    }
+    return true;
+}
+
+bool UART::startTxDMA(Span<const uint8_t> buffer, DMACallback callback) {
+    {
+        std::lock_guard<std::mutex> lock(uart_mutex);
+        if (!initialized || !config.enable_dma) {
+            std::cerr << "Error: UART DMA not enabled" << std::endl;
+            return false;
+        }
+    }
+    if (buffer.empty()) {
+        std::cerr << "Error: Empty DMA buffer" << std::endl;
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(dma_mutex);
+        if (dma_tx_active.load()) {
+            std::cerr << "Error: TX DMA transfer already active" << std::endl;
+            return false;
+        }
+        dma_tx_buffer = buffer.data();
+        dma_tx = DMATransfer{buffer.size(), 0, false, false, std::move(callback)};
+        dma_tx_active = true;
+    }
+    wakeTransmitter();
+    return true;
+}
+
+bool UART::startRxDMA(Span<uint8_t> buffer, bool circular, DMACallback callback) {
+    {
+        std::lock_guard<std::mutex> lock(uart_mutex);
+        if (!initialized || !config.enable_dma) {
+            std::cerr << "Error: UART DMA not enabled" << std::endl;
+            return false;
+        }
+    }
+    if (buffer.empty()) {
+        std::cerr << "Error: Empty DMA buffer" << std::endl;
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(dma_mutex);
+    if (dma_rx_active.load()) {
+        std::cerr << "Error: RX DMA transfer already active" << std::endl;
+        return false;
+    }
+    dma_rx_buffer = buffer.data();
+    dma_rx = DMATransfer{buffer.size(), 0, circular, false, std::move(callback)};
+    dma_rx_active = true;
+    return true;
+}
+
+bool UART::stopTxDMA() {
+    abortDMA(true, false);
+    return true;
+}
+
+bool UART::stopRxDMA() {
+    abortDMA(false, true);
+    return true;
+}
+
+void UART::abortDMA(bool tx, bool rx) {
+    DMACallback tx_callback, rx_callback;
+    size_t tx_position = 0, rx_position = 0;
+    {
+        // Once this returns the line threads no longer touch the buffers
+        std::lock_guard<std::mutex> lock(dma_mutex);
+        if (tx && dma_tx_active.load()) {
+            dma_tx_active = false;
+            dma_tx_buffer = nullptr;
+            tx_callback = std::move(dma_tx.callback);
+            tx_position = dma_tx.position;
+        }
+        if (rx && dma_rx_active.load()) {
+            dma_rx_active = false;
+            dma_rx_buffer = nullptr;
+            rx_callback = std::move(dma_rx.callback);
+            rx_position = dma_rx.position;
         }
     }
+    if (tx_callback) tx_callback(DMAEvent::ABORTED, tx_position);
+    if (rx_callback) rx_callback(DMAEvent::ABORTED, rx_position);
+}
+
+uint32_t UART::frameHalfBits(const UARTConfig& line) {
+    uint32_t half_bits = 2 * (1 + static_cast<uint32_t>(line.data_bits)); // Start + data
+    if (line.parity != Parity::NONE) half_bits += 2;
+    switch (line.stop_bits) {
+        case StopBits::ONE: half_bits += 2; break;
+        case StopBits::ONE_HALF: half_bits += 3; break;
+        case StopBits::TWO: half_bits += 4; break;
+    }
+    return half_bits;
+}
+
+uint32_t UART::calculateTransmissionTime(size_t bytes) const {
+    uint64_t half_bits = static_cast<uint64_t>(frameHalfBits(config)) * bytes;
+    return static_cast<uint32_t>(half_bits * 500000 / static_cast<uint64_t>(config.baud_rate));
+}
+
+UART::UARTStatus UART::getUARTStatus() const {
+    std::lock_guard<std::mutex> lock(uart_mutex);
+    UARTStatus snapshot = status;
+    snapshot.tx_empty = tx_fifo.empty();
+    snapshot.tx_full = tx_fifo.full();
+    snapshot.rx_empty = rx_fifo.empty();
+    snapshot.rx_full = rx_fifo.full();
+    snapshot.cts_state = cts_state.load();
+    snapshot.rts_state = rts_state.load();
+    return snapshot;
 }
 
 void UART::updateStatus() {
     status.tx_empty = tx_fifo.empty();
-    status.tx_full = (tx_fifo.size() >= config.tx_fifo_size);
+    status.tx_full = tx_fifo.full();
     status.rx_empty = rx_fifo.empty();
-    status.rx_full = (rx_fifo.size() >= config.rx_fifo_size);
+    status.rx_full = rx_fifo.full();
     status.cts_state = cts_state.load();
     status.rts_state = rts_state.load();
 }
@@ -354,34 +1310,57 @@ std::string UART::modeToString(Mode mode) {
 
 // Simplified implementations for remaining methods
 bool UART::setBaudRate(BaudRate rate) {
+    std::lock_guard<std::mutex> lock(uart_mutex);
     config.baud_rate = rate;
     return true;
 }
 
-bool UART::clearTxFifo() {
+bool UART::setMode(Mode mode) {
     std::lock_guard<std::mutex> lock(uart_mutex);
-    while (!tx_fifo.empty()) tx_fifo.pop();
-    updateStatus();
+    config.mode = mode;
+    return true;
+}
+
+bool UART::setLineTiming(LineTiming timing) {
+    line_timing = timing;
+    return true;
+}
+
+bool UART::clearTxFifo() {
+    tx_fifo.clear();
+    wakeWriters();
     return true;
 }
 
 bool UART::clearRxFifo() {
-    std::lock_guard<std::mutex> lock(uart_mutex);
-    while (!rx_fifo.empty()) rx_fifo.pop();
-    updateStatus();
+    rx_fifo.clear();   // Arrival times follow the FIFO positions
     return true;
 }
 
 size_t UART::getTxFifoCount() const {
-    std::lock_guard<std::mutex> lock(uart_mutex);
     return tx_fifo.size();
 }
 
 size_t UART::getRxFifoCount() const {
-    std::lock_guard<std::mutex> lock(uart_mutex);
     return rx_fifo.size();
 }
 
+bool UART::isTxFifoFull() const {
+    return tx_fifo.full();
+}
+
+bool UART::isRxFifoFull() const {
+    return rx_fifo.full();
+}
+
+bool UART::isTxFifoEmpty() const {
+    return tx_fifo.empty();
+}
+
+bool UART::isRxFifoEmpty() const {
+    return rx_fifo.empty();
+}
+
 UART::Statistics UART::getStatistics() const {
     Statistics stats;
     stats.bytes_tx = bytes_transmitted.load();
@@ -0,0 +1,239 @@
+#include "sdk/uart_link.h"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+UARTLink::UARTLink(UART& a, UART& b)
+    : first(a),
+      second(b),
+      connected(false) {
+    connect();
+}
+
+UARTLink::~UARTLink() {
+    disconnect();
+}
+
+UART::LineSink UARTLink::sinkFor(UART& receiver) {
+    UART::LineSink sink;
+    sink.receive = [&receiver](Span<const uint8_t> data, const std::chrono::steady_clock::time_point* stop_times) {
+        receiver.receiveFromLine(data, stop_times);
+    };
+    sink.idle = [&receiver](std::chrono::steady_clock::time_point last_stop) {
+        receiver.lineIdle(last_stop);
+    };
+    return sink;
+}
+
+bool UARTLink::connect() {
+    if (connected) {
+        return true;
+    }
+    if (&first == &second) {
+        std::cerr << "Error: Cannot link a UART to itself (use LOOPBACK mode)" << std::endl;
+        return false;
+    }
+    if (first.isLineAttached() || second.isLineAttached()) {
+        std::cerr << "Error: UART line already attached to another link" << std::endl;
+        return false;
+    }
+
+    UART::UARTConfig a = first.getConfiguration();
+    UART::UARTConfig b = second.getConfiguration();
+    if (a.mode == UART::Mode::LOOPBACK || b.mode == UART::Mode::LOOPBACK) {
+        std::cerr << "Error: Linked UARTs must not be in LOOPBACK mode" << std::endl;
+        return false;
+    }
+    if (a.baud_rate != b.baud_rate || a.data_bits != b.data_bits ||
+        a.parity != b.parity || a.stop_bits != b.stop_bits) {
+        std::cerr << "Warning: Linking " << first.getName() << " and " << second.getName()
+                  << " with different line settings" << std::endl;
+    }
+
+    first.attachLine(sinkFor(second));
+    second.attachLine(sinkFor(first));
+    connected = true;
+    return true;
+}
+
+bool UARTLink::disconnect() {
+    if (!connected) {
+        return true;
+    }
+    // Returns once neither TX thread is inside the other UART
+    first.detachLine();
+    second.detachLine();
+    connected = false;
+    return true;
+}
+
+PtyBridge::PtyBridge(UART& target)
+    : uart(target),
+      master_fd(-1),
+      slave_fd(-1),
+      running(false),
+      bytes_to_pty(0),
+      bytes_from_pty(0),
+      bytes_dropped(0) {
+}
+
+PtyBridge::~PtyBridge() {
+    close();
+}
+
+bool PtyBridge::open() {
+    if (running.load()) {
+        return true;
+    }
+    if (uart.getConfiguration().mode == UART::Mode::LOOPBACK) {
+        std::cerr << "Error: Cannot bridge a UART in LOOPBACK mode" << std::endl;
+        return false;
+    }
+    if (uart.isLineAttached()) {
+        std::cerr << "Error: UART line already attached to another link" << std::endl;
+        return false;
+    }
+
+    master_fd = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0 || ::grantpt(master_fd) != 0 || ::unlockpt(master_fd) != 0) {
+        std::cerr << "Error: Failed to create pseudo-terminal: " << std::strerror(errno) << std::endl;
+        closeDescriptors();
+        return false;
+    }
+    const char* name = ::ptsname(master_fd);
+    if (name) {
+        slave_path = name;
+        slave_fd = ::open(name, O_RDWR | O_NOCTTY);
+    }
+    if (slave_fd < 0) {
+        std::cerr << "Error: Failed to open pseudo-terminal slave: " << std::strerror(errno) << std::endl;
+        closeDescriptors();
+        return false;
+    }
+
+    // Raw byte stream: no echo (it would loop TX back into RX), no line editing
+    struct termios tio;
+    if (::tcgetattr(slave_fd, &tio) == 0) {
+        ::cfmakeraw(&tio);
+        ::tcsetattr(slave_fd, TCSANOW, &tio);
+    }
+    // TX bursts must never block the UART's TX thread
+    ::fcntl(master_fd, F_SETFL, ::fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+
+    UART::LineSink sink;
+    sink.receive = [this](Span<const uint8_t> data, const std::chrono::steady_clock::time_point*) {
+        writeToPty(data);
+    };
+    uart.attachLine(std::move(sink));
+
+    running = true;
+    reader_thread = std::thread(&PtyBridge::readerLoop, this);
+    std::cout << "UART '" << uart.getName() << "' bridged to " << slave_path << std::endl;
+    return true;
+}
+
+bool PtyBridge::close() {
+    if (!running.load()) {
+        return true;
+    }
+    uart.detachLine();
+    running = false;
+    if (reader_thread.joinable()) {
+        reader_thread.join();
+    }
+    closeDescriptors();
+    return true;
+}
+
+void PtyBridge::closeDescriptors() {
+    if (slave_fd >= 0) {
+        ::close(slave_fd);
+        slave_fd = -1;
+    }
+    if (master_fd >= 0) {
+        ::close(master_fd);
+        master_fd = -1;
+    }
+}
+
+PtyBridge::Statistics PtyBridge::getStatistics() const {
+    Statistics stats;
+    stats.bytes_to_pty = bytes_to_pty.load();
+    stats.bytes_from_pty = bytes_from_pty.load();
+    stats.bytes_dropped = bytes_dropped.load();
+    return stats;
+}
+
+void PtyBridge::writeToPty(Span<const uint8_t> data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(master_fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;  // Client not reading (EAGAIN) or gone
+        }
+        written += static_cast<size_t>(n);
+    }
+    bytes_to_pty.fetch_add(written);
+    bytes_dropped.fetch_add(data.size() - written);
+}
+
+void PtyBridge::readerLoop() {
+    uint8_t chunk[READ_CHUNK];
+    std::chrono::steady_clock::time_point stop_times[READ_CHUNK];
+    std::chrono::steady_clock::time_point line_free;
+    bool pause_pending = false;  // Bytes delivered since the UART was last told the line idles
+
+    while (running.load()) {
+        // Once a burst has been replayed, an empty PTY means the client paused
+        struct pollfd pfd{master_fd, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, pause_pending ? 0 : static_cast<int>(POLL_INTERVAL.count()));
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "Error: Pseudo-terminal poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        if (ready <= 0 || !(pfd.revents & POLLIN)) {
+            if (pause_pending) {
+                uart.lineIdle(line_free);
+                pause_pending = false;
+            } else if (ready > 0) {
+                std::this_thread::sleep_for(POLL_INTERVAL);  // Hangup/error state: do not spin
+            }
+            continue;
+        }
+        ssize_t n = ::read(master_fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            continue;
+        }
+        size_t count = static_cast<size_t>(n);
+        bytes_from_pty.fetch_add(count);
+
+        // The client's bytes go out back to back, one frame each at the UART's
+        // settings; a continuing stream keeps its clock, a new one starts now
+        std::chrono::nanoseconds frame = uart.getFrameTime();
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point start = pause_pending ? line_free : std::max(now, line_free);
+        for (size_t i = 0; i < count; ++i) {
+            stop_times[i] = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(frame * (i + 1));
+        }
+        line_free = stop_times[count - 1];
+        pause_pending = true;
+
+        // Deliver slice by slice as the line time passes
+        size_t slice = static_cast<size_t>(std::max<int64_t>(1,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(DELIVERY_SLICE).count() / std::max<int64_t>(1, frame.count())));
+        for (size_t offset = 0; offset < count && running.load(); offset += slice) {
+            size_t length = std::min(slice, count - offset);
+            std::this_thread::sleep_until(stop_times[offset + length - 1]);
+            uart.receiveFromLine(Span<const uint8_t>(chunk + offset, length), stop_times + offset);
+        }
+    }
+}
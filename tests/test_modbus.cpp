@@ -0,0 +1,203 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <string>
+
+#include "sdk/uart.h"
+#include "sdk/uart_link.h"
+#include "sdk/rs485_bus.h"
+#include "protocol/modbus.h"
+#include "protocol/crc.h"
+
+/**
+ * @brief Modbus RTU behavior tests
+ *
+ * A master and three slaves share one RS-485 bus; a raw UART on a
+ * point-to-point link covers requests the master refuses to build.
+ * Exits non-zero if any check fails.
+ */
+
+namespace {
+
+using Table = ModbusRegisterMap::Table;
+using Status = ModbusMaster::Status;
+
+constexpr int SLAVE_COUNT = 3;
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        ++failures;
+    }
+}
+
+bool setupUART(UART& uart, UART::Mode mode) {
+    if (!uart.initialize()) {
+        return false;
+    }
+    UART::UARTConfig config = uart.getConfiguration();
+    config.baud_rate = UART::BaudRate::BAUD_115200;
+    config.mode = mode;
+    config.tx_fifo_size = 512;
+    config.rx_fifo_size = 512;
+    return uart.configure(config);
+}
+
+struct Outcome {
+    ModbusMaster::Result result;
+    std::vector<uint16_t> values;   // Result::values is only valid during the completion
+};
+
+Outcome call(ModbusMaster& master, ModbusMaster::LinkId link, ModbusMaster::Request request) {
+    std::promise<Outcome> promise;
+    std::future<Outcome> future = promise.get_future();
+    bool submitted = master.submit(link, request, [&promise](const ModbusMaster::Result& result) {
+        promise.set_value(Outcome{result, std::vector<uint16_t>(result.values.begin(), result.values.end())});
+    });
+    if (!submitted || future.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+        check(false, "request completes");
+        Outcome outcome{};
+        outcome.result.status = Status::CANCELLED;
+        return outcome;
+    }
+    return future.get();
+}
+
+void testBus() {
+    RS485Bus bus("bus");
+    UART master_uart("master");
+    std::vector<RS485Bus::NodeId> nodes;
+    check(setupUART(master_uart, UART::Mode::RS485_HALF_DUPLEX), "master configures");
+    nodes.push_back(bus.attach(master_uart));
+
+    std::vector<std::unique_ptr<UART>> uarts;
+    std::vector<std::unique_ptr<ModbusRegisterMap>> maps;
+    std::vector<std::unique_ptr<ModbusSlave>> slaves;
+    for (int s = 0; s < SLAVE_COUNT; ++s) {
+        uarts.emplace_back(new UART("slave" + std::to_string(s + 1)));
+        maps.emplace_back(new ModbusRegisterMap());
+        maps.back()->addRegisters(Table::HOLDING_REGISTERS, 0, 4);
+        maps.back()->addRegisters(Table::HOLDING_REGISTERS, 10, 4);   // Gap at 4-9
+        slaves.emplace_back(new ModbusSlave(*uarts.back(), static_cast<uint8_t>(s + 1), *maps.back()));
+        check(setupUART(*uarts.back(), UART::Mode::RS485_HALF_DUPLEX), "slave configures");
+        nodes.push_back(bus.attach(*uarts.back()));
+        check(slaves.back()->start(), "slave starts");
+    }
+    for (RS485Bus::NodeId node : nodes) {
+        check(node != RS485Bus::INVALID_NODE, "node attaches");
+    }
+
+    ModbusMaster::Config config = ModbusMaster::defaultConfig();
+    config.response_timeout = std::chrono::milliseconds(50);
+    config.retries = 1;
+    ModbusMaster master(config);
+    ModbusMaster::LinkId link = master.addLink(master_uart);
+    check(master.start(), "master starts");
+
+    // Round trip: write then read back
+    Outcome outcome = call(master, link, {2, modbus::FunctionCode::WRITE_MULTIPLE_REGISTERS, 0, 3, {11, 12, 13}});
+    check(outcome.result.status == Status::OK, "write multiple registers");
+    outcome = call(master, link, {2, modbus::FunctionCode::READ_HOLDING_REGISTERS, 0, 4, {}});
+    check(outcome.result.status == Status::OK && outcome.result.attempts == 1, "read holding registers");
+    check(outcome.values == std::vector<uint16_t>({11, 12, 13, 0}), "read returns the written values");
+    uint16_t value = 0;
+    check(maps[0]->getValue(Table::HOLDING_REGISTERS, 0, value) && value == 0, "other slaves untouched");
+
+    // Exception reply: the read spans the gap between the two blocks
+    outcome = call(master, link, {1, modbus::FunctionCode::READ_HOLDING_REGISTERS, 2, 10, {}});
+    check(outcome.result.status == Status::EXCEPTION &&
+          outcome.result.exception == modbus::ExceptionCode::ILLEGAL_DATA_ADDRESS,
+          "read across a gap is an illegal data address");
+
+    // Timeout: nobody answers address 9, the master retries once
+    outcome = call(master, link, {9, modbus::FunctionCode::READ_HOLDING_REGISTERS, 0, 1, {}});
+    check(outcome.result.status == Status::TIMEOUT && outcome.result.attempts == 2, "missing slave times out after a retry");
+    check(master.getSlaveStatistics(link, 9).timeouts == 2, "both attempts counted as timeouts");
+
+    // Broadcast: no reply, every slave applies the write
+    outcome = call(master, link, {0, modbus::FunctionCode::WRITE_SINGLE_REGISTER, 11, 1, {4242}});
+    check(outcome.result.status == Status::OK, "broadcast completes");
+    for (int s = 0; s < SLAVE_COUNT; ++s) {
+        value = 0;
+        check(maps[s]->getValue(Table::HOLDING_REGISTERS, 11, value) && value == 4242,
+              "broadcast reaches slave " + std::to_string(s + 1));
+        check(slaves[s]->getStatistics().exceptions == (s == 0 ? 1u : 0u), "slave exception count");
+    }
+
+    // The bus is usable again after the broadcast turnaround
+    outcome = call(master, link, {3, modbus::FunctionCode::READ_HOLDING_REGISTERS, 11, 1, {}});
+    check(outcome.result.status == Status::OK && outcome.values == std::vector<uint16_t>({4242}),
+          "read after broadcast");
+    check(master.getLinkStatistics(link).bad_frames == 0, "no bad frames on the bus");
+
+    master.stop();
+    for (auto& slave : slaves) {
+        slave->stop();
+    }
+    for (RS485Bus::NodeId node : nodes) {
+        bus.detach(node);
+    }
+    for (auto& uart : uarts) {
+        uart->cleanup();
+    }
+    master_uart.cleanup();
+}
+
+void testIllegalFunction() {
+    UART raw("raw");
+    UART slave_uart("slave");
+    check(setupUART(raw, UART::Mode::RS232) && setupUART(slave_uart, UART::Mode::RS232), "link UARTs configure");
+    UARTLink link(raw, slave_uart);
+
+    ModbusRegisterMap registers;
+    registers.addRegisters(Table::HOLDING_REGISTERS, 0, 4);
+    ModbusSlave slave(slave_uart, 5, registers);
+    check(slave.start(), "slave starts");
+
+    // Function 0x2B (encapsulated interface transport) is not implemented
+    std::vector<uint8_t> request = {5, 0x2B, 0x0E, 0x01, 0x00};
+    uint16_t crc = crc::crc16Modbus(Span<const uint8_t>(request.data(), request.size()));
+    request.push_back(static_cast<uint8_t>(crc));
+    request.push_back(static_cast<uint8_t>(crc >> 8));
+    check(raw.transmit(request), "raw request sent");
+
+    std::vector<uint8_t> reply;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (reply.size() < 5 && std::chrono::steady_clock::now() < deadline) {
+        std::vector<uint8_t> chunk = raw.receive();
+        reply.insert(reply.end(), chunk.begin(), chunk.end());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    check(reply.size() == 5, "exception reply received");
+    if (reply.size() == 5) {
+        check(reply[0] == 5 && reply[1] == (0x2B | 0x80) &&
+              reply[2] == static_cast<uint8_t>(modbus::ExceptionCode::ILLEGAL_FUNCTION),
+              "unknown function is an illegal function");
+        check(crc::crc16Modbus(Span<const uint8_t>(reply.data(), reply.size())) == 0, "exception reply CRC");
+    }
+    check(slave.getStatistics().exceptions == 1, "slave counts the exception");
+
+    slave.stop();
+    link.disconnect();
+    raw.cleanup();
+    slave_uart.cleanup();
+}
+
+} // namespace
+
+int main() {
+    testBus();
+    testIllegalFunction();
+
+    if (failures > 0) {
+        std::cerr << failures << " Modbus check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Modbus tests passed" << std::endl;
+    return 0;
+}